@@ -0,0 +1,21 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+#include "inter.h"
+
+// 目标代码生成，在optimize之后运行，把interCodeList翻译成汇编写到fp
+
+// x86-64，GNU as的AT&T语法。自带read/write的运行时，不依赖libc：
+//   as -o a.o a.s && ld -o a a.o
+void genX86(FILE* fp, pInterCodeList list);
+
+// MIPS32，SPIM的汇编格式，Chaitin-Briggs图着色分配$t0..$t9、$s0..$s7
+void genMips(FILE* fp, pInterCodeList list);
+// 生成MIPS代码后在自带的模拟器里执行，返回值同runInterCode
+int runMips(pInterCodeList list);
+
+// DEC出来的数组和结构体放在.bss里的数据栈上，这是它的字节数
+#define X86_DATA_STACK (64 << 20)
+// 机器栈也换成.bss里的一块，进入函数时检查，递归太深时报错而不是段错误
+#define X86_MACHINE_STACK (64 << 20)
+
+#endif
@@ -0,0 +1,312 @@
+#include "cfg.h"
+
+int nextFunction(pInterCodeList list, int i) {
+    for (i++; i < list->codeNum; i++)
+        if (list->codes[i].kind == IR_FUNCTION) break;
+    return i;
+}
+
+static boolean isJump(pInterCode code) {
+    return code->kind == IR_GOTO || code->kind == IR_IF_GOTO ||
+           code->kind == IR_RETURN;
+}
+
+// 划分基本块：函数入口、每个标签、跳转之后的指令各开一块
+static void splitBlocks(pCfg cfg) {
+    pInterCode codes = cfg->list->codes;
+    int num = 0;
+    for (int i = cfg->funcStart; i < cfg->funcEnd; i++)
+        if (i == cfg->funcStart || codes[i].kind == IR_LABEL ||
+            isJump(&codes[i - 1]))
+            num++;
+
+    cfg->blocks = (pBlock)malloc(sizeof(BasicBlock) * num);
+    assert(cfg->blocks != NULL);
+    cfg->blockNum = 0;
+    for (int i = cfg->funcStart; i < cfg->funcEnd; i++) {
+        if (i == cfg->funcStart || codes[i].kind == IR_LABEL ||
+            isJump(&codes[i - 1])) {
+            if (cfg->blockNum) cfg->blocks[cfg->blockNum - 1].last = i;
+            pBlock b = &cfg->blocks[cfg->blockNum];
+            b->id = cfg->blockNum++;
+            b->first = i;
+            b->succNum = 0;
+            b->predNum = 0;
+            b->rpo = b->idom = -1;
+            b->loop = -1;
+        }
+    }
+    cfg->blocks[cfg->blockNum - 1].last = cfg->funcEnd;
+}
+
+static void addSucc(pBlock b, int s) {
+    if (b->succNum == 1 && b->succ[0] == s) return;
+    b->succ[b->succNum++] = s;
+}
+
+static void linkBlocks(pCfg cfg) {
+    pInterCodeList list = cfg->list;
+    // 标签号 -> 块号。只写本函数的标签，也只读本函数的标签，所以不必清零
+    int* labelBlock = (int*)malloc(sizeof(int) * list->labelNum);
+    assert(labelBlock != NULL);
+    forEachBlock(cfg, id) {
+        pInterCode code = &list->codes[cfg->blocks[id].first];
+        if (code->kind == IR_LABEL)
+            labelBlock[getOperand(code->u.oneOp.op)->u.no] = id;
+    }
+
+    int edgeNum = 0;
+    forEachBlock(cfg, id) {
+        pBlock b = &cfg->blocks[id];
+        pInterCode last = &list->codes[b->last - 1];
+        if (last->kind == IR_GOTO)
+            addSucc(b, labelBlock[getOperand(last->u.oneOp.op)->u.no]);
+        else if (last->kind == IR_IF_GOTO)
+            addSucc(b, labelBlock[getOperand(last->u.ifGoto.z)->u.no]);
+        if (last->kind != IR_GOTO && last->kind != IR_RETURN &&
+            b->id + 1 < cfg->blockNum)
+            addSucc(b, b->id + 1);
+        for (int i = 0; i < b->succNum; i++) cfg->blocks[b->succ[i]].predNum++;
+        edgeNum += b->succNum;
+    }
+    free(labelBlock);
+
+    // 前驱按块连续存放在一个数组里
+    cfg->predEdges = (int*)malloc(sizeof(int) * (edgeNum + 1));
+    assert(cfg->predEdges != NULL);
+    int pos = 0;
+    forEachBlock(cfg, b) {
+        cfg->blocks[b].pred = cfg->predEdges + pos;
+        pos += cfg->blocks[b].predNum;
+        cfg->blocks[b].predNum = 0;
+    }
+    forEachBlock(cfg, b) {
+        forEachSucc(cfg, b, s) {
+            pBlock succ = &cfg->blocks[s];
+            succ->pred[succ->predNum++] = b;
+        }
+    }
+}
+
+// 从入口深度优先，按后序的逆序排出可达的块
+static void computeRpo(pCfg cfg) {
+    int n = cfg->blockNum;
+    int* stack = (int*)malloc(sizeof(int) * n);
+    int* next = (int*)calloc(n, sizeof(int));  // 下一个要看的后继
+    int* post = (int*)malloc(sizeof(int) * n);
+    assert(stack != NULL && next != NULL && post != NULL);
+    int top = 0, postNum = 0;
+    stack[top++] = 0;
+    cfg->blocks[0].rpo = 0;  // 先标记为已访问，编号最后再填
+    while (top) {
+        pBlock b = &cfg->blocks[stack[top - 1]];
+        if (next[b->id] < b->succNum) {
+            pBlock s = &cfg->blocks[b->succ[next[b->id]++]];
+            if (s->rpo < 0) {
+                s->rpo = 0;
+                stack[top++] = s->id;
+            }
+        } else {
+            post[postNum++] = b->id;
+            top--;
+        }
+    }
+    cfg->rpo = (int*)malloc(sizeof(int) * postNum);
+    assert(cfg->rpo != NULL);
+    cfg->rpoNum = postNum;
+    for (int i = 0; i < postNum; i++) {
+        cfg->rpo[i] = post[postNum - 1 - i];
+        cfg->blocks[cfg->rpo[i]].rpo = i;
+    }
+    free(stack);
+    free(next);
+    free(post);
+}
+
+static int intersect(pCfg cfg, int a, int b) {
+    while (a != b) {
+        while (cfg->blocks[a].rpo > cfg->blocks[b].rpo) a = cfg->blocks[a].idom;
+        while (cfg->blocks[b].rpo > cfg->blocks[a].rpo) b = cfg->blocks[b].idom;
+    }
+    return a;
+}
+
+// Cooper-Harvey-Kennedy迭代算法，结构化的程序两三轮就收敛
+static void computeDominators(pCfg cfg) {
+    cfg->blocks[0].idom = 0;
+    boolean changed = TRUE;
+    while (changed) {
+        changed = FALSE;
+        for (int i = 1; i < cfg->rpoNum; i++) {
+            pBlock b = &cfg->blocks[cfg->rpo[i]];
+            int idom = -1;
+            forEachPred(cfg, b->id, p) {
+                if (cfg->blocks[p].idom < 0) continue;  // 还没算到或不可达
+                idom = idom < 0 ? p : intersect(cfg, p, idom);
+            }
+            if (b->idom != idom) {
+                b->idom = idom;
+                changed = TRUE;
+            }
+        }
+    }
+
+    // 支配树的先序/后序编号：a支配b当且仅当b的区间落在a的区间里
+    int n = cfg->blockNum;
+    int* childStart = (int*)calloc(n + 1, sizeof(int));
+    int* children = (int*)malloc(sizeof(int) * n);
+    int* stack = (int*)malloc(sizeof(int) * n);
+    int* next = (int*)malloc(sizeof(int) * n);
+    assert(childStart && children && stack && next);
+    for (int i = 1; i < cfg->rpoNum; i++)
+        childStart[cfg->blocks[cfg->rpo[i]].idom + 1]++;
+    for (int i = 0; i < n; i++) childStart[i + 1] += childStart[i];
+    for (int i = 0; i < n; i++) next[i] = childStart[i];
+    for (int i = 1; i < cfg->rpoNum; i++) {
+        int b = cfg->rpo[i];
+        children[next[cfg->blocks[b].idom]++] = b;
+    }
+    for (int i = 0; i < n; i++) next[i] = childStart[i];
+
+    int top = 0, order = 0;
+    stack[top++] = 0;
+    cfg->blocks[0].domPre = order++;
+    while (top) {
+        int b = stack[top - 1];
+        if (next[b] < childStart[b + 1]) {
+            int c = children[next[b]++];
+            cfg->blocks[c].domPre = order++;
+            stack[top++] = c;
+        } else {
+            cfg->blocks[b].domPost = order++;
+            top--;
+        }
+    }
+    cfg->blocks[0].idom = -1;
+
+    free(childStart);
+    free(children);
+    free(stack);
+    free(next);
+}
+
+// 回边 b -> h（h支配b）确定以h为头的自然循环，循环体从回边尾沿前驱找回h。
+// 外层循环的头在逆后序里更靠前，按头的逆后序处理，内层的会覆盖块的loop
+static void findLoops(pCfg cfg) {
+    int n = cfg->blockNum;
+    int* headerLoop = (int*)malloc(sizeof(int) * n);
+    assert(headerLoop != NULL);
+    cfg->loopNum = 0;
+    forEachRpo(cfg, h) {
+        headerLoop[h] = -1;
+        forEachPred(cfg, h, p) {
+            if (dominates(cfg, h, p)) {
+                headerLoop[h] = cfg->loopNum++;
+                break;
+            }
+        }
+    }
+    cfg->loops = (pLoop)malloc(sizeof(Loop) * (cfg->loopNum + 1));
+    cfg->loopBlocks = NULL;
+    assert(cfg->loops != NULL);
+    if (cfg->loopNum == 0) {
+        free(headerLoop);
+        return;
+    }
+
+    // 循环体先收集进可增长的数组，全部收集完再把各循环的指针定下来
+    int cap = n, used = 0;
+    int* body = (int*)malloc(sizeof(int) * cap);
+    int* start = (int*)malloc(sizeof(int) * cfg->loopNum);
+    int* mark = (int*)malloc(sizeof(int) * n);
+    int* stack = (int*)malloc(sizeof(int) * n);
+    assert(body && start && mark && stack);
+    for (int i = 0; i < n; i++) mark[i] = -1;
+
+    forEachRpo(cfg, h) {
+        int l = headerLoop[h];
+        if (l < 0) continue;
+        pLoop loop = &cfg->loops[l];
+        loop->header = h;
+        loop->parent = cfg->blocks[h].loop;
+        loop->depth = loop->parent < 0 ? 1 : cfg->loops[loop->parent].depth + 1;
+        start[l] = used;
+
+        int top = 0;
+        mark[h] = l;
+        stack[top++] = h;
+        while (top) {
+            int b = stack[--top];
+            if (used == cap) {
+                cap *= 2;
+                body = (int*)realloc(body, sizeof(int) * cap);
+                assert(body != NULL);
+            }
+            body[used++] = b;
+            cfg->blocks[b].loop = l;
+            // 头只沿回边往回找，其余块沿所有可达的前驱
+            forEachPred(cfg, b, p) {
+                if (mark[p] == l || cfg->blocks[p].rpo < 0) continue;
+                if (b == h && !dominates(cfg, h, p)) continue;
+                mark[p] = l;
+                stack[top++] = p;
+            }
+        }
+        loop->blockNum = used - start[l];
+    }
+
+    cfg->loopBlocks = body;
+    for (int l = 0; l < cfg->loopNum; l++)
+        cfg->loops[l].blocks = body + start[l];
+
+    free(headerLoop);
+    free(start);
+    free(mark);
+    free(stack);
+}
+
+pCfg newCfg(pInterCodeList list, int funcStart) {
+    assert(list->codes[funcStart].kind == IR_FUNCTION);
+    pCfg cfg = (pCfg)malloc(sizeof(Cfg));
+    assert(cfg != NULL);
+    cfg->list = list;
+    cfg->funcStart = funcStart;
+    cfg->funcEnd = nextFunction(list, funcStart);
+    splitBlocks(cfg);
+    linkBlocks(cfg);
+    computeRpo(cfg);
+    computeDominators(cfg);
+    findLoops(cfg);
+    return cfg;
+}
+
+void deleteCfg(pCfg cfg) {
+    assert(cfg != NULL);
+    free(cfg->blocks);
+    free(cfg->predEdges);
+    free(cfg->rpo);
+    free(cfg->loops);
+    free(cfg->loopBlocks);
+    free(cfg);
+}
+
+void printCfg(FILE* fp, pCfg cfg) {
+    if (fp == NULL) fp = stdout;
+    forEachBlock(cfg, b) {
+        pBlock block = &cfg->blocks[b];
+        fprintf(fp, "B%d [%d, %d) idom=B%d loop=%d succ:", b, block->first,
+                block->last, block->idom, block->loop);
+        forEachSucc(cfg, b, s) fprintf(fp, " B%d", s);
+        fprintf(fp, " pred:");
+        forEachPred(cfg, b, p) fprintf(fp, " B%d", p);
+        fprintf(fp, "\n");
+    }
+    for (int l = 0; l < cfg->loopNum; l++) {
+        pLoop loop = &cfg->loops[l];
+        fprintf(fp, "loop%d header=B%d parent=%d depth=%d:", l, loop->header,
+                loop->parent, loop->depth);
+        for (int i = 0; i < loop->blockNum; i++)
+            fprintf(fp, " B%d", loop->blocks[i]);
+        fprintf(fp, "\n");
+    }
+}
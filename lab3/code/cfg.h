@@ -0,0 +1,90 @@
+#ifndef CFG_H
+#define CFG_H
+#include "inter.h"
+
+typedef struct _basicBlock* pBlock;
+typedef struct _loop* pLoop;
+typedef struct _cfg* pCfg;
+
+// 基本块是指令数组里的一段[first, last)，不复制指令
+typedef struct _basicBlock {
+    int id;
+    int first, last;
+    int succ[2];     // 后继最多两个：跳转目标和顺序执行的下一块
+    int succNum;
+    int* pred;       // 指向cfg->predEdges里的一段
+    int predNum;
+    int rpo;         // 逆后序编号，不可达的块为-1
+    int idom;        // 直接支配者，入口块和不可达的块为-1
+    int domPre, domPost;  // 支配树上的先序/后序编号，O(1)判断支配关系
+    int loop;        // 所在最内层循环的下标，不在循环里为-1
+} BasicBlock;
+
+// 自然循环，同一个头的回边合并成一个循环
+typedef struct _loop {
+    int header;
+    int* blocks;     // 循环体里的块，含头，指向cfg->loopBlocks里的一段
+    int blockNum;
+    int parent;      // 外层循环的下标，最外层为-1
+    int depth;       // 最外层为1
+} Loop;
+
+// 一个函数的控制流图，从IR_FUNCTION那条指令开始到下一个函数之前
+typedef struct _cfg {
+    pInterCodeList list;
+    int funcStart, funcEnd;
+    pBlock blocks;   // blocks[0]是入口块，按指令顺序排列
+    int blockNum;
+    int* predEdges;
+    int* rpo;        // 可达的块按逆后序排列
+    int rpoNum;
+    pLoop loops;     // 外层循环排在内层之前
+    int loopNum;
+    int* loopBlocks;
+} Cfg;
+
+// 依次取出每个函数的起点：for (i = 0; i < n; i = nextFunction(list, i))
+int nextFunction(pInterCodeList list, int i);
+
+pCfg newCfg(pInterCodeList list, int funcStart);
+void deleteCfg(pCfg cfg);
+void printCfg(FILE* fp, pCfg cfg);
+
+static inline boolean dominates(pCfg cfg, int a, int b) {
+    pBlock x = &cfg->blocks[a], y = &cfg->blocks[b];
+    return x->rpo >= 0 && y->rpo >= 0 && x->domPre <= y->domPre &&
+           y->domPost <= x->domPost;
+}
+
+static inline int loopDepth(pCfg cfg, int b) {
+    int loop = cfg->blocks[b].loop;
+    return loop < 0 ? 0 : cfg->loops[loop].depth;
+}
+
+// 块b是否在第l个循环里（含内层循环）
+static inline boolean inLoop(pCfg cfg, int b, int l) {
+    for (int k = cfg->blocks[b].loop; k >= 0; k = cfg->loops[k].parent)
+        if (k == l) return TRUE;
+    return FALSE;
+}
+
+// 遍历，块都以下标给出，循环体里可以照常break
+#define forEachBlock(cfg, b) \
+    for (int b = 0; b < (cfg)->blockNum; b++)
+#define forEachRpo(cfg, b)                                             \
+    for (int _i_##b = 0, b; _i_##b < (cfg)->rpoNum &&                  \
+                            ((b = (cfg)->rpo[_i_##b]), 1);             \
+         _i_##b++)
+#define forEachSucc(cfg, b, s)                                         \
+    for (int _i_##s = 0, s; _i_##s < (cfg)->blocks[b].succNum &&       \
+                            ((s = (cfg)->blocks[b].succ[_i_##s]), 1);  \
+         _i_##s++)
+#define forEachPred(cfg, b, p)                                         \
+    for (int _i_##p = 0, p; _i_##p < (cfg)->blocks[b].predNum &&       \
+                            ((p = (cfg)->blocks[b].pred[_i_##p]), 1);  \
+         _i_##p++)
+#define forEachCode(cfg, b, code)                                      \
+    for (pInterCode code = &(cfg)->list->codes[(cfg)->blocks[b].first]; \
+         code < &(cfg)->list->codes[(cfg)->blocks[b].last]; code++)
+
+#endif
@@ -0,0 +1,375 @@
+#include "cfg.h"
+#include "intern.h"
+#include "optimize.h"
+
+// 函数内联。每个函数的指令先拆到自己的数组里，按调用图自底向上处理：
+// Tarjan算法出栈的强连通分量里，被调用的函数总是先处理完，内联时拷的
+// 就是它内联过之后的函数体。同一分量里有多个函数或者自己调自己的是递归，
+// 不内联，也不往里内联它们自己。
+//   ARG a1 ... ARG an; x := CALL f
+// 换成
+//   p1' := a1 ... pn' := an; f的函数体; LABEL end
+// 函数体里的临时变量、标签都换成新的，局部变量（包括形参和DEC出来的数组、
+// 结构体）换成新的临时变量，RETURN v 换成 x := v'; GOTO end。
+// 结构体形参传的是地址，换成临时变量后照样当地址用。
+// 处理完以后从main调不到的函数删掉
+typedef struct _funcInfo {
+    char* name;
+    pInterCode codes;  // codes[0]是FUNCTION
+    int codeNum, codeCap;
+    int paramNum;
+    int calls;         // 剩下的调用点个数
+    int index, low;    // Tarjan的编号，-1表示还没访问
+    boolean onStack;
+    boolean recursive;
+    boolean live;
+} FuncInfo;
+
+static FuncInfo* funcs;
+static int funcNum;
+static int* funcTable;  // 按名字的开放定址表，存函数下标，-1为空
+static unsigned funcMask;
+static int* stack;
+static int top, visitNum;
+
+static pInterCode out;  // 正在生成的函数体
+static int outNum, outCap;
+static int inlined;
+
+// 一次展开里旧编号到新编号的映射，用展开的序号做时间戳，不必清零
+static int instance;
+static int* idStamp;
+static int* idMap;
+static int idCap;
+static int* tempStamp;
+static int* tempMap;
+static int tempCap;
+static int* labelStamp;
+static int* labelMap;
+static int labelCap;
+static char** varNames;  // 局部变量名 -> 临时变量编号，展开里按出现顺序放
+static int* varTemps;
+static int varNum, varCap;
+
+static int findFunction(char* name) {
+    for (unsigned h = internHash(name) & funcMask; funcTable[h] >= 0;
+         h = (h + 1) & funcMask)
+        if (funcs[funcTable[h]].name == name) return funcTable[h];
+    return -1;
+}
+
+static int calleeOf(pInterCode code) {
+    if (code->kind != IR_CALL) return -1;
+    return findFunction(getOperand(code->u.assign.right)->u.name);
+}
+
+static pInterCode emit(int kind) {
+    if (outNum == outCap) {
+        outCap = outCap ? outCap * 2 : 256;
+        out = (pInterCode)realloc(out, sizeof(InterCode) * outCap);
+        assert(out != NULL);
+    }
+    pInterCode p = &out[outNum++];
+    memset(p, 0, sizeof(InterCode));
+    p->kind = kind;
+    return p;
+}
+
+// 按下标取映射表的一项，不够长时扩容，新的部分时间戳为0
+static void growMap(int** stamp, int** map, int* cap, int n) {
+    if (n < *cap) return;
+    int old = *cap;
+    while (n >= *cap) *cap = *cap ? *cap * 2 : 256;
+    *stamp = (int*)realloc(*stamp, sizeof(int) * *cap);
+    *map = (int*)realloc(*map, sizeof(int) * *cap);
+    assert(*stamp != NULL && *map != NULL);
+    memset(*stamp + old, 0, sizeof(int) * (*cap - old));
+}
+
+static int mapTemp(int no) {
+    growMap(&tempStamp, &tempMap, &tempCap, no);
+    if (tempStamp[no] != instance) {
+        tempStamp[no] = instance;
+        tempMap[no] = interCodeList->tempVarNum++;
+    }
+    return tempMap[no];
+}
+
+static int mapLabel(int no) {
+    growMap(&labelStamp, &labelMap, &labelCap, no);
+    if (labelStamp[no] != instance) {
+        labelStamp[no] = instance;
+        labelMap[no] = interCodeList->labelNum++;
+    }
+    return labelMap[no];
+}
+
+// 内联的函数都很小，局部变量顺序找就够了
+static int mapVariable(char* name) {
+    for (int i = 0; i < varNum; i++)
+        if (varNames[i] == name) return varTemps[i];
+    if (varNum == varCap) {
+        varCap = varCap ? varCap * 2 : 32;
+        varNames = (char**)realloc(varNames, sizeof(char*) * varCap);
+        varTemps = (int*)realloc(varTemps, sizeof(int) * varCap);
+        assert(varNames != NULL && varTemps != NULL);
+    }
+    varNames[varNum] = name;
+    varTemps[varNum] = interCodeList->tempVarNum++;
+    return varTemps[varNum++];
+}
+
+static OperandId mapOperand(OperandId id) {
+    if (id == NO_OPERAND) return id;
+    growMap(&idStamp, &idMap, &idCap, id);
+    if (idStamp[id] == instance) return (OperandId)idMap[id];
+    // newOperand可能让操作数表搬家，先拷出来
+    Operand op = *getOperand(id);
+    OperandId r = id;
+    if (op.kind == OP_TEMP)
+        r = newOperand(OP_TEMP, mapTemp(op.u.no));
+    else if (op.kind == OP_VARIABLE)
+        r = newOperand(OP_TEMP, mapVariable(op.u.name));
+    else if (op.kind == OP_LABEL)
+        r = newOperand(OP_LABEL, mapLabel(op.u.no));
+    if (r != id) getOperand(r)->isAddr = op.isAddr;
+    idStamp[id] = instance;
+    idMap[id] = (int)r;
+    return r;
+}
+
+static void mapCode(pInterCode code) {
+    switch (code->kind) {
+        case IR_ASSIGN:
+        case IR_GET_ADDR:
+        case IR_READ_ADDR:
+        case IR_WRITE_ADDR:
+        case IR_CALL:
+            code->u.assign.left = mapOperand(code->u.assign.left);
+            code->u.assign.right = mapOperand(code->u.assign.right);
+            break;
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            code->u.binOp.result = mapOperand(code->u.binOp.result);
+            code->u.binOp.op1 = mapOperand(code->u.binOp.op1);
+            code->u.binOp.op2 = mapOperand(code->u.binOp.op2);
+            break;
+        case IR_IF_GOTO:
+            code->u.ifGoto.x = mapOperand(code->u.ifGoto.x);
+            code->u.ifGoto.y = mapOperand(code->u.ifGoto.y);
+            code->u.ifGoto.z = mapOperand(code->u.ifGoto.z);
+            break;
+        case IR_DEC:
+            code->u.dec.op = mapOperand(code->u.dec.op);
+            break;
+        default:
+            code->u.oneOp.op = mapOperand(code->u.oneOp.op);
+            break;
+    }
+}
+
+static int costOf(FuncInfo* f) { return f->codeNum - 1 - f->paramNum; }
+
+static boolean canInline(int caller, int callee) {
+    FuncInfo* g = &funcs[callee];
+    if (callee == caller || g->recursive) return FALSE;
+    int cost = costOf(g);
+    if (outNum + cost > INLINE_MAX_FUNC) return FALSE;
+    return cost <= INLINE_MAX_SIZE || (g->calls == 1 && cost <= INLINE_MAX_ONCE);
+}
+
+// 前面最近输出的n个ARG就是这次调用的实参，换成给形参的赋值。
+// 实参是域或数组元素时，ARG之间还夹着取值的指令，要跳过
+static void expandCall(OperandId place, int callee) {
+    FuncInfo* g = &funcs[callee];
+    int argStart = outNum;
+    for (int n = 0; n < g->paramNum;) {
+        assert(argStart > 0);
+        if (out[--argStart].kind == IR_ARG) n++;
+    }
+    instance++;
+    varNum = 0;
+    for (int i = argStart, k = 0; k < g->paramNum; i++) {
+        pInterCode arg = &out[i];
+        if (arg->kind != IR_ARG) continue;
+        pInterCode param = &g->codes[1 + k++];
+        assert(param->kind == IR_PARAM);
+        OperandId value = arg->u.oneOp.op;
+        toAssign(arg, mapOperand(param->u.oneOp.op), value);
+    }
+
+    OperandId end = NO_OPERAND;
+    for (int i = 1 + g->paramNum; i < g->codeNum; i++) {
+        InterCode code = g->codes[i];
+        if (code.kind == IR_CALL) {
+            int h = calleeOf(&code);
+            if (h >= 0) funcs[h].calls++;
+        }
+        mapCode(&code);
+        if (code.kind != IR_RETURN) {
+            *emit(code.kind) = code;
+            continue;
+        }
+        toAssign(emit(IR_ASSIGN), place, code.u.oneOp.op);
+        if (i == g->codeNum - 1) break;
+        if (end == NO_OPERAND) end = newLabel();
+        emit(IR_GOTO)->u.oneOp.op = end;
+    }
+    if (end != NO_OPERAND) emit(IR_LABEL)->u.oneOp.op = end;
+    g->calls--;
+    inlined++;
+}
+
+static void inlineInto(int f) {
+    FuncInfo* fn = &funcs[f];
+    outNum = 0;
+    for (int i = 0; i < fn->codeNum; i++) {
+        pInterCode code = &fn->codes[i];
+        int g = calleeOf(code);
+        if (g >= 0 && canInline(f, g))
+            expandCall(code->u.assign.left, g);
+        else
+            *emit(code->kind) = *code;
+    }
+    // 换下来的数组留给下一个函数用
+    pInterCode old = fn->codes;
+    int oldCap = fn->codeCap;
+    fn->codes = out;
+    fn->codeNum = outNum;
+    fn->codeCap = outCap;
+    out = old;
+    outCap = oldCap;
+}
+
+static void visitFunction(int f) {
+    FuncInfo* fn = &funcs[f];
+    fn->index = fn->low = visitNum++;
+    stack[top++] = f;
+    fn->onStack = TRUE;
+    for (int i = 0; i < fn->codeNum; i++) {
+        int g = calleeOf(&fn->codes[i]);
+        if (g < 0) continue;
+        if (g == f) fn->recursive = TRUE;
+        if (funcs[g].index < 0) {
+            visitFunction(g);
+            if (funcs[g].low < fn->low) fn->low = funcs[g].low;
+        } else if (funcs[g].onStack && funcs[g].index < fn->low) {
+            fn->low = funcs[g].index;
+        }
+    }
+    if (fn->low != fn->index) return;
+    int bottom = top;
+    do funcs[stack[--bottom]].onStack = FALSE;
+    while (stack[bottom] != f);
+    if (top - bottom > 1)
+        for (int i = bottom; i < top; i++) funcs[stack[i]].recursive = TRUE;
+    for (int i = bottom; i < top; i++) inlineInto(stack[i]);
+    top = bottom;
+}
+
+static void markLive(int f) {
+    if (funcs[f].live) return;
+    funcs[f].live = TRUE;
+    for (int i = 0; i < funcs[f].codeNum; i++) {
+        int g = calleeOf(&funcs[f].codes[i]);
+        if (g >= 0) markLive(g);
+    }
+}
+
+int inlineCalls(pInterCodeList list) {
+    // 拆成一个函数一个数组
+    funcNum = 0;
+    for (int i = 0; i < list->codeNum; i = nextFunction(list, i))
+        if (list->codes[i].kind == IR_FUNCTION) funcNum++;
+    if (funcNum == 0) return 0;
+    funcs = (FuncInfo*)malloc(sizeof(FuncInfo) * funcNum);
+    funcMask = 1;
+    while (funcMask < 2u * funcNum) funcMask <<= 1;
+    funcTable = (int*)malloc(sizeof(int) * funcMask);
+    stack = (int*)malloc(sizeof(int) * funcNum);
+    assert(funcs != NULL && funcTable != NULL && stack != NULL);
+    for (unsigned h = 0; h < funcMask; h++) funcTable[h] = -1;
+    funcMask--;
+
+    int n = 0;
+    for (int i = 0; i < list->codeNum; i = nextFunction(list, i)) {
+        if (list->codes[i].kind != IR_FUNCTION) continue;
+        FuncInfo* fn = &funcs[n];
+        fn->name = getOperand(list->codes[i].u.oneOp.op)->u.name;
+        fn->codeNum = fn->codeCap = nextFunction(list, i) - i;
+        fn->codes = (pInterCode)malloc(sizeof(InterCode) * fn->codeNum);
+        assert(fn->codes != NULL);
+        memcpy(fn->codes, &list->codes[i], sizeof(InterCode) * fn->codeNum);
+        fn->paramNum = 0;
+        while (fn->paramNum + 1 < fn->codeNum &&
+               fn->codes[fn->paramNum + 1].kind == IR_PARAM)
+            fn->paramNum++;
+        fn->calls = 0;
+        fn->index = fn->low = -1;
+        fn->onStack = fn->recursive = fn->live = FALSE;
+        unsigned h = internHash(fn->name) & funcMask;
+        while (funcTable[h] >= 0) h = (h + 1) & funcMask;
+        funcTable[h] = n++;
+    }
+    for (int f = 0; f < funcNum; f++)
+        for (int i = 0; i < funcs[f].codeNum; i++) {
+            int g = calleeOf(&funcs[f].codes[i]);
+            if (g >= 0) funcs[g].calls++;
+        }
+
+    instance = inlined = 0;
+    top = visitNum = 0;
+    for (int f = 0; f < funcNum; f++)
+        if (funcs[f].index < 0) visitFunction(f);
+
+    int mainFunc = findFunction(intern("main"));
+    if (mainFunc >= 0)
+        markLive(mainFunc);
+    else
+        for (int f = 0; f < funcNum; f++) funcs[f].live = TRUE;
+
+    // 按原来的顺序拼回去
+    int codeNum = 0, removed = 0;
+    for (int f = 0; f < funcNum; f++)
+        if (funcs[f].live) codeNum += funcs[f].codeNum;
+    if (codeNum > list->codeCap) {
+        list->codes = (pInterCode)realloc(list->codes, sizeof(InterCode) * codeNum);
+        assert(list->codes != NULL);
+        list->codeCap = codeNum;
+    }
+    list->codeNum = 0;
+    for (int f = 0; f < funcNum; f++) {
+        if (funcs[f].live) {
+            memcpy(&list->codes[list->codeNum], funcs[f].codes,
+                   sizeof(InterCode) * funcs[f].codeNum);
+            list->codeNum += funcs[f].codeNum;
+        } else {
+            removed++;
+        }
+        free(funcs[f].codes);
+    }
+
+    free(funcs);
+    free(funcTable);
+    free(stack);
+    free(out);
+    free(idStamp);
+    free(idMap);
+    free(tempStamp);
+    free(tempMap);
+    free(labelStamp);
+    free(labelMap);
+    free(varNames);
+    free(varTemps);
+    out = NULL;
+    idStamp = tempStamp = labelStamp = tempMap = labelMap = varTemps = NULL;
+    idMap = NULL;
+    varNames = NULL;
+    outCap = idCap = tempCap = labelCap = varCap = 0;
+    if (optStats)
+        fprintf(stderr, "inline: %d calls inlined, %d functions removed\n",
+                inlined, removed);
+    return inlined;
+}
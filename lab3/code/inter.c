@@ -1,442 +1,365 @@
+// write/fileno在-std=c99下需要POSIX声明
+#define _POSIX_C_SOURCE 200809L
+#include <errno.h>
+#include <unistd.h>
 #include "inter.h"
 
 boolean interError = FALSE;
 pInterCodeList interCodeList;
 
 // Operand func
-pOperand newOperand(int kind, ...) {
-    pOperand p = (pOperand)malloc(sizeof(Operand));
-    assert(p != NULL);
+OperandId newOperand(int kind, ...) {
+    pInterCodeList list = interCodeList;
+    if (list->operandNum == list->operandCap) {
+        list->operandCap *= 2;
+        list->operands = (pOperand)realloc(list->operands,
+                                           sizeof(Operand) * list->operandCap);
+        assert(list->operands != NULL);
+    }
+    OperandId id = list->operandNum++;
+    pOperand p = &list->operands[id];
     p->kind = kind;
+    p->isAddr = FALSE;
     va_list vaList;
     assert(kind >= 0 && kind < 6);
-    va_start(vaList, 1);
+    va_start(vaList, kind);
     switch (kind) {
         case OP_CONSTANT:
             p->u.value = va_arg(vaList, int);
             break;
-        case OP_VARIABLE:
-        case OP_ADDRESS:
+        case OP_TEMP:
         case OP_LABEL:
-        case OP_FUNCTION:
+            p->u.no = va_arg(vaList, int);
+            break;
         case OP_RELOP:
+            p->u.relop = va_arg(vaList, int);
+            break;
+        case OP_VARIABLE:
+        case OP_FUNCTION:
             p->u.name = va_arg(vaList, char*);
             break;
     }
-
-    // p->isAddr = FALSE;
-
-    return p;
+    va_end(vaList);
+    return id;
 }
 
-void setOperand(pOperand p, int kind, void* val) {
-    assert(p != NULL);
+// 改的是表里的操作数，所有引用它的指令都会看到
+void setOperand(OperandId id, int kind, void* val) {
+    pOperand p = getOperand(id);
     assert(kind >= 0 && kind < 6);
     p->kind = kind;
+    p->isAddr = FALSE;
     switch (kind) {
         case OP_CONSTANT:
-            p->u.value = (int)val;
+            p->u.value = (int)(long)val;
             break;
-        case OP_VARIABLE:
-        case OP_ADDRESS:
+        case OP_TEMP:
         case OP_LABEL:
-        case OP_FUNCTION:
+            p->u.no = (int)(long)val;
+            break;
         case OP_RELOP:
-            if (p->u.name) free(p->u.name);
+            p->u.relop = (Relop)(long)val;
+            break;
+        case OP_VARIABLE:
+        case OP_FUNCTION:
             p->u.name = (char*)val;
             break;
     }
 }
 
-void deleteOperand(pOperand p) {
-    if (p == NULL) return;
-    assert(p->kind >= 0 && p->kind < 6);
-    switch (p->kind) {
+static char* relopNames[] = {"<", "<=", ">", ">=", "==", "!="};
+
+Relop getRelop(char* name) {
+    for (int i = 0; i < 6; i++)
+        if (!strcmp(name, relopNames[i])) return (Relop)i;
+    assert(0);
+    return RELOP_NE;
+}
+
+char* relopName(Relop relop) {
+    assert(relop >= RELOP_LT && relop <= RELOP_NE);
+    return relopNames[relop];
+}
+
+// 打印时把临时变量按出现顺序重新编号，翻译时丢弃的编号不占名字
+static int* tempNames = NULL;
+static int tempNameNum = 0;
+
+static int tempName(int no) {
+    if (tempNames[no] == 0) tempNames[no] = ++tempNameNum;
+    return tempNames[no];
+}
+
+// 输出先格式化进一整块缓冲区，最后一次write写出
+static char* outBuf = NULL;
+static size_t outLen = 0;
+static size_t outCap = 0;
+
+// 每条指令不超过4个操作数，预留这么多就不必逐字符检查容量
+#define OUT_RESERVE 256
+
+static void reserveOut(size_t n) {
+    if (outLen + n <= outCap) return;
+    while (outLen + n > outCap) outCap = outCap ? outCap * 2 : 1 << 16;
+    outBuf = (char*)realloc(outBuf, outCap);
+    assert(outBuf != NULL);
+}
+
+static void putStr(const char* str) {
+    size_t len = strlen(str);
+    // 名字可能很长，补足余量让本条指令后面的直接写入仍然安全
+    reserveOut(len + OUT_RESERVE);
+    memcpy(outBuf + outLen, str, len);
+    outLen += len;
+}
+
+static void putInt(int val) {
+    char digits[12];
+    int n = 0;
+    unsigned u = val < 0 ? 0u - (unsigned)val : (unsigned)val;
+    do {
+        digits[n++] = '0' + u % 10;
+        u /= 10;
+    } while (u);
+    if (val < 0) outBuf[outLen++] = '-';
+    while (n) outBuf[outLen++] = digits[--n];
+}
+
+static void putOp(OperandId id) {
+    pOperand op = getOperand(id);
+    switch (op->kind) {
         case OP_CONSTANT:
+            outBuf[outLen++] = '#';
+            putInt(op->u.value);
+            break;
+        case OP_TEMP:
+            outBuf[outLen++] = 't';
+            putInt(tempName(op->u.no));
             break;
-        case OP_VARIABLE:
-        case OP_ADDRESS:
         case OP_LABEL:
-        case OP_FUNCTION:
+            putStr("label");
+            putInt(op->u.no);
+            break;
         case OP_RELOP:
-            if (p->u.name) {
-                free(p->u.name);
-                p->u.name = NULL;
-            }
+            putStr(relopName(op->u.relop));
+            break;
+        case OP_VARIABLE:
+        case OP_FUNCTION:
+            putStr(op->u.name);
             break;
     }
-    free(p);
 }
 
-void printOp(FILE* fp, pOperand op) {
-    assert(op != NULL);
-    if (fp == NULL) {
-        switch (op->kind) {
-            case OP_CONSTANT:
-                printf("#%d", op->u.value);
-                break;
-            case OP_VARIABLE:
-            case OP_ADDRESS:
-            case OP_LABEL:
-            case OP_FUNCTION:
-            case OP_RELOP:
-                printf("%s", op->u.name);
-                break;
-        }
-    } else {
-        switch (op->kind) {
-            case OP_CONSTANT:
-                fprintf(fp, "#%d", op->u.value);
-                break;
-            case OP_VARIABLE:
-            case OP_ADDRESS:
-            case OP_LABEL:
-            case OP_FUNCTION:
-            case OP_RELOP:
-                fprintf(fp, "%s", op->u.name);
-                break;
+static void flushOut(int fd) {
+    size_t done = 0;
+    while (done < outLen) {
+        ssize_t n = write(fd, outBuf + done, outLen - done);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("write");
+            break;
         }
+        done += n;
     }
+    outLen = 0;
 }
 
 // InterCode func
-pInterCode newInterCode(int kind, ...) {
-    pInterCode p = (pInterCode)malloc(sizeof(InterCode));
-    assert(p != NULL);
-    p->kind = kind;
-    va_list vaList;
+// 在指令数组末尾追加一条记录，由调用者填操作数
+pInterCode newInterCode(int kind) {
+    pInterCodeList list = interCodeList;
     assert(kind >= 0 && kind < 19);
-    switch (kind) {
-        case IR_LABEL:
-        case IR_FUNCTION:
-        case IR_GOTO:
-        case IR_RETURN:
-        case IR_ARG:
-        case IR_PARAM:
-        case IR_READ:
-        case IR_WRITE:
-            va_start(vaList, 1);
-            p->u.oneOp.op = va_arg(vaList, pOperand);
-            break;
+    if (list->codeNum == list->codeCap) {
+        list->codeCap *= 2;
+        list->codes = (pInterCode)realloc(list->codes,
+                                          sizeof(InterCode) * list->codeCap);
+        assert(list->codes != NULL);
+    }
+    pInterCode p = &list->codes[list->codeNum++];
+    memset(p, 0, sizeof(InterCode));
+    p->kind = kind;
+    return p;
+}
+
+// 指令读取的操作数槽位，返回个数。标签、运算符和取地址的变量不算；
+// *x := y 和 x := *y 里的x是作为地址值读的，算读取
+int getUseSlots(pInterCode code, OperandId* slots[3]) {
+    switch (code->kind) {
         case IR_ASSIGN:
-        case IR_GET_ADDR:
         case IR_READ_ADDR:
+            slots[0] = &code->u.assign.right;
+            return 1;
         case IR_WRITE_ADDR:
-        case IR_CALL:
-            va_start(vaList, 2);
-            p->u.assign.left = va_arg(vaList, pOperand);
-            p->u.assign.right = va_arg(vaList, pOperand);
-            break;
+            slots[0] = &code->u.assign.left;
+            slots[1] = &code->u.assign.right;
+            return 2;
         case IR_ADD:
         case IR_SUB:
         case IR_MUL:
         case IR_DIV:
-            va_start(vaList, 3);
-            p->u.binOp.result = va_arg(vaList, pOperand);
-            p->u.binOp.op1 = va_arg(vaList, pOperand);
-            p->u.binOp.op2 = va_arg(vaList, pOperand);
-            break;
-        case IR_DEC:
-            va_start(vaList, 2);
-            p->u.dec.op = va_arg(vaList, pOperand);
-            p->u.dec.size = va_arg(vaList, int);
-            break;
+            slots[0] = &code->u.binOp.op1;
+            slots[1] = &code->u.binOp.op2;
+            return 2;
         case IR_IF_GOTO:
-            va_start(vaList, 4);
-            p->u.ifGoto.x = va_arg(vaList, pOperand);
-            p->u.ifGoto.relop = va_arg(vaList, pOperand);
-            p->u.ifGoto.y = va_arg(vaList, pOperand);
-            p->u.ifGoto.z = va_arg(vaList, pOperand);
-    }
-    return p;
-}
-
-void deleteInterCode(pInterCode p) {
-    assert(p != NULL);
-    assert(p->kind >= 0 && p->kind < 19);
-    switch (p->kind) {
-        case IR_LABEL:
-        case IR_FUNCTION:
-        case IR_GOTO:
+            slots[0] = &code->u.ifGoto.x;
+            slots[1] = &code->u.ifGoto.y;
+            return 2;
         case IR_RETURN:
         case IR_ARG:
-        case IR_PARAM:
-        case IR_READ:
         case IR_WRITE:
-            deleteOperand(p->u.oneOp.op);
-            break;
+            slots[0] = &code->u.oneOp.op;
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// 指令写入的操作数槽位，没有则返回NULL；*x := y 写的是内存，不算
+OperandId* getDefSlot(pInterCode code) {
+    switch (code->kind) {
         case IR_ASSIGN:
         case IR_GET_ADDR:
         case IR_READ_ADDR:
-        case IR_WRITE_ADDR:
         case IR_CALL:
-            deleteOperand(p->u.assign.left);
-            deleteOperand(p->u.assign.right);
-            break;
+            return &code->u.assign.left;
         case IR_ADD:
         case IR_SUB:
         case IR_MUL:
         case IR_DIV:
-            deleteOperand(p->u.binOp.result);
-            deleteOperand(p->u.binOp.op1);
-            deleteOperand(p->u.binOp.op2);
-            break;
-        case IR_DEC:
-            deleteOperand(p->u.dec.op);
-            break;
-        case IR_IF_GOTO:
-            deleteOperand(p->u.ifGoto.x);
-            deleteOperand(p->u.ifGoto.relop);
-            deleteOperand(p->u.ifGoto.y);
-            deleteOperand(p->u.ifGoto.z);
+            return &code->u.binOp.result;
+        case IR_PARAM:
+        case IR_READ:
+            return &code->u.oneOp.op;
+        default:
+            return NULL;
     }
-    free(p);
 }
 
-void printInterCode(FILE* fp, pInterCodeList interCodeList) {
-    for (pInterCodes cur = interCodeList->head; cur != NULL; cur = cur->next) {
-        assert(cur->code->kind >= 0 && cur->code->kind < 19);
-        if (fp == NULL) {
-            switch (cur->code->kind) {
-                case IR_LABEL:
-                    printf("LABEL ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    printf(" :");
-                    break;
-                case IR_FUNCTION:
-                    printf("FUNCTION ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    printf(" :");
-                    break;
-                case IR_ASSIGN:
-                    printOp(fp, cur->code->u.assign.left);
-                    printf(" := ");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_ADD:
-                    printOp(fp, cur->code->u.binOp.result);
-                    printf(" := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    printf(" + ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_SUB:
-                    printOp(fp, cur->code->u.binOp.result);
-                    printf(" := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    printf(" - ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_MUL:
-                    printOp(fp, cur->code->u.binOp.result);
-                    printf(" := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    printf(" * ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_DIV:
-                    printOp(fp, cur->code->u.binOp.result);
-                    printf(" := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    printf(" / ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_GET_ADDR:
-                    printOp(fp, cur->code->u.assign.left);
-                    printf(" := &");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_READ_ADDR:
-                    printOp(fp, cur->code->u.assign.left);
-                    printf(" := *");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_WRITE_ADDR:
-                    printf("*");
-                    printOp(fp, cur->code->u.assign.left);
-                    printf(" := ");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_GOTO:
-                    printf("GOTO ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_IF_GOTO:
-                    printf("IF ");
-                    printOp(fp, cur->code->u.ifGoto.x);
-                    printf(" ");
-                    printOp(fp, cur->code->u.ifGoto.relop);
-                    printf(" ");
-                    printOp(fp, cur->code->u.ifGoto.y);
-                    printf(" GOTO ");
-                    printOp(fp, cur->code->u.ifGoto.z);
-                    break;
-                case IR_RETURN:
-                    printf("RETURN ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_DEC:
-                    printf("DEC ");
-                    printOp(fp, cur->code->u.dec.op);
-                    printf(" ");
-                    printf("%d", cur->code->u.dec.size);
-                    break;
-                case IR_ARG:
-                    printf("ARG ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_CALL:
-                    printOp(fp, cur->code->u.assign.left);
-                    printf(" := CALL ");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_PARAM:
-                    printf("PARAM ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_READ:
-                    printf("READ ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_WRITE:
-                    printf("WRITE ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-            }
-            printf("\n");
-        } else {
-            switch (cur->code->kind) {
-                case IR_LABEL:
-                    fprintf(fp, "LABEL ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    fprintf(fp, " :");
-                    break;
-                case IR_FUNCTION:
-                    fprintf(fp, "FUNCTION ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    fprintf(fp, " :");
-                    break;
-                case IR_ASSIGN:
-                    printOp(fp, cur->code->u.assign.left);
-                    fprintf(fp, " := ");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_ADD:
-                    printOp(fp, cur->code->u.binOp.result);
-                    fprintf(fp, " := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    fprintf(fp, " + ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_SUB:
-                    printOp(fp, cur->code->u.binOp.result);
-                    fprintf(fp, " := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    fprintf(fp, " - ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_MUL:
-                    printOp(fp, cur->code->u.binOp.result);
-                    fprintf(fp, " := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    fprintf(fp, " * ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_DIV:
-                    printOp(fp, cur->code->u.binOp.result);
-                    fprintf(fp, " := ");
-                    printOp(fp, cur->code->u.binOp.op1);
-                    fprintf(fp, " / ");
-                    printOp(fp, cur->code->u.binOp.op2);
-                    break;
-                case IR_GET_ADDR:
-                    printOp(fp, cur->code->u.assign.left);
-                    fprintf(fp, " := &");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_READ_ADDR:
-                    printOp(fp, cur->code->u.assign.left);
-                    fprintf(fp, " := *");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_WRITE_ADDR:
-                    fprintf(fp, "*");
-                    printOp(fp, cur->code->u.assign.left);
-                    fprintf(fp, " := ");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_GOTO:
-                    fprintf(fp, "GOTO ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_IF_GOTO:
-                    fprintf(fp, "IF ");
-                    printOp(fp, cur->code->u.ifGoto.x);
-                    fprintf(fp, " ");
-                    printOp(fp, cur->code->u.ifGoto.relop);
-                    fprintf(fp, " ");
-                    printOp(fp, cur->code->u.ifGoto.y);
-                    fprintf(fp, " GOTO ");
-                    printOp(fp, cur->code->u.ifGoto.z);
-                    break;
-                case IR_RETURN:
-                    fprintf(fp, "RETURN ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_DEC:
-                    fprintf(fp, "DEC ");
-                    printOp(fp, cur->code->u.dec.op);
-                    fprintf(fp, " ");
-                    fprintf(fp, "%d", cur->code->u.dec.size);
-                    break;
-                case IR_ARG:
-                    fprintf(fp, "ARG ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_CALL:
-                    printOp(fp, cur->code->u.assign.left);
-                    fprintf(fp, " := CALL ");
-                    printOp(fp, cur->code->u.assign.right);
-                    break;
-                case IR_PARAM:
-                    fprintf(fp, "PARAM ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_READ:
-                    fprintf(fp, "READ ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-                case IR_WRITE:
-                    fprintf(fp, "WRITE ");
-                    printOp(fp, cur->code->u.oneOp.op);
-                    break;
-            }
-            fprintf(fp, "\n");
-        }
-    }
+OperandId getDef(pInterCode code) {
+    OperandId* slot = getDefSlot(code);
+    return slot ? *slot : NO_OPERAND;
 }
 
-// InterCodes func
-pInterCodes newInterCodes(pInterCode code) {
-    pInterCodes p = (pInterCodes)malloc(sizeof(InterCodes));
-    assert(p != NULL);
-    p->code = code;
-    p->prev = NULL;
-    p->next = NULL;
-}
+// 二元运算的中缀符号，下标是kind - IR_ADD
+static char* binOpNames[] = {" + ", " - ", " * ", " / "};
 
-void deleteInterCodes(pInterCodes p) {
-    assert(p != NULL);
-    deleteInterCode(p->code);
-    free(p);
+void printInterCode(FILE* fp, pInterCodeList interCodeList) {
+    if (fp == NULL) fp = stdout;
+    tempNames = (int*)calloc(interCodeList->tempVarNum, sizeof(int));
+    assert(tempNames != NULL);
+    tempNameNum = 0;
+    for (int i = 0; i < interCodeList->codeNum; i++) {
+        pInterCode code = &interCodeList->codes[i];
+        assert(code->kind >= 0 && code->kind < 19);
+        reserveOut(OUT_RESERVE);
+        switch (code->kind) {
+            case IR_LABEL:
+                putStr("LABEL ");
+                putOp(code->u.oneOp.op);
+                putStr(" :");
+                break;
+            case IR_FUNCTION:
+                putStr("FUNCTION ");
+                putOp(code->u.oneOp.op);
+                putStr(" :");
+                break;
+            case IR_ASSIGN:
+                putOp(code->u.assign.left);
+                putStr(" := ");
+                putOp(code->u.assign.right);
+                break;
+            case IR_ADD:
+            case IR_SUB:
+            case IR_MUL:
+            case IR_DIV:
+                putOp(code->u.binOp.result);
+                putStr(" := ");
+                putOp(code->u.binOp.op1);
+                putStr(binOpNames[code->kind - IR_ADD]);
+                putOp(code->u.binOp.op2);
+                break;
+            case IR_GET_ADDR:
+                putOp(code->u.assign.left);
+                putStr(" := &");
+                putOp(code->u.assign.right);
+                break;
+            case IR_READ_ADDR:
+                putOp(code->u.assign.left);
+                putStr(" := *");
+                putOp(code->u.assign.right);
+                break;
+            case IR_WRITE_ADDR:
+                putStr("*");
+                putOp(code->u.assign.left);
+                putStr(" := ");
+                putOp(code->u.assign.right);
+                break;
+            case IR_GOTO:
+                putStr("GOTO ");
+                putOp(code->u.oneOp.op);
+                break;
+            case IR_IF_GOTO:
+                putStr("IF ");
+                putOp(code->u.ifGoto.x);
+                putStr(" ");
+                putOp(code->u.ifGoto.relop);
+                putStr(" ");
+                putOp(code->u.ifGoto.y);
+                putStr(" GOTO ");
+                putOp(code->u.ifGoto.z);
+                break;
+            case IR_RETURN:
+                putStr("RETURN ");
+                putOp(code->u.oneOp.op);
+                break;
+            case IR_DEC:
+                putStr("DEC ");
+                putOp(code->u.dec.op);
+                putStr(" ");
+                putInt(code->u.dec.size);
+                break;
+            case IR_ARG:
+                putStr("ARG ");
+                putOp(code->u.oneOp.op);
+                break;
+            case IR_CALL:
+                putOp(code->u.assign.left);
+                putStr(" := CALL ");
+                putOp(code->u.assign.right);
+                break;
+            case IR_PARAM:
+                putStr("PARAM ");
+                putOp(code->u.oneOp.op);
+                break;
+            case IR_READ:
+                putStr("READ ");
+                putOp(code->u.oneOp.op);
+                break;
+            case IR_WRITE:
+                putStr("WRITE ");
+                putOp(code->u.oneOp.op);
+                break;
+        }
+        outBuf[outLen++] = '\n';
+    }
+    free(tempNames);
+    tempNames = NULL;
+
+    // 之前经stdio输出的内容（如报错）要先落地
+    fflush(fp);
+    flushOut(fileno(fp));
+    free(outBuf);
+    outBuf = NULL;
+    outCap = 0;
 }
 
 // Arg and ArgList func
-pArg newArg(pOperand op) {
+pArg newArg(OperandId op) {
     pArg p = (pArg)malloc(sizeof(Arg));
     assert(p != NULL);
     p->op = op;
     p->next = NULL;
+    return p;
 }
 
 pArgList newArgList() {
@@ -444,11 +367,11 @@ pArgList newArgList() {
     assert(p != NULL);
     p->head = NULL;
     p->cur = NULL;
+    return p;
 }
 
 void deleteArg(pArg p) {
     assert(p != NULL);
-    deleteOperand(p->op);
     free(p);
 }
 
@@ -476,75 +399,72 @@ void addArg(pArgList argList, pArg arg) {
 // InterCodeList func
 pInterCodeList newInterCodeList() {
     pInterCodeList p = (pInterCodeList)malloc(sizeof(InterCodeList));
-    p->head = NULL;
-    p->cur = NULL;
-    p->lastArrayName = NULL;
+    assert(p != NULL);
+    p->codeNum = 0;
+    p->codeCap = 1024;
+    p->codes = (pInterCode)malloc(sizeof(InterCode) * p->codeCap);
+    assert(p->codes != NULL);
+    // 0号操作数保留
+    p->operandNum = 1;
+    p->operandCap = 1024;
+    p->operands = (pOperand)malloc(sizeof(Operand) * p->operandCap);
+    assert(p->operands != NULL);
+    p->curFunc = NULL;
     p->tempVarNum = 1;
     p->labelNum = 1;
+    return p;
 }
 
 void deleteInterCodeList(pInterCodeList p) {
     assert(p != NULL);
-    pInterCodes q = p->head;
-    while (q) {
-        pInterCodes temp = q;
-        q = q->next;
-        deleteInterCodes(temp);
-    }
+    free(p->codes);
+    free(p->operands);
     free(p);
 }
 
-void addInterCode(pInterCodeList interCodeList, pInterCodes newCode) {
-    if (interCodeList->head == NULL) {
-        interCodeList->head = newCode;
-        interCodeList->cur = newCode;
-    } else {
-        interCodeList->cur->next = newCode;
-        newCode->prev = interCodeList->cur;
-        interCodeList->cur = newCode;
-    }
+// traverse func
+OperandId newTemp() {
+    return newOperand(OP_TEMP, interCodeList->tempVarNum++);
 }
 
-// traverse func
-pOperand newTemp() {
-    // printf("newTemp() tempVal:%d\n", interCodeList->tempVarNum);
-    char tName[10] = {0};
-    sprintf(tName, "t%d", interCodeList->tempVarNum);
-    interCodeList->tempVarNum++;
-    pOperand temp = newOperand(OP_VARIABLE, newString(tName));
-    return temp;
+OperandId newLabel() {
+    return newOperand(OP_LABEL, interCodeList->labelNum++);
 }
 
-pOperand newLabel() {
-    char lName[10] = {0};
-    sprintf(lName, "label%d", interCodeList->labelNum);
-    interCodeList->labelNum++;
-    pOperand temp = newOperand(OP_LABEL, newString(lName));
-    return temp;
+// 局部变量在语义分析离开作用域时转存到了函数的符号表里
+static pItem searchSymbol(char* name) {
+    return searchFuncItem(table, interCodeList->curFunc, name);
 }
 
-int getSize(pType type) {
-    if (type == NULL)
-        return 0;
-    else if (type->kind == BASIC)
-        return 4;
-    else if (type->kind == ARRAY)
-        return type->u.array.size * getSize(type->u.array.elem);
-    else if (type->kind == STRUCTURE) {
-        int size = 0;
-        pFieldList temp = type->u.structure.field;
-        while (temp) {
-            size += getSize(temp->type);
-            temp = temp->tail;
+// 左值表达式的类型，其余表达式只会是int/float，返回NULL
+static pType getExpType(pNode node) {
+    switch (node->prod) {
+        // Exp -> LP Exp RP
+        case PROD_EXP_PAREN:
+            return getExpType(node->child->next);
+        // Exp -> ID
+        case PROD_EXP_ID:
+            return searchSymbol(node->child->val)->field->type;
+        // Exp -> Exp LB Exp RB
+        case PROD_EXP_INDEX: {
+            pType type = getExpType(node->child);
+            return type ? type->u.array.elem : NULL;
         }
-        return size;
+        // Exp -> Exp DOT ID
+        case PROD_EXP_DOT: {
+            pType type = getExpType(node->child);
+            char* name = node->child->next->next->val;
+            pFieldList field = type ? searchField(type, name) : NULL;
+            return field ? field->type : NULL;
+        }
+        default:
+            return NULL;
     }
-    return 0;
 }
 
 void genInterCodes(pNode node) {
     if (node == NULL) return;
-    if (!strcmp(node->name, "ExtDefList"))
+    if (node->symbol == SYM_EXT_DEF_LIST)
         translateExtDefList(node);
     else {
         genInterCodes(node->child);
@@ -554,10 +474,11 @@ void genInterCodes(pNode node) {
 
 void genInterCode(int kind, ...) {
     va_list vaList;
-    pOperand temp = NULL;
-    pOperand result = NULL, op1 = NULL, op2 = NULL, relop = NULL;
+    OperandId temp = NO_OPERAND;
+    OperandId result = NO_OPERAND, op1 = NO_OPERAND, op2 = NO_OPERAND,
+              relop = NO_OPERAND;
     int size = 0;
-    pInterCodes newCode = NULL;
+    pInterCode code = NULL;
     assert(kind >= 0 && kind < 19);
     switch (kind) {
         case IR_LABEL:
@@ -569,14 +490,14 @@ void genInterCode(int kind, ...) {
         case IR_READ:
         case IR_WRITE:
             va_start(vaList, 1);
-            op1 = va_arg(vaList, pOperand);
-            if (op1->kind == OP_ADDRESS) {
+            op1 = va_arg(vaList, OperandId);
+            if (getOperand(op1)->isAddr) {
                 temp = newTemp();
                 genInterCode(IR_READ_ADDR, temp, op1);
                 op1 = temp;
             }
-            newCode = newInterCodes(newInterCode(kind, op1));
-            addInterCode(interCodeList, newCode);
+            code = newInterCode(kind);
+            code->u.oneOp.op = op1;
             break;
         case IR_ASSIGN:
         case IR_GET_ADDR:
@@ -584,13 +505,13 @@ void genInterCode(int kind, ...) {
         case IR_WRITE_ADDR:
         case IR_CALL:
             va_start(vaList, 2);
-            op1 = va_arg(vaList, pOperand);
-            op2 = va_arg(vaList, pOperand);
+            op1 = va_arg(vaList, OperandId);
+            op2 = va_arg(vaList, OperandId);
             if (kind == IR_ASSIGN &&
-                (op1->kind == OP_ADDRESS || op2->kind == OP_ADDRESS)) {
-                if (op1->kind == OP_ADDRESS && op2->kind != OP_ADDRESS)
+                (getOperand(op1)->isAddr || getOperand(op2)->isAddr)) {
+                if (getOperand(op1)->isAddr && !getOperand(op2)->isAddr)
                     genInterCode(IR_WRITE_ADDR, op1, op2);
-                else if (op2->kind == OP_ADDRESS && op1->kind != OP_ADDRESS)
+                else if (getOperand(op2)->isAddr && !getOperand(op1)->isAddr)
                     genInterCode(IR_READ_ADDR, op1, op2);
                 else {
                     temp = newTemp();
@@ -598,8 +519,9 @@ void genInterCode(int kind, ...) {
                     genInterCode(IR_WRITE_ADDR, op1, temp);
                 }
             } else {
-                newCode = newInterCodes(newInterCode(kind, op1, op2));
-                addInterCode(interCodeList, newCode);
+                code = newInterCode(kind);
+                code->u.assign.left = op1;
+                code->u.assign.right = op2;
             }
             break;
         case IR_ADD:
@@ -608,44 +530,49 @@ void genInterCode(int kind, ...) {
         case IR_MUL:
         case IR_DIV:
             va_start(vaList, 3);
-            result = va_arg(vaList, pOperand);
-            op1 = va_arg(vaList, pOperand);
-            op2 = va_arg(vaList, pOperand);
-            if (op1->kind == OP_ADDRESS) {
+            result = va_arg(vaList, OperandId);
+            op1 = va_arg(vaList, OperandId);
+            op2 = va_arg(vaList, OperandId);
+            if (getOperand(op1)->isAddr) {
                 temp = newTemp();
                 genInterCode(IR_READ_ADDR, temp, op1);
                 op1 = temp;
             }
-            if (op2->kind == OP_ADDRESS) {
+            if (getOperand(op2)->isAddr) {
                 temp = newTemp();
                 genInterCode(IR_READ_ADDR, temp, op2);
                 op2 = temp;
             }
             // Added check for immediate operand in IR_SUB
-            if (kind == IR_SUB && op2->kind == OP_CONSTANT) {
+            if (kind == IR_SUB && getOperand(op2)->kind == OP_CONSTANT) {
                 temp = newTemp();
                 genInterCode(IR_ASSIGN, temp, op2);
                 op2 = temp;
             }
-            newCode = newInterCodes(newInterCode(kind, result, op1, op2));
-            addInterCode(interCodeList, newCode);
+            code = newInterCode(kind);
+            code->u.binOp.result = result;
+            code->u.binOp.op1 = op1;
+            code->u.binOp.op2 = op2;
             break;
         case IR_DEC:
             va_start(vaList, 2);
-            op1 = va_arg(vaList, pOperand);
+            op1 = va_arg(vaList, OperandId);
             size = va_arg(vaList, int);
-            newCode = newInterCodes(newInterCode(kind, op1, size));
-            addInterCode(interCodeList, newCode);
+            code = newInterCode(kind);
+            code->u.dec.op = op1;
+            code->u.dec.size = size;
             break;
         case IR_IF_GOTO:
             va_start(vaList, 4);
-            result = va_arg(vaList, pOperand);
-            relop = va_arg(vaList, pOperand);
-            op1 = va_arg(vaList, pOperand);
-            op2 = va_arg(vaList, pOperand);
-            newCode =
-                newInterCodes(newInterCode(kind, result, relop, op1, op2));
-            addInterCode(interCodeList, newCode);
+            result = va_arg(vaList, OperandId);
+            relop = va_arg(vaList, OperandId);
+            op1 = va_arg(vaList, OperandId);
+            op2 = va_arg(vaList, OperandId);
+            code = newInterCode(kind);
+            code->u.ifGoto.x = result;
+            code->u.ifGoto.relop = relop;
+            code->u.ifGoto.y = op1;
+            code->u.ifGoto.z = op2;
             break;
     }
 }
@@ -667,7 +594,7 @@ void translateExtDef(pNode node) {
 
     // 因为没有全局变量使用，
     // ExtDecList不涉及中间代码生成，类型声明也不涉及，所以只需要处理FunDec和CompSt
-    if (!strcmp(node->child->next->name, "FunDec")) {
+    if (node->prod == PROD_EXT_DEF_FUNC) {
         translateFunDec(node->child->next);
         translateCompSt(node->child->next->next);
     }
@@ -679,15 +606,16 @@ void translateFunDec(pNode node) {
     // FunDec -> ID LP VarList RP
     //         | ID LP RP
     genInterCode(IR_FUNCTION,
-                 newOperand(OP_FUNCTION, newString(node->child->val)));
+                 newOperand(OP_FUNCTION, node->child->val));
     // pInterCodes func = newInterCodes(newInterCode(
     //     IR_FUNCTION, newOperand(OP_FUNCTION, newString(node->child->val))));
     // addInterCode(interCodeList, func);
 
     pItem funcItem = searchTableItem(table, node->child->val);
+    interCodeList->curFunc = funcItem;
     pFieldList temp = funcItem->field->type->u.function.argv;
     while (temp) {
-        genInterCode(IR_PARAM, newOperand(OP_VARIABLE, newString(temp->name)));
+        genInterCode(IR_PARAM, newOperand(OP_VARIABLE, temp->name));
         // pInterCodes arg = newInterCodes(newInterCode(
         //     IR_PARAM, newOperand(OP_VARIABLE, newString(temp->name))));
         // addInterCode(interCodeList, arg);
@@ -700,11 +628,11 @@ void translateCompSt(pNode node) {
     if (interError) return;
     // CompSt -> LC DefList StmtList RC
     pNode temp = node->child->next;
-    if (!strcmp(temp->name, "DefList")) {
+    if (temp->symbol == SYM_DEF_LIST) {
         translateDefList(temp);
         temp = temp->next;
     }
-    if (!strcmp(temp->name, "StmtList")) {
+    if (temp->symbol == SYM_STMT_LIST) {
         translateStmtList(temp);
     }
 }
@@ -748,53 +676,40 @@ void translateDec(pNode node) {
     //      | VarDec ASSIGNOP Exp
 
     // Dec -> VarDec
-    if (node->child->next == NULL) {
-        translateVarDec(node->child, NULL);
+    if (node->prod == PROD_DEC) {
+        translateVarDec(node->child, NO_OPERAND);
     }
     // Dec -> VarDec ASSIGNOP Exp
     else {
-        pOperand t1 = newTemp();
+        OperandId t1 = newTemp();
         translateVarDec(node->child, t1);
-        pOperand t2 = newTemp();
+        OperandId t2 = newTemp();
         translateExp(node->child->next->next, t2);
         genInterCode(IR_ASSIGN, t1, t2);
     }
 }
 
-void translateVarDec(pNode node, pOperand place) {
+void translateVarDec(pNode node, OperandId place) {
     assert(node != NULL);
     if (interError) return;
     // VarDec -> ID
     //         | VarDec LB INT RB
 
-    if (!strcmp(node->child->name, "ID")) {
-        pItem temp = searchTableItem(table, node->child->val);
+    if (node->prod == PROD_VAR_DEC_ID) {
+        pItem temp = searchSymbol(node->child->val);
         pType type = temp->field->type;
         if (type->kind == BASIC) {
             if (place) {
-                interCodeList->tempVarNum--;
                 setOperand(place, OP_VARIABLE,
-                           (void*)newString(temp->field->name));
+                           (void*)temp->field->name);
             }
         } else if (type->kind == ARRAY) {
-            // 不需要完成高维数组情况
-            if (type->u.array.elem->kind == ARRAY) {
-                interError = TRUE;
-                printf(
-                    "Cannot translate: Code containsvariables of "
-                    "multi-dimensional array type or parameters of array "
-                    "type.\n");
-                return;
-            } else {
-                genInterCode(
-                    IR_DEC,
-                    newOperand(OP_VARIABLE, newString(temp->field->name)),
-                    getSize(type));
-            }
+            genInterCode(IR_DEC, newOperand(OP_VARIABLE, temp->field->name),
+                         getSize(type));
         } else if (type->kind == STRUCTURE) {
             // 3.1选做
             genInterCode(IR_DEC,
-                         newOperand(OP_VARIABLE, newString(temp->field->name)),
+                         newOperand(OP_VARIABLE, temp->field->name),
                          getSize(type));
         }
     } else {
@@ -822,64 +737,91 @@ void translateStmt(pNode node) {
     //       | IF LP Exp RP Stmt ELSE Stmt
     //       | WHILE LP Exp RP Stmt
 
-    // Stmt -> Exp SEMI
+    pNode exp = NULL, stmt = NULL;
+    OperandId t1 = NO_OPERAND, label1 = NO_OPERAND, label2 = NO_OPERAND,
+              label3 = NO_OPERAND;
+    switch (node->prod) {
+        // Stmt -> Exp SEMI
+        case PROD_STMT_EXP:
+            translateExp(node->child, NO_OPERAND);
+            break;
 
-    if (!strcmp(node->child->name, "Exp")) {
-        translateExp(node->child, NULL);
-    }
+        // Stmt -> CompSt
+        case PROD_STMT_COMP_ST:
+            translateCompSt(node->child);
+            break;
 
-    // Stmt -> CompSt
-    else if (!strcmp(node->child->name, "CompSt")) {
-        translateCompSt(node->child);
-    }
+        // Stmt -> RETURN Exp SEMI
+        case PROD_STMT_RETURN:
+            t1 = newTemp();
+            translateExp(node->child->next, t1);
+            genInterCode(IR_RETURN, t1);
+            break;
 
-    // Stmt -> RETURN Exp SEMI
-    else if (!strcmp(node->child->name, "RETURN")) {
-        pOperand t1 = newTemp();
-        translateExp(node->child->next, t1);
-        genInterCode(IR_RETURN, t1);
-    }
+        // Stmt -> IF LP Exp RP Stmt
+        //       | IF LP Exp RP Stmt ELSE Stmt
+        case PROD_STMT_IF:
+        case PROD_STMT_IF_ELSE:
+            exp = node->child->next->next;
+            stmt = exp->next->next;
+            label1 = newLabel();
+            label2 = newLabel();
+
+            translateCond(exp, label1, label2);
+            genInterCode(IR_LABEL, label1);
+            translateStmt(stmt);
+            if (node->prod == PROD_STMT_IF) {
+                genInterCode(IR_LABEL, label2);
+            } else {
+                label3 = newLabel();
+                genInterCode(IR_GOTO, label3);
+                genInterCode(IR_LABEL, label2);
+                translateStmt(stmt->next->next);
+                genInterCode(IR_LABEL, label3);
+            }
+            break;
 
-    // Stmt -> IF LP Exp RP Stmt
-    else if (!strcmp(node->child->name, "IF")) {
-        pNode exp = node->child->next->next;
-        pNode stmt = exp->next->next;
-        pOperand label1 = newLabel();
-        pOperand label2 = newLabel();
-
-        translateCond(exp, label1, label2);
-        genInterCode(IR_LABEL, label1);
-        translateStmt(stmt);
-        if (stmt->next == NULL) {
-            genInterCode(IR_LABEL, label2);
-        }
-        // Stmt -> IF LP Exp RP Stmt ELSE Stmt
-        else {
-            pOperand label3 = newLabel();
-            genInterCode(IR_GOTO, label3);
+        // Stmt -> WHILE LP Exp RP Stmt
+        case PROD_STMT_WHILE:
+            label1 = newLabel();
+            label2 = newLabel();
+            label3 = newLabel();
+
+            genInterCode(IR_LABEL, label1);
+            translateCond(node->child->next->next, label2, label3);
             genInterCode(IR_LABEL, label2);
-            translateStmt(stmt->next->next);
+            translateStmt(node->child->next->next->next->next);
+            genInterCode(IR_GOTO, label1);
             genInterCode(IR_LABEL, label3);
-        }
+            break;
 
+        default:
+            break;
     }
+}
 
-    // Stmt -> WHILE LP Exp RP Stmt
-    else if (!strcmp(node->child->name, "WHILE")) {
-        pOperand label1 = newLabel();
-        pOperand label2 = newLabel();
-        pOperand label3 = newLabel();
-
-        genInterCode(IR_LABEL, label1);
-        translateCond(node->child->next->next, label2, label3);
-        genInterCode(IR_LABEL, label2);
-        translateStmt(node->child->next->next->next->next);
-        genInterCode(IR_GOTO, label1);
-        genInterCode(IR_LABEL, label3);
+// 连续的下标a[i][j][k]按行优先合成一个元素序号((i * n1 + j) * n2 + k)，
+// 乘以最后一维的步长就是偏移。type返回最后一个下标所在的数组类型
+static OperandId translateIndex(pNode node, pType* type) {
+    OperandId idx = newTemp();
+    translateExp(node->child->next->next, idx);
+    if (node->child->prod != PROD_EXP_INDEX) {
+        *type = getExpType(node->child);
+        assert(*type != NULL && (*type)->kind == ARRAY);
+        return idx;
     }
+    OperandId outer = translateIndex(node->child, type);
+    *type = (*type)->u.array.elem;
+    assert((*type)->kind == ARRAY);
+    OperandId scaled = newTemp();
+    genInterCode(IR_MUL, scaled, outer,
+                 newOperand(OP_CONSTANT, (*type)->u.array.size));
+    OperandId sum = newTemp();
+    genInterCode(IR_ADD, sum, scaled, idx);
+    return sum;
 }
 
-void translateExp(pNode node, pOperand place) {
+void translateExp(pNode node, OperandId place) {
     assert(node != NULL);
     if (interError) return;
     // Exp -> Exp ASSIGNOP Exp
@@ -901,186 +843,123 @@ void translateExp(pNode node, pOperand place) {
     //      | INT
     //      | FLOAT
 
-    // Exp -> LP Exp RP
-    if (!strcmp(node->child->name, "LP"))
-        translateExp(node->child->next, place);
-
-    else if (!strcmp(node->child->name, "Exp") ||
-             !strcmp(node->child->name, "NOT")) {
-        // 条件表达式 和 基本表达式
-        if (strcmp(node->child->next->name, "LB") &&
-            strcmp(node->child->next->name, "DOT")) {
-            // Exp -> Exp AND Exp
-            //      | Exp OR Exp
-            //      | Exp RELOP Exp
-            //      | NOT Exp
-            if (!strcmp(node->child->next->name, "AND") ||
-                !strcmp(node->child->next->name, "OR") ||
-                !strcmp(node->child->next->name, "RELOP") ||
-                !strcmp(node->child->name, "NOT")) {
-                pOperand label1 = newLabel();
-                pOperand label2 = newLabel();
-                pOperand true_num = newOperand(OP_CONSTANT, 1);
-                pOperand false_num = newOperand(OP_CONSTANT, 0);
-                genInterCode(IR_ASSIGN, place, false_num);
-                translateCond(node, label1, label2);
-                genInterCode(IR_LABEL, label1);
-                genInterCode(IR_ASSIGN, place, true_num);
-            } else {
-                // Exp -> Exp ASSIGNOP Exp
-                if (!strcmp(node->child->next->name, "ASSIGNOP")) {
-                    pOperand t2 = newTemp();
-                    translateExp(node->child->next->next, t2);
-                    pOperand t1 = newTemp();
-                    translateExp(node->child, t1);
-                    genInterCode(IR_ASSIGN, t1, t2);
-                } else {
-                    pOperand t1 = newTemp();
-                    translateExp(node->child, t1);
-                    pOperand t2 = newTemp();
-                    translateExp(node->child->next->next, t2);
-                    // Exp -> Exp PLUS Exp
-                    if (!strcmp(node->child->next->name, "PLUS")) {
-                        genInterCode(IR_ADD, place, t1, t2);
-                    }
-                    // Exp -> Exp MINUS Exp
-                    else if (!strcmp(node->child->next->name, "MINUS")) {
-                        genInterCode(IR_SUB, place, t1, t2);
-                    }
-                    // Exp -> Exp STAR Exp
-                    else if (!strcmp(node->child->next->name, "STAR")) {
-                        genInterCode(IR_MUL, place, t1, t2);
-                    }
-                    // Exp -> Exp DIV Exp
-                    else if (!strcmp(node->child->next->name, "DIV")) {
-                        genInterCode(IR_DIV, place, t1, t2);
-                    }
-                }
-            }
+    // 表达式语句的值没人用，但翻译时仍需要一个落脚的操作数
+    boolean used = place != NO_OPERAND;
+    if (!used) place = newTemp();
+
+    OperandId t1 = NO_OPERAND, t2 = NO_OPERAND;
+    switch (node->prod) {
+        // Exp -> LP Exp RP
+        case PROD_EXP_PAREN:
+            translateExp(node->child->next, place);
+            break;
 
+        // 条件表达式
+        // Exp -> Exp AND Exp
+        //      | Exp OR Exp
+        //      | Exp RELOP Exp
+        //      | NOT Exp
+        case PROD_EXP_AND:
+        case PROD_EXP_OR:
+        case PROD_EXP_RELOP:
+        case PROD_EXP_NOT: {
+            OperandId label1 = newLabel();
+            OperandId label2 = newLabel();
+            OperandId true_num = newOperand(OP_CONSTANT, 1);
+            OperandId false_num = newOperand(OP_CONSTANT, 0);
+            genInterCode(IR_ASSIGN, place, false_num);
+            translateCond(node, label1, label2);
+            genInterCode(IR_LABEL, label1);
+            genInterCode(IR_ASSIGN, place, true_num);
+            genInterCode(IR_LABEL, label2);
+            break;
         }
-        // 数组和结构体访问
-        else {
-            // Exp -> Exp LB Exp RB
-            if (!strcmp(node->child->next->name, "LB")) {
-                //数组
-                if (node->child->child->next &&
-                    !strcmp(node->child->child->next, "LB")) {
-                    //多维数组，报错
-                    interError = TRUE;
-                    printf(
-                        "Cannot translate: Code containsvariables of "
-                        "multi-dimensional array type or parameters of array "
-                        "type.\n");
-                    return;
-                } else {
-                    pOperand idx = newTemp();
-                    translateExp(node->child->next->next, idx);
-                    pOperand base = newTemp();
-                    translateExp(node->child, base);
-
-                    pOperand width;
-                    pOperand offset = newTemp();
-                    pOperand target;
-                    // 根据假设，Exp1只会展开为 Exp DOT ID 或 ID
-                    // 我们让前一种情况吧ID作为name回填进place返回到这里的base处，在语义分析时将结构体变量也填进表（因为假设无重名），这样两种情况都可以查表得到。
-                    pItem item = searchTableItem(table, base->u.name);
-                    assert(item->field->type->kind == ARRAY);
-                    width = newOperand(
-                        OP_CONSTANT, getSize(item->field->type->u.array.elem));
-                    genInterCode(IR_MUL, offset, idx, width);
-                    // 如果是ID[Exp],
-                    // 则需要对ID取址，如果前面是结构体内访问，则会返回一个地址类型，不需要再取址
-                    if (base->kind == OP_VARIABLE) {
-                        // printf("非结构体数组访问\n");
-                        target = newTemp();
-                        genInterCode(IR_GET_ADDR, target, base);
-                    } else {
-                        // printf("结构体数组访问\n");
-                        target = base;
-                    }
-                    genInterCode(IR_ADD, place, target, offset);
-                    place->kind = OP_ADDRESS;
-                    interCodeList->lastArrayName = base->u.name;
-                }
+
+        // Exp -> Exp ASSIGNOP Exp
+        case PROD_EXP_ASSIGN:
+            t2 = newTemp();
+            translateExp(node->child->next->next, t2);
+            t1 = newTemp();
+            translateExp(node->child, t1);
+            genInterCode(IR_ASSIGN, t1, t2);
+            // 连续赋值 a = b = c 要把值再交给外层
+            if (used) genInterCode(IR_ASSIGN, place, t1);
+            break;
+
+        // 基本表达式
+        // Exp -> Exp PLUS Exp
+        //      | Exp MINUS Exp
+        //      | Exp STAR Exp
+        //      | Exp DIV Exp
+        case PROD_EXP_PLUS:
+        case PROD_EXP_MINUS:
+        case PROD_EXP_STAR:
+        case PROD_EXP_DIV:
+            t1 = newTemp();
+            translateExp(node->child, t1);
+            t2 = newTemp();
+            translateExp(node->child->next->next, t2);
+            switch (node->prod) {
+                case PROD_EXP_PLUS:
+                    genInterCode(IR_ADD, place, t1, t2);
+                    break;
+                case PROD_EXP_MINUS:
+                    genInterCode(IR_SUB, place, t1, t2);
+                    break;
+                case PROD_EXP_STAR:
+                    genInterCode(IR_MUL, place, t1, t2);
+                    break;
+                default:
+                    genInterCode(IR_DIV, place, t1, t2);
+                    break;
             }
-            // Exp -> Exp DOT ID
-            else {
-                //结构体
-                pOperand temp = newTemp();
-                translateExp(node->child, temp);
-                // 两种情况，Exp直接为一个变量，则需要先取址，若Exp为数组或者多层结构体访问或结构体形参，则target会被填成地址，可以直接用。
-                pOperand target;
-
-                if (temp->kind == OP_ADDRESS) {
-                    target = newOperand(temp->kind, temp->u.name);
-                    // target->isAddr = TRUE;
-                } else {
-                    target = newTemp();
-                    genInterCode(IR_GET_ADDR, target, temp);
-                }
+            break;
 
-                pOperand id = newOperand(
-                    OP_VARIABLE, newString(node->child->next->next->val));
-                int offset = 0;
-                pItem item = searchTableItem(table, temp->u.name);
-                //结构体数组，temp是临时变量，查不到表，需要用处理数组时候记录下的数组名老查表
-                if (item == NULL) {
-                    item = searchTableItem(table, interCodeList->lastArrayName);
-                }
+        // 数组访问，place里放元素的地址
+        // Exp -> Exp LB Exp RB
+        case PROD_EXP_INDEX: {
+            pType type = NULL;
+            OperandId idx = translateIndex(node, &type);
+            pNode array = node->child;
+            while (array->prod == PROD_EXP_INDEX) array = array->child;
+            OperandId base = translateAddr(array);
+            OperandId width = newOperand(OP_CONSTANT, type->u.array.width);
+            OperandId offset = newTemp();
+            genInterCode(IR_MUL, offset, idx, width);
+            genInterCode(IR_ADD, place, base, offset);
+            getOperand(place)->isAddr = TRUE;
+            break;
+        }
 
-                pFieldList tmp;
-                // 结构体数组 eg: a[5].b
-                if (item->field->type->kind == ARRAY) {
-                    tmp = item->field->type->u.array.elem->u.structure.field;
-                }
-                // 一般结构体
-                else {
-                    tmp = item->field->type->u.structure.field;
-                }
-                // 遍历获得offset
-                while (tmp) {
-                    if (!strcmp(tmp->name, id->u.name)) break;
-                    offset += getSize(tmp->type);
-                    tmp = tmp->tail;
-                }
+        // 结构体访问，place里放域的地址
+        // Exp -> Exp DOT ID
+        case PROD_EXP_DOT: {
+            pType type = getExpType(node->child);
+            assert(type != NULL && type->kind == STRUCTURE);
+            OperandId base = translateAddr(node->child);
+            // 偏移在结构体定义时就排好了
+            pFieldList field = searchField(type, node->child->next->next->val);
+            assert(field != NULL);
+            genInterCode(IR_ADD, place, base,
+                         newOperand(OP_CONSTANT, field->offset));
+            getOperand(place)->isAddr = TRUE;
+            break;
+        }
 
-                pOperand tOffset = newOperand(OP_CONSTANT, offset);
-                if (place) {
-                    genInterCode(IR_ADD, place, target, tOffset);
-                    // 为了处理结构体里的数组把id名通过place回传给上层
-                    setOperand(place, OP_ADDRESS, (void*)newString(id->u.name));
-                    // place->isAddr = TRUE;
-                }
-            }
+        //单目运算符
+        // Exp -> MINUS Exp
+        case PROD_EXP_NEG: {
+            t1 = newTemp();
+            translateExp(node->child->next, t1);
+            OperandId zero = newOperand(OP_CONSTANT, 0);
+            genInterCode(IR_SUB, place, zero, t1);
+            break;
         }
-    }
-    //单目运算符
-    // Exp -> MINUS Exp
-    else if (!strcmp(node->child->name, "MINUS")) {
-        pOperand t1 = newTemp();
-        translateExp(node->child->next, t1);
-        pOperand zero = newOperand(OP_CONSTANT, 0);
-        genInterCode(IR_SUB, place, zero, t1);
-    }
-    // // Exp -> NOT Exp
-    // else if (!strcmp(node->child->name, "NOT")) {
-    //     pOperand label1 = newLabel();
-    //     pOperand label2 = newLabel();
-    //     pOperand true_num = newOperand(OP_CONSTANT, 1);
-    //     pOperand false_num = newOperand(OP_CONSTANT, 0);
-    //     genInterCode(IR_ASSIGN, place, false_num);
-    //     translateCond(node, label1, label2);
-    //     genInterCode(IR_LABEL, label1);
-    //     genInterCode(IR_ASSIGN, place, true_num);
-    // }
-    // Exp -> ID LP Args RP
-    //		| ID LP RP
-    else if (!strcmp(node->child->name, "ID") && node->child->next) {
-        pOperand funcTemp =
-            newOperand(OP_FUNCTION, newString(node->child->val));
+
         // Exp -> ID LP Args RP
-        if (!strcmp(node->child->next->next->name, "Args")) {
+        case PROD_EXP_CALL_ARGS: {
+            OperandId funcTemp =
+                newOperand(OP_FUNCTION, node->child->val);
             pArgList argList = newArgList();
             translateArgs(node->child->next->next, argList);
             if (!strcmp(node->child->val, "write")) {
@@ -1088,77 +967,69 @@ void translateExp(pNode node, pOperand place) {
             } else {
                 pArg argTemp = argList->head;
                 while (argTemp) {
-                    if (argTemp->op == OP_VARIABLE) {
-                        pItem item =
-                            searchTableItem(table, argTemp->op->u.name);
-
-                        // 结构体作为参数需要传址
-                        if (item && item->field->type->kind == STRUCTURE) {
-                            pOperand varTemp = newTemp();
-                            genInterCode(IR_GET_ADDR, varTemp, argTemp->op);
-                            pOperand varTempCopy =
-                                newOperand(OP_ADDRESS, varTemp->u.name);
-                            // varTempCopy->isAddr = TRUE;
-                            genInterCode(IR_ARG, varTempCopy);
-                        }
-                    }
-                    // 一般参数直接传值
-                    else {
-                        genInterCode(IR_ARG, argTemp->op);
-                    }
+                    genInterCode(IR_ARG, argTemp->op);
                     argTemp = argTemp->next;
                 }
-                if (place) {
-                    genInterCode(IR_CALL, place, funcTemp);
-                } else {
-                    pOperand temp = newTemp();
-                    genInterCode(IR_CALL, temp, funcTemp);
-                }
+                genInterCode(IR_CALL, place, funcTemp);
             }
+            deleteArgList(argList);
+            break;
         }
+
         // Exp -> ID LP RP
-        else {
+        case PROD_EXP_CALL: {
+            OperandId funcTemp =
+                newOperand(OP_FUNCTION, node->child->val);
             if (!strcmp(node->child->val, "read")) {
                 genInterCode(IR_READ, place);
             } else {
-                if (place) {
-                    genInterCode(IR_CALL, place, funcTemp);
-                } else {
-                    pOperand temp = newTemp();
-                    genInterCode(IR_CALL, temp, funcTemp);
-                }
+                genInterCode(IR_CALL, place, funcTemp);
             }
-        }
-    }
-    // Exp -> ID
-    else if (!strcmp(node->child->name, "ID")) {
-        pItem item = searchTableItem(table, node->child->val);
-        // 根据讲义，因为结构体不允许赋值，结构体做形参时是传址的方式
-        interCodeList->tempVarNum--;
-        if (item->field->isArg && item->field->type->kind == STRUCTURE) {
-            setOperand(place, OP_ADDRESS, (void*)newString(node->child->val));
-            // place->isAddr = TRUE;
-        }
-        // 非结构体参数情况都当做变量处理
-        else {
-            setOperand(place, OP_VARIABLE, (void*)newString(node->child->val));
+            break;
         }
 
-        // pOperand t1 = newOperand(OP_VARIABLE, id_name->field->name);
-        // genInterCode(IR_ASSIGN, place, t1);
-    } else {
-        // // Exp -> FLOAT
-        // 无浮点数常数
-        // if (!strcmp(node->child->name, "FLOAT")) {
-        //     pOperand t1 = newOperand(OP_CONSTANT, node->child->val);
-        //     genInterCode(IR_ASSIGN, place, t1);
-        // }
+        // Exp -> ID
+        // 结构体变量只会经translateAddr取地址，这里都当做变量处理
+        case PROD_EXP_ID:
+            setOperand(place, OP_VARIABLE, (void*)node->child->val);
+            break;
 
         // Exp -> INT
-        interCodeList->tempVarNum--;
-        setOperand(place, OP_CONSTANT, (void*)atoi(node->child->val));
-        // pOperand t1 = newOperand(OP_CONSTANT, node->child->val);
-        // genInterCode(IR_ASSIGN, place, t1);
+        // 无浮点数常数
+        default:
+            setOperand(place, OP_CONSTANT, (void*)(long)atoi(node->child->val));
+            break;
+    }
+}
+
+// 左值表达式所指对象的地址，返回的操作数的值就是这个地址
+OperandId translateAddr(pNode node) {
+    assert(node != NULL);
+    switch (node->prod) {
+        // Exp -> LP Exp RP
+        case PROD_EXP_PAREN:
+            return translateAddr(node->child->next);
+
+        // Exp -> ID
+        case PROD_EXP_ID: {
+            pItem item = searchSymbol(node->child->val);
+            OperandId var = newOperand(OP_VARIABLE, node->child->val);
+            // 根据讲义，因为结构体不允许赋值，结构体和数组做形参时是传址的方式
+            if (item->field->isArg && item->field->type->kind != BASIC)
+                return var;
+            OperandId addr = newTemp();
+            genInterCode(IR_GET_ADDR, addr, var);
+            return addr;
+        }
+
+        // Exp -> Exp LB Exp RB
+        //      | Exp DOT ID
+        // 翻译结果本来就是地址，换一个不带isAddr的同号临时变量当值用
+        default: {
+            OperandId addr = newTemp();
+            translateExp(node, addr);
+            return newOperand(OP_TEMP, getOperand(addr)->u.no);
+        }
     }
 }
 
@@ -1167,7 +1038,7 @@ void translateExp(pNode node, pOperand place) {
  * 根据条件表达式的结果，该函数产生IR_IF_GOTO、IR_GOTO等跳转指令，
  * 从而实现条件分支的控制流（辨别真假分支并跳转到对应标签）。
  */
-void translateCond(pNode node, pOperand labelTrue, pOperand labelFalse) {
+void translateCond(pNode node, OperandId labelTrue, OperandId labelFalse) {
     assert(node != NULL);
     if (interError) return;
     // Exp -> Exp AND Exp
@@ -1175,54 +1046,68 @@ void translateCond(pNode node, pOperand labelTrue, pOperand labelFalse) {
     //      | Exp RELOP Exp
     //      | NOT Exp
 
-    // Exp -> NOT Exp
-    if (!strcmp(node->child->name, "NOT")) {
-        translateCond(node->child->next, labelFalse, labelTrue);
-    }
-    else if (!strcmp(node->child->next->name, "RELOP")) {
-        pOperand t1 = newTemp();
-        pOperand t2 = newTemp();
-        translateExp(node->child, t1);
-        translateExp(node->child->next->next, t2);
+    switch (node->prod) {
+        // Exp -> NOT Exp
+        case PROD_EXP_NOT:
+            translateCond(node->child->next, labelFalse, labelTrue);
+            break;
+
+        // Exp -> Exp RELOP Exp
+        case PROD_EXP_RELOP: {
+            OperandId t1 = newTemp();
+            OperandId t2 = newTemp();
+            translateExp(node->child, t1);
+            translateExp(node->child->next->next, t2);
+
+            OperandId relop =
+                newOperand(OP_RELOP, getRelop(node->child->next->val));
+            if (getOperand(t1)->isAddr) {
+                OperandId temp = newTemp();
+                genInterCode(IR_READ_ADDR, temp, t1);
+                t1 = temp;
+            }
+            if (getOperand(t2)->isAddr) {
+                OperandId temp = newTemp();
+                genInterCode(IR_READ_ADDR, temp, t2);
+                t2 = temp;
+            }
+            genInterCode(IR_IF_GOTO, t1, relop, t2, labelTrue);
+            genInterCode(IR_GOTO, labelFalse);
+            break;
+        }
 
-        pOperand relop = newOperand(OP_RELOP, newString(node->child->next->val));
-        if (t1->kind == OP_ADDRESS) {
-            pOperand temp = newTemp();
-            genInterCode(IR_READ_ADDR, temp, t1);
-            t1 = temp;
+        // Exp -> Exp AND Exp
+        case PROD_EXP_AND: {
+            OperandId label1 = newLabel();
+            translateCond(node->child, label1, labelFalse);
+            genInterCode(IR_LABEL, label1);
+            translateCond(node->child->next->next, labelTrue, labelFalse);
+            break;
         }
-        if (t2->kind == OP_ADDRESS) {
-            pOperand temp = newTemp();
-            genInterCode(IR_READ_ADDR, temp, t2);
-            t2 = temp;
+
+        // Exp -> Exp OR Exp
+        case PROD_EXP_OR: {
+            OperandId label1 = newLabel();
+            translateCond(node->child, labelTrue, label1);
+            genInterCode(IR_LABEL, label1);
+            translateCond(node->child->next->next, labelTrue, labelFalse);
+            break;
         }
-        genInterCode(IR_IF_GOTO, t1, relop, t2, labelTrue);
-        genInterCode(IR_GOTO, labelFalse);
-    }
-    else if (!strcmp(node->child->next->name, "AND")) {
-        pOperand label1 = newLabel();
-        translateCond(node->child, label1, labelFalse);
-        genInterCode(IR_LABEL, label1);
-        translateCond(node->child->next->next, labelTrue, labelFalse);
-    }
-    else if (!strcmp(node->child->next->name, "OR")) {
-        pOperand label1 = newLabel();
-        translateCond(node->child, labelTrue, label1);
-        genInterCode(IR_LABEL, label1);
-        translateCond(node->child->next->next, labelTrue, labelFalse);
-    }
-    else {
-        pOperand t1 = newTemp();
-        translateExp(node, t1);
-        pOperand t2 = newOperand(OP_CONSTANT, 0);
-        pOperand relop = newOperand(OP_RELOP, newString("!="));
-        if (t1->kind == OP_ADDRESS) {
-            pOperand temp = newTemp();
-            genInterCode(IR_READ_ADDR, temp, t1);
-            t1 = temp;
+
+        default: {
+            OperandId t1 = newTemp();
+            translateExp(node, t1);
+            OperandId t2 = newOperand(OP_CONSTANT, 0);
+            OperandId relop = newOperand(OP_RELOP, RELOP_NE);
+            if (getOperand(t1)->isAddr) {
+                OperandId temp = newTemp();
+                genInterCode(IR_READ_ADDR, temp, t1);
+                t1 = temp;
+            }
+            genInterCode(IR_IF_GOTO, t1, relop, t2, labelTrue);
+            genInterCode(IR_GOTO, labelFalse);
+            break;
         }
-        genInterCode(IR_IF_GOTO, t1, relop, t2, labelTrue);
-        genInterCode(IR_GOTO, labelFalse);
     }
 }
 
@@ -1234,19 +1119,16 @@ void translateArgs(pNode node, pArgList argList) {
     //       | Exp
 
     // Args -> Exp
-    pArg temp = newArg(newTemp());
-    translateExp(node->child, temp->op);
-
-    if (temp->op->kind == OP_VARIABLE) {
-        pItem item = searchTableItem(table, temp->op->u.name);
-        if (item && item->field->type->kind == ARRAY) {
-            interError = TRUE;
-            printf(
-                "Cannot translate: Code containsvariables of "
-                "multi-dimensional array type or parameters of array "
-                "type.\n");
-            return;
-        }
+    pType type = getExpType(node->child);
+    pArg temp;
+    // 结构体和数组作为参数需要传址
+    if (type != NULL && (type->kind == STRUCTURE || type->kind == ARRAY)) {
+        temp = newArg(translateAddr(node->child));
+    }
+    // 一般参数直接传值
+    else {
+        temp = newArg(newTemp());
+        translateExp(node->child, temp->op);
     }
     addArg(argList, temp);
 
@@ -5,29 +5,45 @@
 
 typedef struct _operand* pOperand;
 typedef struct _interCode* pInterCode;
-typedef struct _interCodes* pInterCodes;
 typedef struct _arg* pArg;
 typedef struct _argList* pArgList;
 typedef struct _interCodeList* pInterCodeList;
 
+// 操作数在操作数表里的下标，0号保留表示“没有操作数”
+typedef unsigned OperandId;
+#define NO_OPERAND 0
+
+typedef enum _relop {
+    RELOP_LT,
+    RELOP_LE,
+    RELOP_GT,
+    RELOP_GE,
+    RELOP_EQ,
+    RELOP_NE,
+} Relop;
+
+// 临时变量和标签只存编号，名字在打印时才生成
 typedef struct _operand {
     enum {
-        OP_VARIABLE,
-        OP_CONSTANT,
-        OP_ADDRESS,
-        OP_LABEL,
-        OP_FUNCTION,
-        OP_RELOP,
+        OP_VARIABLE,  // 源程序变量，u.name
+        OP_TEMP,      // 临时变量，u.no
+        OP_CONSTANT,  // 立即数，u.value
+        OP_LABEL,     // 标签，u.no
+        OP_FUNCTION,  // 函数名，u.name
+        OP_RELOP,     // 比较运算符，u.relop
     } kind;
 
+    boolean isAddr;  // 存的是地址，当值用时要先取*
+
     union {
         int value;
+        int no;
+        Relop relop;
         char* name;
     } u;
-
-    // boolean isAddr;
 } Operand;
 
+// 定长的指令记录，连续存放在InterCodeList的数组里
 typedef struct _interCode {
     enum {
         IR_LABEL,      // 标签指令：标记基本块的起始位置
@@ -53,31 +69,26 @@ typedef struct _interCode {
 
     union {
         struct {
-            pOperand op;
+            OperandId op;
         } oneOp;
         struct {
-            pOperand right, left;
+            OperandId right, left;
         } assign;
         struct {
-            pOperand result, op1, op2;
+            OperandId result, op1, op2;
         } binOp;
         struct {
-            pOperand x, relop, y, z;
+            OperandId x, relop, y, z;
         } ifGoto;
         struct {
-            pOperand op;
+            OperandId op;
             int size;
         } dec;
     } u;
 } InterCode;
 
-typedef struct _interCodes {
-    pInterCode code;
-    pInterCodes *prev, *next;
-} InterCodes;
-
 typedef struct _arg {
-    pOperand op;
+    OperandId op;
     pArg next;
 } Arg;
 
@@ -87,9 +98,13 @@ typedef struct _argList {
 } ArgList;
 
 typedef struct _interCodeList {
-    pInterCodes head;
-    pInterCodes cur;
-    char* lastArrayName;  // 针对结构体数组，因为需要数组名查表
+    pInterCode codes;     // 指令数组
+    int codeNum;
+    int codeCap;
+    pOperand operands;    // 操作数表，指令里只存下标
+    int operandNum;
+    int operandCap;
+    pItem curFunc;        // 正在翻译的函数，局部变量从它的符号表里查
     int tempVarNum;
     int labelNum;
 } InterCodeList;
@@ -98,22 +113,30 @@ extern boolean interError;
 extern pInterCodeList interCodeList;
 
 // Operand func
-pOperand newOperand(int kind, ...);
-void deleteOperand(pOperand p);
-void setOperand(pOperand p, int kind, void* val);
-void printOp(FILE* fp, pOperand op);
+OperandId newOperand(int kind, ...);
+void setOperand(OperandId id, int kind, void* val);
+Relop getRelop(char* name);
+char* relopName(Relop relop);
+
+// 操作数表可能扩容，取出的指针不要跨newOperand保存
+static inline pOperand getOperand(OperandId id) {
+    assert(id != NO_OPERAND);
+    return &interCodeList->operands[id];
+}
+
+static inline boolean isTemp(OperandId id) {
+    return id != NO_OPERAND && getOperand(id)->kind == OP_TEMP;
+}
 
 // InterCode func
-pInterCode newInterCode(int kind, ...);
-void deleteInterCode(pInterCode p);
+pInterCode newInterCode(int kind);
+int getUseSlots(pInterCode code, OperandId* slots[3]);
+OperandId* getDefSlot(pInterCode code);
+OperandId getDef(pInterCode code);
 void printInterCode(FILE* fp, pInterCodeList interCodeList);
 
-// InterCodes func
-pInterCodes newInterCodes(pInterCode code);
-void deleteInterCodes(pInterCodes p);
-
 // Arg and ArgList func
-pArg newArg(pOperand op);
+pArg newArg(OperandId op);
 pArgList newArgList();
 void deleteArg(pArg p);
 void deleteArgList(pArgList p);
@@ -122,18 +145,17 @@ void addArg(pArgList argList, pArg arg);
 // InterCodeList func
 pInterCodeList newInterCodeList();
 void deleteInterCodeList(pInterCodeList p);
-void addInterCode(pInterCodeList interCodeList, pInterCodes newCode);
 
 // traverse func
-pOperand newTemp();
-pOperand newLabel();
-int getSize(pType type);
+OperandId newTemp();
+OperandId newLabel();
 void genInterCodes(pNode node);
 void genInterCode(int kind, ...);
-void translateExp(pNode node, pOperand place);
+void translateExp(pNode node, OperandId place);
+OperandId translateAddr(pNode node);
 void translateArgs(pNode node, pArgList argList);
-void translateCond(pNode node, pOperand labelTrue, pOperand labelFalse);
-void translateVarDec(pNode node, pOperand place);
+void translateCond(pNode node, OperandId labelTrue, OperandId labelFalse);
+void translateVarDec(pNode node, OperandId place);
 void translateDec(pNode node);
 void translateDecList(pNode node);
 void translateDef(pNode node);
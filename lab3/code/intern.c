@@ -0,0 +1,97 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "node.h"
+
+#define INTERN_INIT_SIZE 1024
+
+typedef struct internEntry* pInternEntry;
+
+typedef struct internEntry {
+    pInternEntry next;  // same hash bucket next entry
+    unsigned hash;      // 预先算好的哈希值，符号表直接使用
+    char str[];
+} InternEntry;
+
+typedef struct internTable {
+    pInternEntry* buckets;
+    unsigned size;  // 桶数，总是2的幂
+    unsigned count;
+    Arena arena;    // 所有名字都从这里分配
+} InternTable;
+
+static InternTable internTable;
+
+#define FX_SEED 0x517cc1b727220a95ull
+
+static inline uint64_t fxAdd(uint64_t hash, uint64_t word) {
+    return (((hash << 5) | (hash >> 59)) ^ word) * FX_SEED;
+}
+
+// FxHash：一次吃一个8字节的字，比逐字节的FNV快得多。
+// 乘法的低位只受输入低位影响，取混合充分的高32位
+static unsigned hashString(char* str, size_t length) {
+    uint64_t hash = 0, word;
+    for (; length >= 8; str += 8, length -= 8) {
+        memcpy(&word, str, 8);
+        hash = fxAdd(hash, word);
+    }
+    if (length) {
+        word = 0;
+        memcpy(&word, str, length);
+        hash = fxAdd(hash, word);
+    }
+    return (unsigned)(hash >> 32);
+}
+
+static inline pInternEntry getEntry(char* name) {
+    return (pInternEntry)(name - offsetof(InternEntry, str));
+}
+
+static void growInternTable() {
+    unsigned newSize =
+        internTable.size ? internTable.size * 2 : INTERN_INIT_SIZE;
+    pInternEntry* newBuckets =
+        (pInternEntry*)calloc(newSize, sizeof(pInternEntry));
+    assert(newBuckets != NULL);
+    for (unsigned i = 0; i < internTable.size; i++) {
+        pInternEntry p = internTable.buckets[i];
+        while (p) {
+            pInternEntry temp = p->next;
+            p->next = newBuckets[p->hash & (newSize - 1)];
+            newBuckets[p->hash & (newSize - 1)] = p;
+            p = temp;
+        }
+    }
+    free(internTable.buckets);
+    internTable.buckets = newBuckets;
+    internTable.size = newSize;
+}
+
+char* intern(char* str) {
+    assert(str != NULL);
+    if (internTable.count >= internTable.size) growInternTable();
+    size_t length = strlen(str);
+    unsigned hash = hashString(str, length);
+    pInternEntry* head = &internTable.buckets[hash & (internTable.size - 1)];
+    for (pInternEntry p = *head; p != NULL; p = p->next) {
+        if (p->hash == hash && !strcmp(p->str, str)) return p->str;
+    }
+    pInternEntry p = (pInternEntry)arenaAlloc(
+        &internTable.arena, offsetof(InternEntry, str) + length + 1);
+    p->hash = hash;
+    memcpy(p->str, str, length + 1);
+    p->next = *head;
+    *head = p;
+    internTable.count++;
+    return p->str;
+}
+
+unsigned internHash(char* name) { return getEntry(name)->hash; }
+
+void deleteInterner() {
+    free(internTable.buckets);
+    internTable.buckets = NULL;
+    internTable.size = 0;
+    internTable.count = 0;
+    arenaFree(&internTable.arena);
+}
@@ -0,0 +1,12 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+// 标识符驻留表：每个不同的名字只保存一份，intern返回的指针就是名字的句柄。
+// 同名句柄一定相同，符号表和中间代码可以直接用 == 比较名字，不必strcmp，
+// 句柄在整个编译过程中有效，任何人都不应free它。
+
+char* intern(char* str);
+unsigned internHash(char* name);
+void deleteInterner();
+
+#endif
@@ -851,137 +851,137 @@ YY_RULE_SETUP
 case 3:
 YY_RULE_SETUP
 #line 53 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "IF", yytext); return IF; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_IF, yytext); return IF; }
 	YY_BREAK
 case 4:
 YY_RULE_SETUP
 #line 54 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "ELSE", yytext); return ELSE; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_ELSE, yytext); return ELSE; }
 	YY_BREAK
 case 5:
 YY_RULE_SETUP
 #line 55 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "WHILE", yytext); return WHILE; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_WHILE, yytext); return WHILE; }
 	YY_BREAK
 case 6:
 YY_RULE_SETUP
 #line 56 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_TYPE, "TYPE", yytext); return TYPE; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_TYPE, SYM_TYPE, yytext); return TYPE; }
 	YY_BREAK
 case 7:
 YY_RULE_SETUP
 #line 57 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "STRUCT", yytext); return STRUCT; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_STRUCT, yytext); return STRUCT; }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
 #line 58 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "RETURN", yytext); return RETURN; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_RETURN, yytext); return RETURN; }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
 #line 59 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "RELOP", yytext); return RELOP; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_RELOP, yytext); return RELOP; }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
 #line 61 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "PLUS", yytext); return PLUS; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_PLUS, yytext); return PLUS; }
 	YY_BREAK
 case 11:
 YY_RULE_SETUP
 #line 62 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "MINUS", yytext); return MINUS; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_MINUS, yytext); return MINUS; }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
 #line 63 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "STAR", yytext); return STAR; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_STAR, yytext); return STAR; }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
 #line 64 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "DIV", yytext); return DIV; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_DIV, yytext); return DIV; }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
 #line 65 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "AND", yytext); return AND; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_AND, yytext); return AND; }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
 #line 66 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "OR", yytext); return OR; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_OR, yytext); return OR; }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
 #line 67 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "NOT", yytext); return NOT; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_NOT, yytext); return NOT; }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
 #line 69 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "DOT", yytext); return DOT; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_DOT, yytext); return DOT; }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
 #line 70 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "SEMI", yytext); return SEMI; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_SEMI, yytext); return SEMI; }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
 #line 71 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "COMMA", yytext); return COMMA; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_COMMA, yytext); return COMMA; }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
 #line 72 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "ASSIGNOP", yytext); return ASSIGNOP; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_ASSIGNOP, yytext); return ASSIGNOP; }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
 #line 74 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "LP", yytext); return LP; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_LP, yytext); return LP; }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
 #line 75 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "RP", yytext); return RP; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_RP, yytext); return RP; }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
 #line 76 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "LB", yytext); return LB; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_LB, yytext); return LB; }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
 #line 77 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "RB", yytext); return RB; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_RB, yytext); return RB; }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
 #line 78 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "LC", yytext); return LC; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_LC, yytext); return LC; }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
 #line 79 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, "RC", yytext); return RC; }
+{ yylval.node = newTokenNode(yylineno, TOKEN_OTHER, SYM_RC, yytext); return RC; }
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
 #line 81 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_ID, "ID", yytext); return ID;}
+{ yylval.node = newTokenNode(yylineno, TOKEN_ID, SYM_ID, intern(yytext)); return ID;}
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
 #line 82 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_INT, "INT", yytext); return INT;}
+{ yylval.node = newTokenNode(yylineno, TOKEN_INT, SYM_INT, yytext); return INT;}
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
 #line 83 "./lexical.l"
-{ yylval.node = newTokenNode(yylineno, TOKEN_FLOAT, "FLOAT", yytext); return FLOAT;}
+{ yylval.node = newTokenNode(yylineno, TOKEN_FLOAT, SYM_FLOAT, yytext); return FLOAT;}
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
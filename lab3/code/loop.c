@@ -0,0 +1,615 @@
+#include "cfg.h"
+#include "optimize.h"
+
+// 循环优化：不变量外提和强度削弱。
+// 要搬出循环的指令都放进前置块：插在循环头的标签之前，循环外跳到头的跳转
+// 改跳到前置块新开的标签上。新指令先记下来，一遍做完再一次合并进指令数组
+typedef struct _insertion {
+    int pos;    // 插在原指令数组的这个下标之前
+    int order;  // 同一位置上，归纳变量的更新排在前置块之前
+    int seq;
+    InterCode code;
+} Insertion;
+
+static Insertion* inserts;
+static int insertNum, insertCap;
+static int* hoistLoop;  // 指令下标 -> 搬到了哪个循环的前置块，-1表示没搬
+
+static pCfg curCfg;
+static int curFunc;      // 函数的编号，函数里第l个循环的编号是curFunc + 1 + l
+static int stampNum;     // 用过的最大编号
+static int* preState;    // 每个循环：0没看过，1可以建前置块，-1不行
+static OperandId* preLabel;
+
+static int* funcStamp;   // 下面几项所属的函数
+static int* funcDefs;    // 函数内的定值次数
+static int* funcUses;
+static int* decBlock;    // DEC所在的块
+static int* loopStamp;   // 下面几项所属的循环
+static int* loopDefs;    // 循环内的定值次数
+static int* loopIncs;    // 其中 i := i + c 形式的次数
+
+static pInterCode addInsertion(int pos, int order, int kind) {
+    if (insertNum == insertCap) {
+        insertCap = insertCap ? insertCap * 2 : 64;
+        inserts = (Insertion*)realloc(inserts, sizeof(Insertion) * insertCap);
+        assert(inserts != NULL);
+    }
+    Insertion* p = &inserts[insertNum];
+    p->pos = pos;
+    p->order = order;
+    p->seq = insertNum++;
+    p->code.kind = kind;
+    return &p->code;
+}
+
+static int compareInsertion(const void* a, const void* b) {
+    const Insertion *x = (const Insertion*)a, *y = (const Insertion*)b;
+    if (x->pos != y->pos) return x->pos - y->pos;
+    if (x->order != y->order) return x->order - y->order;
+    return x->seq - y->seq;
+}
+
+static void beginLoopPass(pInterCodeList list) {
+    int n = valueNum;
+    funcStamp = (int*)calloc(n, sizeof(int));
+    funcDefs = (int*)malloc(sizeof(int) * n);
+    funcUses = (int*)malloc(sizeof(int) * n);
+    decBlock = (int*)malloc(sizeof(int) * n);
+    loopStamp = (int*)calloc(n, sizeof(int));
+    loopDefs = (int*)malloc(sizeof(int) * n);
+    loopIncs = (int*)malloc(sizeof(int) * n);
+    hoistLoop = (int*)malloc(sizeof(int) * (list->codeNum + 1));
+    assert(funcStamp && funcDefs && funcUses && decBlock && loopStamp &&
+           loopDefs && loopIncs && hoistLoop);
+    for (int i = 0; i < list->codeNum; i++) hoistLoop[i] = -1;
+    insertNum = 0;
+    stampNum = 0;
+}
+
+// 把记下的新指令合并进去，搬走的指令删掉
+static void endLoopPass(pInterCodeList list) {
+    if (insertNum) {
+        qsort(inserts, insertNum, sizeof(Insertion), compareInsertion);
+        int cap = list->codeNum + insertNum;
+        pInterCode codes = (pInterCode)malloc(sizeof(InterCode) * cap);
+        assert(codes != NULL);
+        int out = 0, k = 0;
+        for (int i = 0; i <= list->codeNum; i++) {
+            while (k < insertNum && inserts[k].pos == i)
+                codes[out++] = inserts[k++].code;
+            if (i < list->codeNum && hoistLoop[i] < 0)
+                codes[out++] = list->codes[i];
+        }
+        free(list->codes);
+        list->codes = codes;
+        list->codeNum = out;
+        list->codeCap = cap;
+    }
+    free(funcStamp);
+    free(funcDefs);
+    free(funcUses);
+    free(decBlock);
+    free(loopStamp);
+    free(loopDefs);
+    free(loopIncs);
+    free(hoistLoop);
+    free(inserts);
+    inserts = NULL;
+    insertCap = 0;
+}
+
+static void countInFunction(int v) {
+    if (funcStamp[v] == curFunc) return;
+    funcStamp[v] = curFunc;
+    funcDefs[v] = funcUses[v] = 0;
+    decBlock[v] = -1;
+}
+
+// 建好函数的控制流图并统计定值、使用和DEC的位置，没有循环时返回NULL
+static pCfg beginFunction(pInterCodeList list, int start) {
+    pCfg cfg = newCfg(list, start);
+    if (cfg->loopNum == 0) {
+        deleteCfg(cfg);
+        return NULL;
+    }
+    curCfg = cfg;
+    curFunc = ++stampNum;
+    stampNum += cfg->loopNum;
+    OperandId* slots[3];
+    forEachBlock(cfg, b) {
+        forEachCode(cfg, b, code) {
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int v = valueIndex(*slots[j]);
+                if (v < 0) continue;
+                countInFunction(v);
+                funcUses[v]++;
+            }
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            if (v >= 0) {
+                countInFunction(v);
+                funcDefs[v]++;
+            }
+            if (code->kind == IR_DEC) {
+                v = valueIndex(code->u.dec.op);
+                countInFunction(v);
+                decBlock[v] = b;
+            }
+        }
+    }
+    preState = (int*)calloc(cfg->loopNum, sizeof(int));
+    preLabel = (OperandId*)calloc(cfg->loopNum, sizeof(OperandId));
+    assert(preState != NULL && preLabel != NULL);
+    return cfg;
+}
+
+static void endFunction(pCfg cfg) {
+    free(preState);
+    free(preLabel);
+    deleteCfg(cfg);
+}
+
+static int loopId(int l) { return curFunc + 1 + l; }
+
+// DEC在循环里的数组每轮地址都不同
+static boolean isInvariantAddr(OperandId var, int l) {
+    int x = valueIndex(var);
+    return funcStamp[x] != curFunc || decBlock[x] < 0 ||
+           !inLoop(curCfg, decBlock[x], l);
+}
+
+// 循环头前面能不能插前置块：头以标签开始，顺序流进头的前一块在循环外
+static boolean canPreheader(pCfg cfg, int l) {
+    if (preState[l]) return preState[l] > 0;
+    int h = cfg->loops[l].header;
+    preState[l] = -1;
+    if (cfg->list->codes[cfg->blocks[h].first].kind != IR_LABEL) return FALSE;
+    if (h > 0 && inLoop(cfg, h - 1, l)) {
+        int kind = cfg->list->codes[cfg->blocks[h - 1].last - 1].kind;
+        if (kind != IR_GOTO && kind != IR_RETURN) return FALSE;
+    }
+    preState[l] = 1;
+    return TRUE;
+}
+
+// 返回前置块的插入位置，第一次用时把循环外跳到头的跳转改到新标签上
+static int openPreheader(pCfg cfg, int l) {
+    int h = cfg->loops[l].header;
+    int pos = cfg->blocks[h].first;
+    if (preLabel[l] != NO_OPERAND) return pos;
+    pInterCode codes = cfg->list->codes;
+    int head = labelNo(codes[pos].u.oneOp.op);
+    forEachPred(cfg, h, p) {
+        if (inLoop(cfg, p, l)) continue;
+        OperandId* target = jumpTarget(&codes[cfg->blocks[p].last - 1]);
+        if (target == NULL || labelNo(*target) != head) continue;
+        if (preLabel[l] == NO_OPERAND) {
+            preLabel[l] = newLabel();
+            addInsertion(pos, 1, IR_LABEL)->u.oneOp.op = preLabel[l];
+        }
+        *target = preLabel[l];
+    }
+    // 没有要改的跳转也记一下，免得下次再找
+    if (preLabel[l] == NO_OPERAND) preLabel[l] = codes[pos].u.oneOp.op;
+    return pos;
+}
+
+static int compareRpo(const void* a, const void* b) {
+    return curCfg->blocks[*(const int*)a].rpo -
+           curCfg->blocks[*(const int*)b].rpo;
+}
+
+// 循环里可达的块按逆后序放进order，定值总在使用之前看到
+static int sortLoopBlocks(pCfg cfg, int l, int* order) {
+    pLoop loop = &cfg->loops[l];
+    int blockNum = 0;
+    for (int i = 0; i < loop->blockNum; i++)
+        if (cfg->blocks[loop->blocks[i]].rpo >= 0)
+            order[blockNum++] = loop->blocks[i];
+    qsort(order, blockNum, sizeof(int), compareRpo);
+    return blockNum;
+}
+
+static boolean getIncrement(pInterCode code, unsigned* delta) {
+    if (code->kind != IR_ADD && code->kind != IR_SUB) return FALSE;
+    int v = valueIndex(code->u.binOp.result);
+    pOperand op1 = getOperand(code->u.binOp.op1);
+    pOperand op2 = getOperand(code->u.binOp.op2);
+    if (valueIndex(code->u.binOp.op1) == v && op2->kind == OP_CONSTANT) {
+        *delta = code->kind == IR_ADD ? (unsigned)op2->u.value
+                                      : 0u - (unsigned)op2->u.value;
+        return TRUE;
+    }
+    if (code->kind == IR_ADD && op1->kind == OP_CONSTANT &&
+        valueIndex(code->u.binOp.op2) == v) {
+        *delta = (unsigned)op1->u.value;
+        return TRUE;
+    }
+    return FALSE;
+}
+
+// 数循环里每个名字的定值，incPos不为空时顺便记下 i := i + c 的位置
+static int countLoopDefs(pCfg cfg, int l, int* order, int blockNum,
+                         int* incPos) {
+    int id = loopId(l), incNum = 0;
+    for (int i = 0; i < blockNum; i++) {
+        forEachCode(cfg, order[i], code) {
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            if (v < 0) continue;
+            if (loopStamp[v] != id) {
+                loopStamp[v] = id;
+                loopDefs[v] = loopIncs[v] = 0;
+            }
+            loopDefs[v]++;
+            unsigned delta;
+            if (incPos && getIncrement(code, &delta)) {
+                loopIncs[v]++;
+                incPos[incNum++] = code - cfg->list->codes;
+            }
+        }
+    }
+    return incNum;
+}
+
+// 循环不变量外提。循环里的纯计算，操作数都是常量、循环里没有定值的名字
+// 或者已经搬出去的临时变量，就整条搬进前置块。结果必须是只定值一次的
+// 临时变量，搬走以后它的定值仍然支配所有的使用。循环一次都不执行时
+// 前置块也会执行，所以除法只搬除数是非零常量的，读内存不搬。
+// 外层循环先做，每条指令一次搬到它不变的最外层
+static int* movedStamp;  // 搬出去的临时变量 -> 搬到了哪个循环
+static int* movedLoop;
+
+static boolean isInvariant(OperandId id, int l) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT) return TRUE;
+    int v = valueIndex(id);
+    if (v < 0) return FALSE;
+    if (loopStamp[v] != loopId(l)) return TRUE;
+    return movedStamp[v] == curFunc &&
+           inLoop(curCfg, curCfg->loops[l].header, movedLoop[v]);
+}
+
+static boolean canHoist(pInterCode code, int l) {
+    switch (code->kind) {
+        case IR_ASSIGN:
+            return isInvariant(code->u.assign.right, l);
+        case IR_GET_ADDR:
+            return isInvariantAddr(code->u.assign.right, l);
+        case IR_DIV: {
+            pOperand y = getOperand(code->u.binOp.op2);
+            if (y->kind != OP_CONSTANT || y->u.value == 0 || y->u.value == -1)
+                return FALSE;
+        }
+        // fall through
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+            return isInvariant(code->u.binOp.op1, l) &&
+                   isInvariant(code->u.binOp.op2, l);
+        default:
+            return FALSE;
+    }
+}
+
+int hoistInvariants(pInterCodeList list) {
+    beginLoopPass(list);
+    movedStamp = (int*)calloc(valueNum, sizeof(int));
+    movedLoop = (int*)malloc(sizeof(int) * valueNum);
+    assert(movedStamp != NULL && movedLoop != NULL);
+
+    int hoisted = 0;
+    for (int start = 0; start < list->codeNum;
+         start = nextFunction(list, start)) {
+        if (list->codes[start].kind != IR_FUNCTION) continue;
+        pCfg cfg = beginFunction(list, start);
+        if (cfg == NULL) continue;
+        int* order = (int*)malloc(sizeof(int) * cfg->blockNum);
+        assert(order != NULL);
+        for (int l = 0; l < cfg->loopNum; l++) {
+            if (!canPreheader(cfg, l)) continue;
+            int blockNum = sortLoopBlocks(cfg, l, order);
+            countLoopDefs(cfg, l, order, blockNum, NULL);
+            for (int k = 0; k < blockNum; k++) {
+                forEachCode(cfg, order[k], code) {
+                    int i = code - list->codes;
+                    OperandId def = getDef(code);
+                    if (hoistLoop[i] >= 0 || !isTemp(def) ||
+                        funcDefs[valueIndex(def)] != 1 || !canHoist(code, l))
+                        continue;
+                    int pos = openPreheader(cfg, l);
+                    *addInsertion(pos, 1, code->kind) = list->codes[i];
+                    hoistLoop[i] = l;
+                    movedStamp[valueIndex(def)] = curFunc;
+                    movedLoop[valueIndex(def)] = l;
+                    hoisted++;
+                }
+            }
+        }
+        free(order);
+        endFunction(cfg);
+    }
+
+    free(movedStamp);
+    free(movedLoop);
+    endLoopPass(list);
+    if (optStats) fprintf(stderr, "licm: %d hoisted\n", hoisted);
+    return hoisted;
+}
+
+// 强度削弱。数组访问翻译成 t1 := &a; t2 := i * #4; t3 := t1 + t2，外提把
+// 取址搬走以后循环里每轮还要做一次乘法。i 在循环里只有 i := i + c 这种定值时
+// 是基本归纳变量，由它乘常数、加减循环不变量得到的临时变量 j = k*i + b
+// 换成新变量 s：前置块里照原来的算式算出初值，每条 i := i + c 之后补一条
+// s := s + k*c，j原来的定值改成 j := s
+typedef struct _affine {
+    int iv;       // 小于0表示循环不变
+    unsigned k;
+    boolean mul;  // 算式里乘过常数，削弱才有好处
+} Affine;
+
+static int* recStamp;    // 循环内分析过的临时变量
+static Affine* recForm;
+static int* recPos;
+static int* recEpoch;    // 归纳变量更新或换块后，之前算出的值就不再跟得上
+static int* famStamp;
+static int* famUses;     // 被同一族的定值读的次数
+static int* cloneStamp;
+static OperandId* cloneOp;
+static int* reducedIv;   // 削弱出的新变量 -> 它跟着的归纳变量
+static int reducedNum, reducedCap, newTempBase;
+static int curLoop, curEpoch;
+
+// 本遍新开的临时变量的编号会和变量的下标撞上，不能直接查表
+static boolean isReduced(OperandId id) {
+    pOperand op = getOperand(id);
+    return op->kind == OP_TEMP && op->u.no >= newTempBase;
+}
+
+static int oldIndex(OperandId id) {
+    return isReduced(id) ? -1 : valueIndex(id);
+}
+
+static OperandId newReduced(int iv) {
+    OperandId s = newTemp();
+    int i = getOperand(s)->u.no - newTempBase;
+    while (i >= reducedCap) {
+        reducedCap = reducedCap ? reducedCap * 2 : 64;
+        reducedIv = (int*)realloc(reducedIv, sizeof(int) * reducedCap);
+        assert(reducedIv != NULL);
+    }
+    while (reducedNum <= i) reducedIv[reducedNum++] = -1;
+    reducedIv[i] = iv;
+    return s;
+}
+
+static boolean isInduction(int v) {
+    return loopStamp[v] == curLoop && loopDefs[v] == loopIncs[v];
+}
+
+static boolean getAffine(OperandId id, Affine* form) {
+    pOperand op = getOperand(id);
+    if (op->isAddr) return FALSE;
+    form->iv = -1;
+    form->k = 0;
+    form->mul = FALSE;
+    if (op->kind == OP_CONSTANT) return TRUE;
+    // 外层循环削弱出的变量，只在它的归纳变量更新时跟着变
+    if (isReduced(id)) {
+        int i = op->u.no - newTempBase;
+        return i < reducedNum && reducedIv[i] >= 0 &&
+               loopStamp[reducedIv[i]] != curLoop;
+    }
+    int v = valueIndex(id);
+    if (v < 0) return FALSE;
+    if (loopStamp[v] != curLoop) return TRUE;
+    if (isInduction(v)) {
+        form->iv = v;
+        form->k = 1;
+        return TRUE;
+    }
+    if (recStamp[v] != curLoop) return FALSE;
+    if (recForm[v].iv >= 0 && recEpoch[v] != curEpoch) return FALSE;
+    *form = recForm[v];
+    return TRUE;
+}
+
+// 算出一条定值的仿射形式，两边的归纳变量不同或乘了非常数就失败
+static boolean classify(int l, pInterCode code, Affine* form) {
+    Affine x, y;
+    switch (code->kind) {
+        case IR_ASSIGN:
+            return getAffine(code->u.assign.right, form);
+        case IR_GET_ADDR:
+            form->iv = -1;
+            form->k = 0;
+            form->mul = FALSE;
+            return isInvariantAddr(code->u.assign.right, l);
+        case IR_ADD:
+        case IR_SUB:
+            if (!getAffine(code->u.binOp.op1, &x) ||
+                !getAffine(code->u.binOp.op2, &y))
+                return FALSE;
+            if (x.iv >= 0 && y.iv >= 0 && x.iv != y.iv) return FALSE;
+            form->iv = x.iv >= 0 ? x.iv : y.iv;
+            form->k = code->kind == IR_ADD ? x.k + y.k : x.k - y.k;
+            form->mul = x.mul || y.mul;
+            break;
+        case IR_MUL: {
+            if (!getAffine(code->u.binOp.op1, &x) ||
+                !getAffine(code->u.binOp.op2, &y))
+                return FALSE;
+            if (x.iv < 0 && y.iv < 0) {
+                *form = x;
+                return TRUE;
+            }
+            if (x.iv >= 0 && y.iv >= 0) return FALSE;
+            Affine* var = x.iv >= 0 ? &x : &y;
+            pOperand c = getOperand(x.iv >= 0 ? code->u.binOp.op2
+                                              : code->u.binOp.op1);
+            if (c->kind != OP_CONSTANT) return FALSE;
+            form->iv = var->iv;
+            form->k = var->k * (unsigned)c->u.value;
+            form->mul = TRUE;
+            break;
+        }
+        default:
+            return FALSE;
+    }
+    if (form->k == 0) form->iv = -1;
+    return TRUE;
+}
+
+static OperandId cloneDef(int v, OperandId dest, int pos);
+
+// 循环入口处这个操作数的值
+static OperandId materialize(OperandId id, int pos) {
+    int v = oldIndex(id);
+    if (v < 0 || loopStamp[v] != curLoop || isInduction(v)) return id;
+    if (cloneStamp[v] == curLoop) return cloneOp[v];
+    return cloneDef(v, newTemp(), pos);
+}
+
+static OperandId cloneDef(int v, OperandId dest, int pos) {
+    assert(recStamp[v] == curLoop);
+    InterCode def = interCodeList->codes[recPos[v]];
+    if (def.kind == IR_ASSIGN) {
+        def.u.assign.right = materialize(def.u.assign.right, pos);
+        def.u.assign.left = dest;
+    } else if (def.kind == IR_GET_ADDR) {
+        def.u.assign.left = dest;
+    } else {
+        def.u.binOp.op1 = materialize(def.u.binOp.op1, pos);
+        def.u.binOp.op2 = materialize(def.u.binOp.op2, pos);
+        def.u.binOp.result = dest;
+    }
+    *addInsertion(pos, 1, def.kind) = def;
+    cloneStamp[v] = curLoop;
+    cloneOp[v] = dest;
+    return dest;
+}
+
+// order, incPos和recList的长度至少是函数的块数和指令数
+static int reduceLoop(pCfg cfg, int l, int* order, int* incPos, int* recList) {
+    pInterCode codes = cfg->list->codes;
+    int blockNum = sortLoopBlocks(cfg, l, order);
+    int incNum = countLoopDefs(cfg, l, order, blockNum, incPos);
+    if (incNum == 0) return 0;
+
+    // 按逆后序算每个临时变量的仿射形式
+    int recNum = 0;
+    for (int i = 0; i < blockNum; i++) {
+        curEpoch++;
+        forEachCode(cfg, order[i], code) {
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            unsigned delta;
+            if (v >= 0 && isInduction(v) && getIncrement(code, &delta)) {
+                curEpoch++;
+                continue;
+            }
+            Affine form;
+            if (!isTemp(def) || funcDefs[v] != 1 || !classify(l, code, &form))
+                continue;
+            recStamp[v] = curLoop;
+            recForm[v] = form;
+            recPos[v] = code - codes;
+            recEpoch[v] = curEpoch;
+            OperandId* slots[3];
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int u = oldIndex(*slots[j]);
+                if (u < 0 || recStamp[u] != curLoop) continue;
+                if (famStamp[u] != curLoop) {
+                    famStamp[u] = curLoop;
+                    famUses[u] = 0;
+                }
+                famUses[u]++;
+            }
+            if (form.iv >= 0 && form.mul) recList[recNum++] = v;
+        }
+    }
+
+    // 只削弱在族外还有人读的，族内的中间结果交给死代码删除
+    int reduced = 0;
+    for (int r = 0; r < recNum; r++) {
+        int v = recList[r];
+        int uses = famStamp[v] == curLoop ? famUses[v] : 0;
+        if (funcUses[v] == uses) continue;
+        int pos = openPreheader(cfg, l);
+        Affine form = recForm[v];
+        OperandId s = cloneDef(v, newReduced(form.iv), pos);
+        for (int j = 0; j < incNum; j++) {
+            pInterCode inc = &codes[incPos[j]];
+            unsigned delta;
+            if (valueIndex(inc->u.binOp.result) != form.iv) continue;
+            getIncrement(inc, &delta);
+            pInterCode update = addInsertion(incPos[j] + 1, 0, IR_ADD);
+            update->u.binOp.result = s;
+            update->u.binOp.op1 = s;
+            update->u.binOp.op2 = newOperand(OP_CONSTANT, (int)(form.k * delta));
+        }
+        pInterCode code = &codes[recPos[v]];
+        toAssign(code, getDef(code), s);
+        reduced++;
+    }
+    return reduced;
+}
+
+int reduceStrength(pInterCodeList list) {
+    int n = valueNum;
+    beginLoopPass(list);
+    recStamp = (int*)calloc(n, sizeof(int));
+    recForm = (Affine*)malloc(sizeof(Affine) * n);
+    recPos = (int*)malloc(sizeof(int) * n);
+    recEpoch = (int*)malloc(sizeof(int) * n);
+    famStamp = (int*)calloc(n, sizeof(int));
+    famUses = (int*)malloc(sizeof(int) * n);
+    cloneStamp = (int*)calloc(n, sizeof(int));
+    cloneOp = (OperandId*)malloc(sizeof(OperandId) * n);
+    assert(recStamp && recForm && recPos && recEpoch && famStamp && famUses &&
+           cloneStamp && cloneOp);
+    curEpoch = 0;
+    newTempBase = list->tempVarNum;
+    reducedNum = 0;
+
+    int reduced = 0;
+    for (int start = 0; start < list->codeNum;
+         start = nextFunction(list, start)) {
+        if (list->codes[start].kind != IR_FUNCTION) continue;
+        pCfg cfg = beginFunction(list, start);
+        if (cfg == NULL) continue;
+        int codeNum = cfg->funcEnd - cfg->funcStart;
+        int* order = (int*)malloc(sizeof(int) * cfg->blockNum);
+        int* incPos = (int*)malloc(sizeof(int) * codeNum);
+        int* recList = (int*)malloc(sizeof(int) * codeNum);
+        assert(order && incPos && recList);
+        for (int l = 0; l < cfg->loopNum; l++) {
+            if (!canPreheader(cfg, l)) continue;
+            curLoop = loopId(l);
+            reduced += reduceLoop(cfg, l, order, incPos, recList);
+        }
+        free(order);
+        free(incPos);
+        free(recList);
+        endFunction(cfg);
+    }
+
+    free(recStamp);
+    free(recForm);
+    free(recPos);
+    free(recEpoch);
+    free(famStamp);
+    free(famUses);
+    free(cloneStamp);
+    free(cloneOp);
+    free(reducedIv);
+    reducedIv = NULL;
+    reducedCap = 0;
+    endLoopPass(list);
+    if (optStats)
+        fprintf(stderr, "strength: %d induction variables reduced\n", reduced);
+    return reduced;
+}
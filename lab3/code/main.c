@@ -1,5 +1,7 @@
 #include <errno.h>
-#include "inter.h"
+#include "optimize.h"
+#include "vm.h"
+#include "backend.h"
 #include "syntax.tab.h"
 
 extern pNode root;
@@ -11,16 +13,46 @@ extern void yyrestart(FILE*);
 unsigned lexError = FALSE;
 unsigned synError = FALSE;
 
+// usage: ./parser file.cmm [-o out] [-O0|-O1] [-f[no-]cse|licm|inline|ssa] [-fregalloc=color|linear] [-stats] [--run] [--emit=ir|x86|mips]
+// --emit选择写出中间代码、x86-64汇编还是MIPS汇编；
+// --run时直接执行，给了-o才同时写出。--emit=mips时在自带的模拟器里执行
+// MIPS代码，否则执行中间代码
 int main(int argc, char** argv) {
-    if (argc <= 1) {
+    char* inFile = NULL;
+    char* outFile = NULL;
+    int optLevel = 0;
+    boolean run = FALSE;
+    char* emit = "ir";
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            outFile = argv[++i];
+        else if (!strcmp(argv[i], "-O0") || !strcmp(argv[i], "-O1"))
+            optLevel = argv[i][2] - '0';
+        else if (!strncmp(argv[i], "-f", 2) && setOptFlag(argv[i] + 2))
+            continue;
+        else if (!strcmp(argv[i], "-stats"))
+            optStats = TRUE;
+        else if (!strcmp(argv[i], "--run"))
+            run = TRUE;
+        else if (!strcmp(argv[i], "--emit=ir") || !strcmp(argv[i], "--emit=x86") ||
+                 !strcmp(argv[i], "--emit=mips"))
+            emit = argv[i] + 7;
+        else
+            inFile = argv[i];
+    }
+    if (inFile == NULL) {
+        fprintf(stderr, "usage: %s file.cmm [-o out] [-O0|-O1] [-f[no-]cse|licm|inline|ssa] [-fregalloc=color|linear] [-stats] [--run] [--emit=ir|x86|mips]\n",
+                argv[0]);
         return 1;
     }
 
-    FILE* fr = fopen(argv[1], "r");
+    FILE* fr = fopen(inFile, "r");
     if (!fr) {
+        perror(inFile);
         return 1;
     }
 
+    int ret = 0;
     yyrestart(fr);
     yyparse();
 
@@ -28,13 +60,39 @@ int main(int argc, char** argv) {
         table = initTable();
         traverseTree(root);
         interCodeList = newInterCodeList();
-        genInterCodes(root);
-        if (!interError) {
-            printInterCode(NULL, interCodeList); // Print to console
+        // 有语义错误时不生成中间代码
+        if (!semError) {
+            genInterCodes(root);
+            if (!interError) {
+                int before = interCodeList->codeNum;
+                optimize(interCodeList, optLevel);
+                if (optStats)
+                    fprintf(stderr, "IR instructions: %d -> %d\n", before,
+                            interCodeList->codeNum);
+                FILE* fw = outFile ? fopen(outFile, "w") : run ? NULL : stdout;
+                if (fw) {
+                    if (!strcmp(emit, "x86"))
+                        genX86(fw, interCodeList);
+                    else if (!strcmp(emit, "mips"))
+                        genMips(fw, interCodeList);
+                    else
+                        printInterCode(fw, interCodeList);
+                    if (fw != stdout) fclose(fw);
+                } else if (outFile) {
+                    perror(outFile);
+                    ret = 1;
+                }
+                if (run && !ret)
+                    ret = strcmp(emit, "mips") ? runInterCode(interCodeList)
+                                               : runMips(interCodeList);
+            }
         }
+        deleteInterCodeList(interCodeList);
         deleteTable(table);
     }
 
+    fclose(fr);
     delNode(&root);
-    return 0;
+    deleteInterner();
+    return ret;
 }
\ No newline at end of file
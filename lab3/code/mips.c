@@ -0,0 +1,527 @@
+#include "backend.h"
+#include "cfg.h"
+#include "mips.h"
+#include "optimize.h"
+#include "regalloc.h"
+
+// 寄存器分配器的0..17号依次是$t0..$t9、$s0..$s7，前10个调用时会被破坏。
+// $v0/$v1是溢出的值和常量的临时寄存器，$a0..$a3传前4个参数。
+// 帧的布局（相对$sp往上）：
+//   0     第5个起的实参
+//   ...   保存的$ra和用到的$s
+//   ...   溢出的值
+//   ...   DEC出来的内存
+// 第5个起的形参在调用者的帧里，也就是本帧之上
+#define MIPS_REG_NUM 18
+#define MIPS_CALLER_SAVED 10
+
+char* mipsStrings[MIPS_STR_NUM] = {"\n", "runtime error: division by zero\n"};
+char* mipsStringNames[MIPS_STR_NUM] = {"_nl", "_div0_msg"};
+
+static int allocRegs[MIPS_REG_NUM] = {
+    R_T0, R_T1, R_T2, R_T3, R_T4, R_T5, R_T6, R_T7, R_T8,
+    R_T9, R_S0, R_S1, R_S2, R_S3, R_S4, R_S5, R_S6, R_S7,
+};
+
+static char* regNames[32] = {
+    "zero", "at", "v0", "v1", "a0", "a1", "a2", "a3",
+    "t0",   "t1", "t2", "t3", "t4", "t5", "t6", "t7",
+    "s0",   "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+    "t8",   "t9", "k0", "k1", "gp", "sp", "fp", "ra",
+};
+
+char* mipsOpNames[M_OP_NUM] = {
+    "", "", "li", "la", "move", "addu", "subu", "mul", "addiu", "sll",
+    "sra", "srl", "div", "mflo", "lw", "sw", "j", "blt", "ble", "bgt",
+    "bge", "beq", "bne", "jal", "jr", "syscall",
+};
+
+static pMipsProgram prog;
+static pRegAlloc ra;
+static int* memStamp;  // valueIndex -> DEC的内存在本帧里的偏移
+static int* memOf;
+static int curStamp;
+static int frameSize, spillBase, memBase, memSize;
+static int savedRegs[MIPS_REG_NUM + 1];  // 序言里要保存的寄存器，$ra在内
+static int savedNum;
+static int div0Label;
+
+static void emit(MipsOp op, int rd, int rs, int rt, int imm) {
+    if (prog->instNum == prog->instCap) {
+        prog->instCap = prog->instCap ? prog->instCap * 2 : 1024;
+        prog->insts = (MipsInst*)realloc(prog->insts,
+                                         sizeof(MipsInst) * prog->instCap);
+        assert(prog->insts != NULL);
+    }
+    MipsInst* inst = &prog->insts[prog->instNum++];
+    inst->op = op;
+    inst->rd = rd;
+    inst->rs = rs;
+    inst->rt = rt;
+    inst->imm = imm;
+}
+
+static boolean fitsImm(int c) { return c >= -32768 && c <= 32767; }
+
+// rd := rs + c，c超出16位时借$v1
+static void emitAddImm(int rd, int rs, int c) {
+    if (fitsImm(c)) {
+        emit(M_ADDIU, rd, rs, 0, c);
+    } else {
+        emit(M_LI, R_V1, 0, 0, c);
+        emit(M_ADDU, rd, rs, R_V1, 0);
+    }
+}
+
+static boolean isConst(OperandId id) {
+    return getOperand(id)->kind == OP_CONSTANT;
+}
+
+static int constOf(OperandId id) { return getOperand(id)->u.value; }
+
+static int homeReg(OperandId id) {
+    int r = ra->reg[valueIndex(id)];
+    return r == REG_SPILL ? -1 : allocRegs[r];
+}
+
+static int spillOffset(OperandId id) {
+    return spillBase + 4 * ra->slot[valueIndex(id)];
+}
+
+// 读出一个源操作数，不在寄存器里时放进scratch
+static int loadSrc(OperandId id, int scratch) {
+    if (isConst(id)) {
+        if (constOf(id) == 0) return R_ZERO;
+        emit(M_LI, scratch, 0, 0, constOf(id));
+        return scratch;
+    }
+    int r = homeReg(id);
+    if (r >= 0) return r;
+    emit(M_LW, scratch, R_SP, 0, spillOffset(id));
+    return scratch;
+}
+
+// 读到指定的寄存器里，传参数用
+static void loadInto(OperandId id, int rd) {
+    int r = loadSrc(id, rd);
+    if (r != rd) emit(M_MOVE, rd, r, 0, 0);
+}
+
+// 结果先算到哪个寄存器，溢出的算到$v0再存回去
+static int dstReg(OperandId id) {
+    int r = homeReg(id);
+    return r >= 0 ? r : R_V0;
+}
+
+static void storeDst(OperandId id, int r) {
+    if (homeReg(id) < 0) emit(M_SW, 0, R_SP, r, spillOffset(id));
+}
+
+static void storeFrom(OperandId id, int r) {
+    int home = homeReg(id);
+    if (home < 0)
+        emit(M_SW, 0, R_SP, r, spillOffset(id));
+    else if (home != r)
+        emit(M_MOVE, home, r, 0, 0);
+}
+
+// 2的k次幂返回k，否则返回-1
+static int log2Of(OperandId id) {
+    if (!isConst(id)) return -1;
+    int c = constOf(id);
+    if (c <= 1 || (c & (c - 1))) return -1;
+    int k = 0;
+    while ((1 << k) != c) k++;
+    return k;
+}
+
+static void genBinOp(pInterCode code) {
+    OperandId x = code->u.binOp.result, y = code->u.binOp.op1,
+              z = code->u.binOp.op2;
+    int d = dstReg(x), a, b, k;
+    switch (code->kind) {
+        case IR_ADD:
+            if (isConst(z) && fitsImm(constOf(z))) {
+                emit(M_ADDIU, d, loadSrc(y, R_V0), 0, constOf(z));
+            } else if (isConst(y) && fitsImm(constOf(y))) {
+                emit(M_ADDIU, d, loadSrc(z, R_V0), 0, constOf(y));
+            } else {
+                a = loadSrc(y, R_V0);
+                b = loadSrc(z, R_V1);
+                emit(M_ADDU, d, a, b, 0);
+            }
+            break;
+        case IR_SUB:
+            if (isConst(z) && constOf(z) > -32768 && constOf(z) <= 32768) {
+                emit(M_ADDIU, d, loadSrc(y, R_V0), 0, -constOf(z));
+            } else {
+                a = loadSrc(y, R_V0);
+                b = loadSrc(z, R_V1);
+                emit(M_SUBU, d, a, b, 0);
+            }
+            break;
+        case IR_MUL:
+            if ((k = log2Of(z)) >= 0) {
+                emit(M_SLL, d, loadSrc(y, R_V0), 0, k);
+            } else if ((k = log2Of(y)) >= 0) {
+                emit(M_SLL, d, loadSrc(z, R_V0), 0, k);
+            } else {
+                a = loadSrc(y, R_V0);
+                b = loadSrc(z, R_V1);
+                emit(M_MUL, d, a, b, 0);
+            }
+            break;
+        case IR_DIV:
+            a = loadSrc(y, R_V0);
+            if ((k = log2Of(z)) >= 0) {
+                // 向0取整：负数先加上2^k-1再算术右移
+                emit(M_SRA, R_V1, a, 0, 31);
+                emit(M_SRL, R_V1, R_V1, 0, 32 - k);
+                emit(M_ADDU, R_V1, a, R_V1, 0);
+                emit(M_SRA, d, R_V1, 0, k);
+            } else {
+                b = loadSrc(z, R_V1);
+                if (!isConst(z) || constOf(z) == 0)
+                    emit(M_BEQ, 0, b, R_ZERO, div0Label);
+                emit(M_DIV, 0, a, b, 0);
+                emit(M_MFLO, d, 0, 0, 0);
+            }
+            break;
+        default:
+            assert(0);
+    }
+    storeDst(x, d);
+}
+
+static int findFunction(char* name) {
+    for (int f = 0; f < prog->funcNum; f++)
+        if (prog->funcNames[f] == name) return f;
+    assert(0);
+    return -1;
+}
+
+static void genEpilogue() {
+    for (int i = 0; i < savedNum; i++)
+        emit(M_LW, savedRegs[i], R_SP, 0, spillBase - 4 * (savedNum - i));
+    if (frameSize) emitAddImm(R_SP, R_SP, frameSize);
+    emit(M_JR, 0, R_RA, 0, 0);
+}
+
+static void genCode(pInterCode code, int* args) {
+    int d, a, b;
+    switch (code->kind) {
+        case IR_LABEL:
+            emit(M_LABEL, 0, 0, 0, labelNo(code->u.oneOp.op));
+            break;
+        case IR_ASSIGN: {
+            OperandId x = code->u.assign.left, y = code->u.assign.right;
+            int home = homeReg(x);
+            if (home >= 0)
+                loadInto(y, home);
+            else
+                storeDst(x, loadSrc(y, R_V0));
+            break;
+        }
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            genBinOp(code);
+            break;
+        case IR_GET_ADDR: {
+            int v = valueIndex(code->u.assign.right);
+            assert(v >= 0 && memStamp[v] == curStamp);
+            d = dstReg(code->u.assign.left);
+            emitAddImm(d, R_SP, memBase + memOf[v]);
+            storeDst(code->u.assign.left, d);
+            break;
+        }
+        case IR_READ_ADDR:
+            a = loadSrc(code->u.assign.right, R_V0);
+            d = dstReg(code->u.assign.left);
+            emit(M_LW, d, a, 0, 0);
+            storeDst(code->u.assign.left, d);
+            break;
+        case IR_WRITE_ADDR:
+            a = loadSrc(code->u.assign.left, R_V0);
+            b = loadSrc(code->u.assign.right, R_V1);
+            emit(M_SW, 0, a, b, 0);
+            break;
+        case IR_GOTO:
+            emit(M_J, 0, 0, 0, labelNo(code->u.oneOp.op));
+            break;
+        case IR_IF_GOTO:
+            a = loadSrc(code->u.ifGoto.x, R_V0);
+            b = loadSrc(code->u.ifGoto.y, R_V1);
+            emit(M_BLT + getOperand(code->u.ifGoto.relop)->u.relop, 0, a, b,
+                 labelNo(code->u.ifGoto.z));
+            break;
+        case IR_RETURN:
+            loadInto(code->u.oneOp.op, R_V0);
+            genEpilogue();
+            break;
+        case IR_ARG:
+            if (*args < 4) {
+                loadInto(code->u.oneOp.op, R_A0 + *args);
+            } else {
+                a = loadSrc(code->u.oneOp.op, R_V0);
+                emit(M_SW, 0, R_SP, a, 4 * (*args - 4));
+            }
+            (*args)++;
+            break;
+        case IR_CALL:
+            emit(M_JAL, 0, 0, 0,
+                 findFunction(getOperand(code->u.assign.right)->u.name));
+            storeFrom(code->u.assign.left, R_V0);
+            *args = 0;
+            break;
+        case IR_READ:
+            emit(M_LI, R_V0, 0, 0, MIPS_SYS_READ_INT);
+            emit(M_SYSCALL, 0, 0, 0, 0);
+            storeFrom(code->u.oneOp.op, R_V0);
+            break;
+        case IR_WRITE:
+            loadInto(code->u.oneOp.op, R_A0);
+            emit(M_LI, R_V0, 0, 0, MIPS_SYS_PRINT_INT);
+            emit(M_SYSCALL, 0, 0, 0, 0);
+            emit(M_LA, R_A0, 0, 0, MIPS_STR_NEWLINE);
+            emit(M_LI, R_V0, 0, 0, MIPS_SYS_PRINT_STRING);
+            emit(M_SYSCALL, 0, 0, 0, 0);
+            break;
+        default:  // DEC的内存和PARAM在序言里处理
+            break;
+    }
+}
+
+static void genFunction(pInterCodeList list, int start, int end, int f) {
+    allocRegisters(ra, list, start);
+
+    // 帧的大小：调用时栈上的实参、保存的寄存器、溢出的值、DEC的内存
+    int maxArgs = 0, args = 0;
+    boolean hasCall = FALSE;
+    memSize = 0;
+    for (int i = start + 1; i < end; i++) {
+        pInterCode code = &list->codes[i];
+        if (code->kind == IR_DEC) {
+            int v = valueIndex(code->u.dec.op);
+            memStamp[v] = curStamp;
+            memOf[v] = memSize;
+            memSize += (code->u.dec.size + 3) & ~3;
+        } else if (code->kind == IR_ARG) {
+            if (++args > maxArgs) maxArgs = args;
+        } else if (code->kind == IR_CALL) {
+            args = 0;
+            hasCall = TRUE;
+        }
+    }
+    savedNum = 0;
+    if (hasCall) savedRegs[savedNum++] = R_RA;
+    for (int r = MIPS_CALLER_SAVED; r < MIPS_REG_NUM; r++)
+        if (ra->usedRegs & (1u << r)) savedRegs[savedNum++] = allocRegs[r];
+    int outArgs = maxArgs > 4 ? maxArgs - 4 : 0;
+    spillBase = 4 * (outArgs + savedNum);
+    memBase = spillBase + 4 * ra->slotNum;
+    frameSize = (memBase + memSize + 7) & ~7;
+
+    // 序言
+    emit(M_FUNC, 0, 0, 0, f);
+    if (frameSize) emitAddImm(R_SP, R_SP, -frameSize);
+    for (int i = 0; i < savedNum; i++)
+        emit(M_SW, 0, R_SP, savedRegs[i], spillBase - 4 * (savedNum - i));
+    int k = 0;
+    for (int i = start + 1; i < end && list->codes[i].kind == IR_PARAM;
+         i++, k++) {
+        OperandId op = list->codes[i].u.oneOp.op;
+        if (k < 4) {
+            storeFrom(op, R_A0 + k);
+        } else {
+            int d = dstReg(op);
+            emit(M_LW, d, R_SP, 0, frameSize + 4 * (k - 4));
+            storeDst(op, d);
+        }
+    }
+    // 没赋值就读的变量和解释器一样当作0
+    for (int i = 0; i < ra->entryLiveNum; i++) {
+        int v = ra->entryLive[i];
+        if (ra->reg[v] != REG_SPILL)
+            emit(M_MOVE, allocRegs[ra->reg[v]], R_ZERO, 0, 0);
+        else
+            emit(M_SW, 0, R_SP, R_ZERO, spillBase + 4 * ra->slot[v]);
+    }
+    if (memSize <= 32) {
+        for (int off = 0; off < memSize; off += 4)
+            emit(M_SW, 0, R_SP, R_ZERO, memBase + off);
+    } else if (memSize) {
+        int loop = prog->labelNum++;
+        emitAddImm(R_V0, R_SP, memBase);
+        emitAddImm(R_A0, R_V0, memSize);
+        emit(M_LABEL, 0, 0, 0, loop);
+        emit(M_SW, 0, R_V0, R_ZERO, 0);
+        emit(M_ADDIU, R_V0, R_V0, 0, 4);
+        emit(M_BNE, 0, R_V0, R_A0, loop);
+    }
+
+    args = 0;
+    for (int i = start + 1; i < end; i++) genCode(&list->codes[i], &args);
+    // 没有RETURN就走到末尾的，返回0
+    if (list->codes[end - 1].kind != IR_RETURN) {
+        emit(M_MOVE, R_V0, R_ZERO, 0, 0);
+        genEpilogue();
+    }
+}
+
+pMipsProgram genMipsProgram(pInterCodeList list) {
+    prog = (pMipsProgram)calloc(1, sizeof(MipsProgram));
+    assert(prog != NULL);
+    prog->labelNum = list->labelNum;
+    for (int i = 0; i < list->codeNum; i++)
+        if (list->codes[i].kind == IR_FUNCTION) prog->funcNum++;
+    prog->funcNames = (char**)malloc(sizeof(char*) * (prog->funcNum + 1));
+    assert(prog->funcNames != NULL);
+    int f = 0;
+    for (int i = 0; i < list->codeNum; i++)
+        if (list->codes[i].kind == IR_FUNCTION)
+            prog->funcNames[f++] = getOperand(list->codes[i].u.oneOp.op)->u.name;
+
+    initValueIndex(list);
+    ra = newRegAlloc(MIPS_REG_NUM, MIPS_CALLER_SAVED);
+    memStamp = (int*)calloc(valueNum + 1, sizeof(int));
+    memOf = (int*)malloc(sizeof(int) * (valueNum + 1));
+    assert(memStamp && memOf);
+    div0Label = prog->labelNum++;
+
+    curStamp = 0;
+    f = 0;
+    for (int i = 0; i < list->codeNum; i = nextFunction(list, i)) {
+        if (list->codes[i].kind != IR_FUNCTION) continue;
+        curStamp++;
+        genFunction(list, i, nextFunction(list, i), f++);
+    }
+
+    // 除数为0时打印错误并以1退出
+    emit(M_LABEL, 0, 0, 0, div0Label);
+    emit(M_LA, R_A0, 0, 0, MIPS_STR_DIV0);
+    emit(M_LI, R_V0, 0, 0, MIPS_SYS_PRINT_STRING);
+    emit(M_SYSCALL, 0, 0, 0, 0);
+    emit(M_LI, R_A0, 0, 0, 1);
+    emit(M_LI, R_V0, 0, 0, MIPS_SYS_EXIT2);
+    emit(M_SYSCALL, 0, 0, 0, 0);
+
+    if (optStats)
+        fprintf(stderr,
+                "regalloc: %d values, %d copies coalesced, %d spilled, %.1f ms\n",
+                ra->valueTotal, ra->moveTotal, ra->spillTotal,
+                ra->seconds * 1000);
+    free(memStamp);
+    free(memOf);
+    deleteRegAlloc(ra);
+    deleteValueIndex();
+    return prog;
+}
+
+static void printEscaped(FILE* fp, char* s) {
+    for (; *s; s++) {
+        if (*s == '\n')
+            fputs("\\n", fp);
+        else
+            fputc(*s, fp);
+    }
+}
+
+void printMipsProgram(FILE* fp, pMipsProgram p) {
+    if (fp == NULL) fp = stdout;
+    fprintf(fp, ".data\n");
+    for (int i = 0; i < MIPS_STR_NUM; i++) {
+        fprintf(fp, "%s: .asciiz \"", mipsStringNames[i]);
+        printEscaped(fp, mipsStrings[i]);
+        fprintf(fp, "\"\n");
+    }
+    fprintf(fp, ".globl main\n.text\n");
+    for (int i = 0; i < p->instNum; i++) {
+        MipsInst* inst = &p->insts[i];
+        char* name = mipsOpNames[inst->op];
+        char *d = regNames[inst->rd], *s = regNames[inst->rs],
+             *t = regNames[inst->rt];
+        switch (inst->op) {
+            case M_FUNC: {
+                // main以外的函数加前缀，免得和SPIM的指令名冲突
+                char* fn = p->funcNames[inst->imm];
+                fprintf(fp, strcmp(fn, "main") ? "\nf_%s:\n" : "\n%s:\n", fn);
+                break;
+            }
+            case M_LABEL:
+                fprintf(fp, "L%d:\n", inst->imm);
+                break;
+            case M_LI:
+                fprintf(fp, "\t%s $%s, %d\n", name, d, inst->imm);
+                break;
+            case M_LA:
+                fprintf(fp, "\t%s $%s, %s\n", name, d,
+                        mipsStringNames[inst->imm]);
+                break;
+            case M_MOVE:
+                fprintf(fp, "\t%s $%s, $%s\n", name, d, s);
+                break;
+            case M_ADDU:
+            case M_SUBU:
+            case M_MUL:
+                fprintf(fp, "\t%s $%s, $%s, $%s\n", name, d, s, t);
+                break;
+            case M_ADDIU:
+            case M_SLL:
+            case M_SRA:
+            case M_SRL:
+                fprintf(fp, "\t%s $%s, $%s, %d\n", name, d, s, inst->imm);
+                break;
+            case M_DIV:
+                fprintf(fp, "\t%s $%s, $%s\n", name, s, t);
+                break;
+            case M_MFLO:
+                fprintf(fp, "\t%s $%s\n", name, d);
+                break;
+            case M_LW:
+                fprintf(fp, "\t%s $%s, %d($%s)\n", name, d, inst->imm, s);
+                break;
+            case M_SW:
+                fprintf(fp, "\t%s $%s, %d($%s)\n", name, t, inst->imm, s);
+                break;
+            case M_J:
+                fprintf(fp, "\t%s L%d\n", name, inst->imm);
+                break;
+            case M_JAL: {
+                char* fn = p->funcNames[inst->imm];
+                fprintf(fp, strcmp(fn, "main") ? "\t%s f_%s\n" : "\t%s %s\n",
+                        name, fn);
+                break;
+            }
+            case M_JR:
+                fprintf(fp, "\t%s $%s\n", name, s);
+                break;
+            case M_SYSCALL:
+                fprintf(fp, "\t%s\n", name);
+                break;
+            default:  // 条件跳转
+                fprintf(fp, "\t%s $%s, $%s, L%d\n", name, s, t, inst->imm);
+                break;
+        }
+    }
+}
+
+void deleteMipsProgram(pMipsProgram p) {
+    free(p->insts);
+    free(p->funcNames);
+    free(p);
+}
+
+void genMips(FILE* fp, pInterCodeList list) {
+    pMipsProgram p = genMipsProgram(list);
+    printMipsProgram(fp, p);
+    deleteMipsProgram(p);
+}
+
+int runMips(pInterCodeList list) {
+    pMipsProgram p = genMipsProgram(list);
+    int ret = runMipsProgram(p);
+    deleteMipsProgram(p);
+    return ret;
+}
@@ -0,0 +1,89 @@
+#ifndef MIPS_H
+#define MIPS_H
+#include "inter.h"
+
+// MIPS32后端内部用的表示：指令先生成到数组里，再打印成SPIM能读的汇编，
+// 或者交给mipssim.c直接执行。打印出来的伪指令（li、move、blt等）
+// 在模拟器里都算一条
+
+typedef enum _mipsReg {
+    R_ZERO = 0, R_AT, R_V0, R_V1,
+    R_A0, R_A1, R_A2, R_A3,
+    R_T0, R_T1, R_T2, R_T3, R_T4, R_T5, R_T6, R_T7,
+    R_S0, R_S1, R_S2, R_S3, R_S4, R_S5, R_S6, R_S7,
+    R_T8, R_T9, R_K0, R_K1, R_GP, R_SP, R_FP, R_RA,
+} MipsReg;
+
+typedef enum _mipsOp {
+    M_FUNC,     // 函数imm的入口，不是指令
+    M_LABEL,    // 标签imm，不是指令
+    M_LI,       // rd := imm
+    M_LA,       // rd := 数据段里第imm个字符串的地址
+    M_MOVE,     // rd := rs
+    M_ADDU,     // rd := rs + rt，下面两个同理
+    M_SUBU,
+    M_MUL,
+    M_ADDIU,    // rd := rs + imm
+    M_SLL,      // rd := rs << imm，下面两个同理
+    M_SRA,
+    M_SRL,
+    M_DIV,      // lo := rs / rt
+    M_MFLO,     // rd := lo
+    M_LW,       // rd := imm(rs)
+    M_SW,       // imm(rs) := rt
+    M_J,        // 跳到标签imm
+    M_BLT,      // rs < rt 时跳到标签imm，下面五个同理
+    M_BLE,
+    M_BGT,
+    M_BGE,
+    M_BEQ,
+    M_BNE,
+    M_JAL,      // 调用函数imm
+    M_JR,       // 跳到rs
+    M_SYSCALL,
+    M_OP_NUM,
+} MipsOp;
+
+typedef struct _mipsInst {
+    MipsOp op;
+    int rd, rs, rt;
+    int imm;
+} MipsInst;
+
+typedef struct _mipsProgram* pMipsProgram;
+
+typedef struct _mipsProgram {
+    MipsInst* insts;
+    int instNum, instCap;
+    char** funcNames;  // M_FUNC和M_JAL的imm是这里的下标
+    int funcNum;
+    int labelNum;      // 中间代码的标签之后是后端新开的
+} MipsProgram;
+
+extern char* mipsOpNames[M_OP_NUM];
+
+// 数据段只有这几个字符串，M_LA的imm是下标
+#define MIPS_STR_NEWLINE 0
+#define MIPS_STR_DIV0 1
+#define MIPS_STR_NUM 2
+extern char* mipsStrings[MIPS_STR_NUM];
+extern char* mipsStringNames[MIPS_STR_NUM];
+
+// 用到的系统调用，和SPIM的编号一样
+#define MIPS_SYS_PRINT_INT 1
+#define MIPS_SYS_PRINT_STRING 4
+#define MIPS_SYS_READ_INT 5
+#define MIPS_SYS_EXIT 10
+#define MIPS_SYS_EXIT2 17
+
+// 模拟器的栈，从MIPS_STACK_TOP往下长
+#define MIPS_STACK_TOP 0x7ffff000
+#define MIPS_STACK_SIZE (64 << 20)
+#define MIPS_DATA_BASE 0x10010000
+
+pMipsProgram genMipsProgram(pInterCodeList list);
+void printMipsProgram(FILE* fp, pMipsProgram prog);
+void deleteMipsProgram(pMipsProgram prog);
+int runMipsProgram(pMipsProgram prog);  // mipssim.c，返回值同runInterCode
+
+#endif
@@ -0,0 +1,227 @@
+#include "mips.h"
+#include "optimize.h"
+
+// MIPS程序的模拟器，不依赖SPIM就能运行和计时。装载时去掉标签，跳转的目标
+// 换成指令下标，$ra里存的也是指令下标；从main开始执行，main返回到末尾的
+// 下标即结束。栈在MIPS_STACK_TOP之下，数据段只放mipsStrings。
+// 没有延迟槽，乘除的结果当场可用
+#define STACK_BASE ((unsigned)MIPS_STACK_TOP - MIPS_STACK_SIZE)
+
+static int dataAddr[MIPS_STR_NUM];
+
+static char* findString(int addr) {
+    for (int i = 0; i < MIPS_STR_NUM; i++)
+        if (dataAddr[i] == addr) return mipsStrings[i];
+    return NULL;
+}
+
+int runMipsProgram(pMipsProgram prog) {
+    int* labelPc = (int*)malloc(sizeof(int) * (prog->labelNum + 1));
+    int* funcPc = (int*)malloc(sizeof(int) * (prog->funcNum + 1));
+    MipsInst* code = (MipsInst*)malloc(sizeof(MipsInst) * (prog->instNum + 1));
+    int* stack = (int*)calloc(MIPS_STACK_SIZE / 4, sizeof(int));
+    assert(labelPc && funcPc && code && stack);
+    int addr = MIPS_DATA_BASE;
+    for (int i = 0; i < MIPS_STR_NUM; i++) {
+        dataAddr[i] = addr;
+        addr += strlen(mipsStrings[i]) + 1;
+    }
+
+    // 装载
+    int n = 0;
+    for (int i = 0; i < prog->instNum; i++) {
+        MipsInst* inst = &prog->insts[i];
+        if (inst->op == M_FUNC)
+            funcPc[inst->imm] = n;
+        else if (inst->op == M_LABEL)
+            labelPc[inst->imm] = n;
+        else
+            code[n++] = *inst;
+    }
+    int mainPc = -1;
+    for (int f = 0; f < prog->funcNum; f++)
+        if (!strcmp(prog->funcNames[f], "main")) mainPc = funcPc[f];
+    for (int i = 0; i < n; i++) {
+        if (code[i].op == M_JAL)
+            code[i].imm = funcPc[code[i].imm];
+        else if (code[i].op == M_J || (code[i].op >= M_BLT && code[i].op <= M_BNE))
+            code[i].imm = labelPc[code[i].imm];
+        else if (code[i].op == M_LA)
+            code[i].imm = dataAddr[code[i].imm];
+    }
+    free(labelPc);
+    free(funcPc);
+    if (mainPc < 0) {
+        fprintf(stderr, "run: no main function\n");
+        free(code);
+        free(stack);
+        return 1;
+    }
+
+    long long counts[M_OP_NUM] = {0};
+    int regs[32] = {0}, lo = 0, status = 0;
+    regs[R_SP] = MIPS_STACK_TOP;
+    regs[R_RA] = n;
+    char* error = NULL;
+    int pc = mainPc;
+
+#define CHECK_ADDR(a)                                                  \
+    if ((unsigned)(a) < STACK_BASE || (unsigned)(a) >= MIPS_STACK_TOP || \
+        ((a) & 3)) {                                                   \
+        error = "invalid address";                                     \
+        goto fail;                                                     \
+    }
+#define CHECK_SP()                                                     \
+    if (in->rd == R_SP && (unsigned)regs[R_SP] < STACK_BASE) {          \
+        error = "stack overflow";                                      \
+        goto fail;                                                     \
+    }
+
+    while (pc != n) {
+        MipsInst* in = &code[pc++];
+        counts[in->op]++;
+        switch (in->op) {
+            case M_LI:
+            case M_LA:
+                regs[in->rd] = in->imm;
+                break;
+            case M_MOVE:
+                regs[in->rd] = regs[in->rs];
+                break;
+            case M_ADDU:
+                regs[in->rd] = (int)((unsigned)regs[in->rs] + (unsigned)regs[in->rt]);
+                CHECK_SP();
+                break;
+            case M_SUBU:
+                regs[in->rd] = (int)((unsigned)regs[in->rs] - (unsigned)regs[in->rt]);
+                break;
+            case M_MUL:
+                regs[in->rd] = (int)((unsigned)regs[in->rs] * (unsigned)regs[in->rt]);
+                break;
+            case M_ADDIU:
+                regs[in->rd] = (int)((unsigned)regs[in->rs] + (unsigned)in->imm);
+                CHECK_SP();
+                break;
+            case M_SLL:
+                regs[in->rd] = (int)((unsigned)regs[in->rs] << in->imm);
+                break;
+            case M_SRA:
+                regs[in->rd] = regs[in->rs] >> in->imm;
+                break;
+            case M_SRL:
+                regs[in->rd] = (int)((unsigned)regs[in->rs] >> in->imm);
+                break;
+            case M_DIV: {
+                int a = regs[in->rs], b = regs[in->rt];
+                if (b == 0) {
+                    error = "division by zero";
+                    goto fail;
+                }
+                // 硬件上INT_MIN / -1 的结果不确定，这里和解释器一样按补码回绕
+                lo = b == -1 ? (int)(0u - (unsigned)a) : a / b;
+                break;
+            }
+            case M_MFLO:
+                regs[in->rd] = lo;
+                break;
+            case M_LW: {
+                int a = (int)((unsigned)regs[in->rs] + (unsigned)in->imm);
+                CHECK_ADDR(a);
+                regs[in->rd] = stack[((unsigned)a - STACK_BASE) >> 2];
+                break;
+            }
+            case M_SW: {
+                int a = (int)((unsigned)regs[in->rs] + (unsigned)in->imm);
+                CHECK_ADDR(a);
+                stack[((unsigned)a - STACK_BASE) >> 2] = regs[in->rt];
+                break;
+            }
+            case M_J:
+                pc = in->imm;
+                break;
+            case M_BLT:
+                if (regs[in->rs] < regs[in->rt]) pc = in->imm;
+                break;
+            case M_BLE:
+                if (regs[in->rs] <= regs[in->rt]) pc = in->imm;
+                break;
+            case M_BGT:
+                if (regs[in->rs] > regs[in->rt]) pc = in->imm;
+                break;
+            case M_BGE:
+                if (regs[in->rs] >= regs[in->rt]) pc = in->imm;
+                break;
+            case M_BEQ:
+                if (regs[in->rs] == regs[in->rt]) pc = in->imm;
+                break;
+            case M_BNE:
+                if (regs[in->rs] != regs[in->rt]) pc = in->imm;
+                break;
+            case M_JAL:
+                regs[R_RA] = pc;
+                pc = in->imm;
+                break;
+            case M_JR:
+                pc = regs[in->rs];
+                if (pc < 0 || pc > n) {
+                    error = "invalid jump";
+                    goto fail;
+                }
+                break;
+            case M_SYSCALL:
+                switch (regs[R_V0]) {
+                    case MIPS_SYS_PRINT_INT:
+                        printf("%d", regs[R_A0]);
+                        break;
+                    case MIPS_SYS_PRINT_STRING: {
+                        char* s = findString(regs[R_A0]);
+                        if (s == NULL) {
+                            error = "invalid address";
+                            goto fail;
+                        }
+                        fputs(s, stdout);
+                        break;
+                    }
+                    case MIPS_SYS_READ_INT:
+                        fflush(stdout);
+                        if (scanf("%d", &regs[R_V0]) != 1) {
+                            error = "READ: no more input";
+                            goto fail;
+                        }
+                        break;
+                    case MIPS_SYS_EXIT:
+                        goto done;
+                    case MIPS_SYS_EXIT2:
+                        status = regs[R_A0];
+                        goto done;
+                    default:
+                        error = "unknown syscall";
+                        goto fail;
+                }
+                break;
+            default:
+                assert(0);
+        }
+    }
+    goto done;
+
+fail:
+    fflush(stdout);
+    fprintf(stderr, "runtime error: %s\n", error);
+    status = 1;
+done:
+    fflush(stdout);
+    {
+        long long total = 0, memory = counts[M_LW] + counts[M_SW];
+        for (int op = 0; op < M_OP_NUM; op++) total += counts[op];
+        fprintf(stderr, "executed: %lld instructions, %lld loads/stores\n",
+                total, memory);
+        if (optStats)
+            for (int op = M_LI; op < M_OP_NUM; op++)
+                if (counts[op])
+                    fprintf(stderr, "  %-8s %lld\n", mipsOpNames[op], counts[op]);
+    }
+    free(code);
+    free(stack);
+    return status;
+}
@@ -7,6 +7,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include "intern.h"
 
 // define node type
 typedef enum _nodeType {
@@ -25,6 +26,119 @@ typedef enum _nodeType {
 
 } NodeType;
 
+// 文法符号，词法单元与非终结符统一编号，语义分析和中间代码生成据此分派
+typedef enum _symbol {
+    // 词法单元
+    SYM_INT,
+    SYM_FLOAT,
+    SYM_ID,
+    SYM_TYPE,
+    SYM_COMMA,
+    SYM_DOT,
+    SYM_SEMI,
+    SYM_RELOP,
+    SYM_ASSIGNOP,
+    SYM_PLUS,
+    SYM_MINUS,
+    SYM_STAR,
+    SYM_DIV,
+    SYM_AND,
+    SYM_OR,
+    SYM_NOT,
+    SYM_LP,
+    SYM_RP,
+    SYM_LB,
+    SYM_RB,
+    SYM_LC,
+    SYM_RC,
+    SYM_IF,
+    SYM_ELSE,
+    SYM_WHILE,
+    SYM_STRUCT,
+    SYM_RETURN,
+    // 非终结符
+    SYM_PROGRAM,
+    SYM_EXT_DEF_LIST,
+    SYM_EXT_DEF,
+    SYM_EXT_DEC_LIST,
+    SYM_SPECIFIER,
+    SYM_STRUCT_SPECIFIER,
+    SYM_OPT_TAG,
+    SYM_TAG,
+    SYM_VAR_DEC,
+    SYM_FUN_DEC,
+    SYM_VAR_LIST,
+    SYM_PARAM_DEC,
+    SYM_COMP_ST,
+    SYM_STMT_LIST,
+    SYM_STMT,
+    SYM_DEF_LIST,
+    SYM_DEF,
+    SYM_DEC_LIST,
+    SYM_DEC,
+    SYM_EXP,
+    SYM_ARGS
+} Symbol;
+
+// 产生式，非终结符结点记录自己是由哪条产生式归约得到的
+typedef enum _production {
+    PROD_TOKEN,                // 词法单元结点
+    PROD_PROGRAM,              // Program -> ExtDefList
+    PROD_EXT_DEF_LIST,         // ExtDefList -> ExtDef ExtDefList
+    PROD_EXT_DEF_VAR,          // ExtDef -> Specifier ExtDecList SEMI
+    PROD_EXT_DEF_TYPE,         // ExtDef -> Specifier SEMI
+    PROD_EXT_DEF_FUNC,         // ExtDef -> Specifier FunDec CompSt
+    PROD_EXT_DEC_LIST_ONE,     // ExtDecList -> VarDec
+    PROD_EXT_DEC_LIST_MORE,    // ExtDecList -> VarDec COMMA ExtDecList
+    PROD_SPECIFIER_TYPE,       // Specifier -> TYPE
+    PROD_SPECIFIER_STRUCT,     // Specifier -> StructSpecifier
+    PROD_STRUCT_DEF,           // StructSpecifier -> STRUCT OptTag LC DefList RC
+    PROD_STRUCT_TAG,           // StructSpecifier -> STRUCT Tag
+    PROD_OPT_TAG,              // OptTag -> ID
+    PROD_TAG,                  // Tag -> ID
+    PROD_VAR_DEC_ID,           // VarDec -> ID
+    PROD_VAR_DEC_ARRAY,        // VarDec -> VarDec LB INT RB
+    PROD_FUN_DEC_ARGS,         // FunDec -> ID LP VarList RP
+    PROD_FUN_DEC_NO_ARGS,      // FunDec -> ID LP RP
+    PROD_VAR_LIST_MORE,        // VarList -> ParamDec COMMA VarList
+    PROD_VAR_LIST_ONE,         // VarList -> ParamDec
+    PROD_PARAM_DEC,            // ParamDec -> Specifier VarDec
+    PROD_COMP_ST,              // CompSt -> LC DefList StmtList RC
+    PROD_STMT_LIST,            // StmtList -> Stmt StmtList
+    PROD_STMT_EXP,             // Stmt -> Exp SEMI
+    PROD_STMT_COMP_ST,         // Stmt -> CompSt
+    PROD_STMT_RETURN,          // Stmt -> RETURN Exp SEMI
+    PROD_STMT_IF,              // Stmt -> IF LP Exp RP Stmt
+    PROD_STMT_IF_ELSE,         // Stmt -> IF LP Exp RP Stmt ELSE Stmt
+    PROD_STMT_WHILE,           // Stmt -> WHILE LP Exp RP Stmt
+    PROD_DEF_LIST,             // DefList -> Def DefList
+    PROD_DEF,                  // Def -> Specifier DecList SEMI
+    PROD_DEC_LIST_ONE,         // DecList -> Dec
+    PROD_DEC_LIST_MORE,        // DecList -> Dec COMMA DecList
+    PROD_DEC,                  // Dec -> VarDec
+    PROD_DEC_INIT,             // Dec -> VarDec ASSIGNOP Exp
+    PROD_EXP_ASSIGN,           // Exp -> Exp ASSIGNOP Exp
+    PROD_EXP_AND,              // Exp -> Exp AND Exp
+    PROD_EXP_OR,               // Exp -> Exp OR Exp
+    PROD_EXP_RELOP,            // Exp -> Exp RELOP Exp
+    PROD_EXP_PLUS,             // Exp -> Exp PLUS Exp
+    PROD_EXP_MINUS,            // Exp -> Exp MINUS Exp
+    PROD_EXP_STAR,             // Exp -> Exp STAR Exp
+    PROD_EXP_DIV,              // Exp -> Exp DIV Exp
+    PROD_EXP_PAREN,            // Exp -> LP Exp RP
+    PROD_EXP_NEG,              // Exp -> MINUS Exp
+    PROD_EXP_NOT,              // Exp -> NOT Exp
+    PROD_EXP_CALL_ARGS,        // Exp -> ID LP Args RP
+    PROD_EXP_CALL,             // Exp -> ID LP RP
+    PROD_EXP_INDEX,            // Exp -> Exp LB Exp RB
+    PROD_EXP_DOT,              // Exp -> Exp DOT ID
+    PROD_EXP_ID,               // Exp -> ID
+    PROD_EXP_INT,              // Exp -> INT
+    PROD_EXP_FLOAT,            // Exp -> FLOAT
+    PROD_ARGS_MORE,            // Args -> Exp COMMA Args
+    PROD_ARGS_ONE              // Args -> Exp
+} Production;
+
 typedef enum _kind { BASIC, ARRAY, STRUCTURE, FUNCTION } Kind;
 typedef enum _basicType { INT_TYPE, FLOAT_TYPE } BasicType;
 typedef enum _errorType {
@@ -60,9 +174,10 @@ typedef enum _errorType {
 typedef struct node {
     int lineNo;  //  node in which line
     //   int depth;   //  node depth, for count white space for print
-    NodeType type;  // node type
-    char* name;     //  node name
-    char* val;      //  node value
+    NodeType type;    // node type
+    Symbol symbol;    // grammar symbol
+    Production prod;  // production reduced to this node, PROD_TOKEN for tokens
+    char* val;        //  node value
 
     struct node* child;  //  non-terminals node first child node
     struct node* next;   //  non-terminals node next brother node
@@ -72,6 +187,74 @@ typedef struct node {
 typedef unsigned boolean;
 typedef Node* pNode;
 
+// 语法树内存池：一次编译中所有Node以及词法单元字符串都从这里按顺序切分，
+// 释放语法树时只需要整体重置，不再逐个free
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define ARENA_ALIGN 8
+
+typedef struct arenaBlock {
+    struct arenaBlock* next;
+    size_t used;
+    size_t cap;
+    char data[];
+} ArenaBlock;
+
+typedef struct arena {
+    ArenaBlock* head;  // 当前正在切分的块
+    ArenaBlock* full;  // 已用满的块
+} Arena;
+
+typedef Arena* pArena;
+
+extern Arena treeArena;
+
+static inline void* arenaAlloc(pArena arena, size_t size) {
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    ArenaBlock* block = arena->head;
+    if (block == NULL || block->used + size > block->cap) {
+        size_t cap = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        ArenaBlock* p = (ArenaBlock*)malloc(sizeof(ArenaBlock) + cap);
+        assert(p != NULL);
+        p->used = 0;
+        p->cap = cap;
+        if (block != NULL) {
+            block->next = arena->full;
+            arena->full = block;
+        }
+        p->next = NULL;
+        arena->head = block = p;
+    }
+    void* p = block->data + block->used;
+    block->used += size;
+    return p;
+}
+
+static inline char* arenaString(pArena arena, char* src) {
+    if (src == NULL) return NULL;
+    size_t length = strlen(src) + 1;
+    char* p = (char*)arenaAlloc(arena, length);
+    memcpy(p, src, length);
+    return p;
+}
+
+// 保留当前块供下一次编译复用，其余块归还系统
+static inline void arenaReset(pArena arena) {
+    ArenaBlock* p = arena->full;
+    while (p) {
+        ArenaBlock* temp = p;
+        p = p->next;
+        free(temp);
+    }
+    arena->full = NULL;
+    if (arena->head) arena->head->used = 0;
+}
+
+static inline void arenaFree(pArena arena) {
+    arenaReset(arena);
+    free(arena->head);
+    arena->head = NULL;
+}
+
 static inline char* newString(char* src) {
     if (src == NULL) return NULL;
     int length = strlen(src) + 1;
@@ -81,25 +264,16 @@ static inline char* newString(char* src) {
     return p;
 }
 
-static inline pNode newNode(int lineNo, NodeType type, char* name, int argc,
-                            ...) {
-    pNode curNode = NULL;
-    // int nameLength = strlen(name) + 1;
-
-    curNode = (pNode)malloc(sizeof(Node));
-
-    assert(curNode != NULL);
-
-    // curNode->name = (char*)malloc(sizeof(char) * NAME_LENGTH);
-    // curNode->val = (char*)malloc(sizeof(char) * VAL_LENGTH);
-    // curNode->name = (char*)malloc(sizeof(char) * nameLength);
-    // assert(curNode->name != NULL);
-    // // assert(curNode->val != NULL);
+static inline pNode newNode(int lineNo, Symbol symbol, Production prod,
+                            int argc, ...) {
+    pNode curNode = (pNode)arenaAlloc(&treeArena, sizeof(Node));
 
     curNode->lineNo = lineNo;
-    curNode->type = type;
-    curNode->name = newString(name);
-    // strncpy(curNode->name, name, nameLength);
+    curNode->type = NOT_A_TOKEN;
+    curNode->symbol = symbol;
+    curNode->prod = prod;
+    curNode->val = NULL;
+    curNode->next = NULL;
 
     va_list vaList;
     va_start(vaList, argc);
@@ -119,28 +293,17 @@ static inline pNode newNode(int lineNo, NodeType type, char* name, int argc,
     return curNode;
 }
 
-static inline pNode newTokenNode(int lineNo, NodeType type, char* tokenName,
+static inline pNode newTokenNode(int lineNo, NodeType type, Symbol symbol,
                                  char* tokenText) {
-    pNode tokenNode = (pNode)malloc(sizeof(Node));
-    // int nameLength = strlen(tokenName) + 1;
-    // int textLength = strlen(tokenText) + 1;
-
-    assert(tokenNode != NULL);
+    pNode tokenNode = (pNode)arenaAlloc(&treeArena, sizeof(Node));
 
     tokenNode->lineNo = lineNo;
     tokenNode->type = type;
-
-    // tokenNode->name = (char*)malloc(sizeof(char) * nameLength);
-    // tokenNode->val = (char*)malloc(sizeof(char) * textLength);
-
-    // assert(tokenNode->name != NULL);
-    // assert(tokenNode->val != NULL);
-
-    // strncpy(tokenNode->name, tokenName, nameLength);
-    // strncpy(tokenNode->val, tokenText, textLength);
-
-    tokenNode->name = newString(tokenName);
-    tokenNode->val = newString(tokenText);
+    tokenNode->symbol = symbol;
+    tokenNode->prod = PROD_TOKEN;
+    // ID的文本已经由词法分析器驻留，直接保存句柄
+    tokenNode->val =
+        type == TOKEN_ID ? tokenText : arenaString(&treeArena, tokenText);
 
     tokenNode->child = NULL;
     tokenNode->next = NULL;
@@ -148,18 +311,29 @@ static inline pNode newTokenNode(int lineNo, NodeType type, char* tokenName,
     return tokenNode;
 }
 
+// 所有结点都属于treeArena，整棵树一次性释放
 static inline void delNode(pNode* node) {
     if (node == NULL) return;
-    pNode p = *node;
-    while (p->child != NULL) {
-        pNode temp = p->child;
-        p->child = p->child->next;
-        delNode(&temp);
-    }
-    free(p->name);
-    free(p->val);
-    free(p);
-    p = NULL;
+    arenaReset(&treeArena);
+    *node = NULL;
+}
+
+// 文法符号的名字只在打印语法树时使用
+static inline char* symbolName(Symbol symbol) {
+    static char* names[] = {
+        "INT",       "FLOAT",      "ID",       "TYPE",
+        "COMMA",     "DOT",        "SEMI",     "RELOP",
+        "ASSIGNOP",  "PLUS",       "MINUS",    "STAR",
+        "DIV",       "AND",        "OR",       "NOT",
+        "LP",        "RP",         "LB",       "RB",
+        "LC",        "RC",         "IF",       "ELSE",
+        "WHILE",     "STRUCT",     "RETURN",   "Program",
+        "ExtDefList", "ExtDef",    "ExtDecList", "Specifier",
+        "StructSpecifier", "OptTag", "Tag",    "VarDec",
+        "FunDec",    "VarList",    "ParamDec", "CompSt",
+        "StmtList",  "Stmt",       "DefList",  "Def",
+        "DecList",   "Dec",        "Exp",      "Args"};
+    return names[symbol];
 }
 
 static inline void printTreeInfo(pNode curNode, int height) {
@@ -170,7 +344,7 @@ static inline void printTreeInfo(pNode curNode, int height) {
     for (int i = 0; i < height; i++) {
         printf("  ");
     }
-    printf("%s", curNode->name);
+    printf("%s", symbolName(curNode->symbol));
     if (curNode->type == NOT_A_TOKEN) {
         printf(" (%d)", curNode->lineNo);
     } else if (curNode->type == TOKEN_TYPE || curNode->type == TOKEN_ID ||
@@ -0,0 +1,951 @@
+#include "cfg.h"
+#include "optimize.h"
+
+boolean optStats = FALSE;
+boolean optCse = TRUE;
+boolean optLicm = TRUE;
+boolean optInline = TRUE;
+boolean optSsa = TRUE;
+boolean optLinearScan = FALSE;
+
+boolean setOptFlag(char* flag) {
+    boolean on = strncmp(flag, "no-", 3) != 0;
+    if (!on) flag += 3;
+    if (!strcmp(flag, "cse"))
+        optCse = on;
+    else if (!strcmp(flag, "licm"))
+        optLicm = on;
+    else if (!strcmp(flag, "inline"))
+        optInline = on;
+    else if (!strcmp(flag, "ssa"))
+        optSsa = on;
+    else if (on && !strcmp(flag, "regalloc=linear"))
+        optLinearScan = TRUE;
+    else if (on && !strcmp(flag, "regalloc=color"))
+        optLinearScan = FALSE;
+    else
+        return FALSE;
+    return TRUE;
+}
+
+// 折叠出的GOTO要等窥孔合并了块才能接着传播，指令数不再减少就停
+static void simplify(pInterCodeList list) {
+    for (int round = 0; round < OPT_MAX_ROUNDS; round++) {
+        int before = list->codeNum;
+        peephole(list);
+        propagateCopies(list);
+        foldConstants(list);
+        eliminateDeadCode(list);
+        if (list->codeNum == before) break;
+    }
+}
+
+// SSA上的常量传播和值编号跨块做，回到普通代码后名字变了，下标要重新编
+static void simplifySsa(pInterCodeList list, boolean numbering) {
+    int before = list->codeNum;
+    runSsaPasses(list, numbering);
+    deleteValueIndex();
+    initValueIndex(list);
+    simplify(list);
+    if (optStats)
+        fprintf(stderr, "ssa: %d -> %d instructions\n", before, list->codeNum);
+}
+
+void optimize(pInterCodeList list, int level) {
+    if (level <= 0) return;
+    if (optInline) inlineCalls(list);
+    initValueIndex(list);
+    coalesceCopies(list);
+    simplify(list);
+    // 值编号跨块复用的地址会挡住强度削弱，先只传播常量，循环优化之后再编号
+    if (optSsa) simplifySsa(list, FALSE);
+    if (optCse) {
+        int before = list->codeNum;
+        if (numberValues(list)) simplify(list);
+        if (optStats)
+            fprintf(stderr, "cse: %d -> %d instructions\n", before,
+                    list->codeNum);
+    }
+    // 常量都折叠完再做循环优化；削弱时新开了临时变量，下标要重新编
+    int changed = optLicm ? hoistInvariants(list) : 0;
+    changed += reduceStrength(list);
+    if (changed) {
+        deleteValueIndex();
+        initValueIndex(list);
+        simplify(list);
+    }
+    if (optSsa) simplifySsa(list, optCse);
+    peephole(list);
+    deleteValueIndex();
+}
+
+// 变量名 -> 下标，名字都是驻留过的，按指针比较
+static char** varNames = NULL;
+static int* varIndexes = NULL;
+static unsigned varCap = 0;
+int valueNum = 0;
+
+void initValueIndex(pInterCodeList list) {
+    valueNum = list->tempVarNum;
+    varCap = 64;
+    while (varCap < (unsigned)list->operandNum * 2) varCap *= 2;
+    varNames = (char**)calloc(varCap, sizeof(char*));
+    varIndexes = (int*)malloc(sizeof(int) * varCap);
+    assert(varNames != NULL && varIndexes != NULL);
+    for (int i = 1; i < list->operandNum; i++) {
+        pOperand op = &list->operands[i];
+        if (op->kind != OP_VARIABLE) continue;
+        unsigned h = internHash(op->u.name) & (varCap - 1);
+        while (varNames[h] && varNames[h] != op->u.name) h = (h + 1) & (varCap - 1);
+        if (varNames[h] == NULL) {
+            varNames[h] = op->u.name;
+            varIndexes[h] = valueNum++;
+        }
+    }
+}
+
+void deleteValueIndex() {
+    free(varNames);
+    free(varIndexes);
+    varNames = NULL;
+    varIndexes = NULL;
+}
+
+int valueIndex(OperandId id) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_TEMP) return op->u.no;
+    if (op->kind != OP_VARIABLE) return -1;
+    unsigned h = internHash(op->u.name) & (varCap - 1);
+    while (varNames[h] != op->u.name) {
+        assert(varNames[h] != NULL);
+        h = (h + 1) & (varCap - 1);
+    }
+    return varIndexes[h];
+}
+
+// 常量折叠：基本块内记录值已知为常量的临时变量和变量，读它们的地方
+// 直接换成立即数。局部变量不会被取址（只有数组和结构体会），函数调用
+// 也改不到它们，所以块内的记录只在标签处失效；条件跳转落空后仍在同一块里。
+static int* constVal;    // valueIndex -> 常量值
+static int* constBlock;  // 记录时所在的块号，不等于当前块号即失效
+static int curBlock;
+
+static boolean getConst(OperandId id, int* val) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT) {
+        *val = op->u.value;
+        return TRUE;
+    }
+    int idx = valueIndex(id);
+    if (idx >= 0 && constBlock[idx] == curBlock) {
+        *val = constVal[idx];
+        return TRUE;
+    }
+    return FALSE;
+}
+
+static boolean isConst(OperandId id, int val) {
+    int v;
+    return getConst(id, &v) && v == val;
+}
+
+void foldConstants(pInterCodeList list) {
+    int n = valueNum;
+    constVal = (int*)malloc(sizeof(int) * n);
+    constBlock = (int*)malloc(sizeof(int) * n);
+    assert(constVal != NULL && constBlock != NULL);
+    for (int i = 0; i < n; i++) constBlock[i] = -1;
+    curBlock = 0;
+
+    int folded = 0, simplified = 0, branches = 0;
+    int out = 0;
+    for (int i = 0; i < list->codeNum; i++) {
+        pInterCode code = &list->codes[i];
+        if (code->kind == IR_LABEL || code->kind == IR_FUNCTION) curBlock++;
+
+        // 读取的值若已知是常量，换成立即数；地址操作数不动
+        OperandId* slots[3];
+        int useNum = getUseSlots(code, slots);
+        for (int j = 0; j < useNum; j++) {
+            int v;
+            pOperand op = getOperand(*slots[j]);
+            if (op->kind != OP_CONSTANT && !op->isAddr && getConst(*slots[j], &v))
+                *slots[j] = newOperand(OP_CONSTANT, v);
+        }
+
+        int a, b, res;
+        boolean drop = FALSE;
+        switch (code->kind) {
+            case IR_ADD:
+            case IR_SUB:
+            case IR_MUL:
+            case IR_DIV: {
+                OperandId result = code->u.binOp.result;
+                OperandId op1 = code->u.binOp.op1, op2 = code->u.binOp.op2;
+                if (getConst(op1, &a) && getConst(op2, &b) &&
+                    evalBinOp(code->kind, a, b, &res)) {
+                    toAssign(code, result, newOperand(OP_CONSTANT, res));
+                    folded++;
+                }
+                // x*0, 0*x
+                else if (code->kind == IR_MUL &&
+                         (isConst(op1, 0) || isConst(op2, 0))) {
+                    toAssign(code, result, newOperand(OP_CONSTANT, 0));
+                    simplified++;
+                }
+                // x+0, x-0, x*1, x/1
+                else if (((code->kind == IR_ADD || code->kind == IR_SUB) &&
+                          isConst(op2, 0)) ||
+                         ((code->kind == IR_MUL || code->kind == IR_DIV) &&
+                          isConst(op2, 1))) {
+                    toAssign(code, result, op1);
+                    simplified++;
+                }
+                // 0+x, 1*x
+                else if ((code->kind == IR_ADD && isConst(op1, 0)) ||
+                         (code->kind == IR_MUL && isConst(op1, 1))) {
+                    toAssign(code, result, op2);
+                    simplified++;
+                }
+                break;
+            }
+            case IR_IF_GOTO:
+                if (getConst(code->u.ifGoto.x, &a) &&
+                    getConst(code->u.ifGoto.y, &b)) {
+                    if (evalRelop(getOperand(code->u.ifGoto.relop)->u.relop, a, b)) {
+                        OperandId label = code->u.ifGoto.z;
+                        code->kind = IR_GOTO;
+                        code->u.oneOp.op = label;
+                    } else {
+                        drop = TRUE;
+                    }
+                    branches++;
+                }
+                break;
+            default:
+                break;
+        }
+
+        // 记录或作废被写入的值
+        OperandId def = getDef(code);
+        int idx = def ? valueIndex(def) : -1;
+        if (idx >= 0) {
+            if (code->kind == IR_ASSIGN && getConst(code->u.assign.right, &res)) {
+                constVal[idx] = res;
+                constBlock[idx] = curBlock;
+            } else {
+                constBlock[idx] = -1;
+            }
+        }
+
+        if (!drop) list->codes[out++] = *code;
+    }
+    list->codeNum = out;
+
+    free(constVal);
+    free(constBlock);
+    if (optStats)
+        fprintf(stderr, "fold: %d folded, %d simplified, %d branches\n",
+                folded, simplified, branches);
+}
+
+// 按dead标记就地压缩指令数组
+static void removeMarked(pInterCodeList list, char* dead) {
+    int out = 0;
+    for (int i = 0; i < list->codeNum; i++)
+        if (!dead[i]) list->codes[out++] = list->codes[i];
+    list->codeNum = out;
+}
+
+// t := e; x := t，且t只定值一次、只在这里读一次：改成 x := e。
+// 翻译赋值语句和带初值的声明时到处都是这种写法
+void coalesceCopies(pInterCodeList list) {
+    int* useCount = (int*)calloc(list->tempVarNum, sizeof(int));
+    int* defCount = (int*)calloc(list->tempVarNum, sizeof(int));
+    assert(useCount != NULL && defCount != NULL);
+    OperandId* slots[3];
+    for (int i = 0; i < list->codeNum; i++) {
+        pInterCode code = &list->codes[i];
+        int useNum = getUseSlots(code, slots);
+        for (int j = 0; j < useNum; j++)
+            if (isTemp(*slots[j])) useCount[getOperand(*slots[j])->u.no]++;
+        OperandId def = getDef(code);
+        if (isTemp(def)) defCount[getOperand(def)->u.no]++;
+    }
+
+    int removed = 0, out = 0;
+    for (int i = 0; i < list->codeNum; i++) {
+        pInterCode code = &list->codes[i];
+        OperandId* def = getDefSlot(code);
+        list->codes[out++] = *code;
+        if (def == NULL || !isTemp(*def) || i + 1 == list->codeNum) continue;
+        int no = getOperand(*def)->u.no;
+        pInterCode next = &list->codes[i + 1];
+        if (next->kind == IR_ASSIGN && isTemp(next->u.assign.right) &&
+            getOperand(next->u.assign.right)->u.no == no &&
+            useCount[no] == 1 && defCount[no] == 1) {
+            *getDefSlot(&list->codes[out - 1]) = next->u.assign.left;
+            i++;
+            removed++;
+        }
+    }
+    list->codeNum = out;
+
+    free(useCount);
+    free(defCount);
+    if (optStats) fprintf(stderr, "coalesce: %d copies removed\n", removed);
+}
+
+// 复写传播。块内：x := y 之后、x和y都没被重新定值之前，读x的地方换成y，
+// y被改写与否靠版本号判断，不必去找所有以y为源的复写。
+// 全局：x在函数里只定值一次且是 x := y，y是常量或同样只定值一次、
+// 且定值支配这里的名字，那么被这次定值支配的每个x都可以换成y
+static int* version;      // valueIndex -> 被定值的次数
+static int* localSrc;     // 块内复写的源
+static int* localStamp;   // 记录时的块号
+static int* localVer;     // 记录时源的版本
+static int* defCount;     // 函数内的定值次数
+static int* defStamp;     // 计数所属的函数
+static int* globalSrc;    // 全局复写的源，只对单定值的名字有效
+static int* defBlock;     // 单定值的名字在哪个块、哪条指令定值
+static int* defPos;
+static int* defSeen;      // 遍历时已经走过它的定值
+
+static boolean isSingleDef(int v, int func) {
+    return defStamp[v] == func && defCount[v] == 1;
+}
+
+// (block, pos)处的定值是否支配(b, i)
+static boolean defDominates(pCfg cfg, int v, int b, int i) {
+    if (defBlock[v] == b) return defPos[v] < i;
+    return dominates(cfg, defBlock[v], b);
+}
+
+static int propagateInFunction(pInterCodeList list, int start, int* blockStamp) {
+    pCfg cfg = newCfg(list, start);
+    int func = start + 1;  // 函数的编号，避开初始的0
+    for (int i = cfg->funcStart; i < cfg->funcEnd; i++) {
+        OperandId def = getDef(&list->codes[i]);
+        int v = def ? valueIndex(def) : -1;
+        if (v < 0) continue;
+        if (defStamp[v] != func) {
+            defStamp[v] = func;
+            defCount[v] = 0;
+            defSeen[v] = -1;
+        }
+        defCount[v]++;
+    }
+
+    int replaced = 0;
+    OperandId* slots[3];
+    forEachRpo(cfg, b) {
+        int stamp = ++*blockStamp;
+        for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+            pInterCode code = &list->codes[i];
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int v = valueIndex(*slots[j]);
+                if (v < 0) continue;
+                OperandId src = NO_OPERAND;
+                if (localStamp[v] == stamp &&
+                    (localVer[v] < 0 ||
+                     version[valueIndex(localSrc[v])] == localVer[v]))
+                    src = localSrc[v];
+                else if (isSingleDef(v, func) && globalSrc[v] &&
+                         defSeen[v] == func && defDominates(cfg, v, b, i))
+                    src = globalSrc[v];
+                // *t 里的t不能换成立即数
+                if (src == NO_OPERAND ||
+                    (getOperand(*slots[j])->isAddr &&
+                     getOperand(src)->kind == OP_CONSTANT))
+                    continue;
+                *slots[j] = src;
+                replaced++;
+            }
+
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            if (v < 0) continue;
+            version[v]++;
+            localStamp[v] = -1;
+            if (isSingleDef(v, func)) {
+                defSeen[v] = func;
+                defBlock[v] = b;
+                defPos[v] = i;
+                globalSrc[v] = NO_OPERAND;
+            }
+            if (code->kind != IR_ASSIGN) continue;
+            OperandId right = code->u.assign.right;
+            if (getOperand(right)->isAddr) continue;
+            int r = valueIndex(right);
+            if (r == v) continue;
+            if (r < 0 && getOperand(right)->kind != OP_CONSTANT) continue;
+            localSrc[v] = right;
+            localStamp[v] = stamp;
+            localVer[v] = r < 0 ? -1 : version[r];
+            if (isSingleDef(v, func) &&
+                (r < 0 || (isSingleDef(r, func) && defSeen[r] == func &&
+                           defDominates(cfg, r, b, i))))
+                globalSrc[v] = right;
+        }
+    }
+    deleteCfg(cfg);
+    return replaced;
+}
+
+void propagateCopies(pInterCodeList list) {
+    int n = valueNum;
+    version = (int*)calloc(n, sizeof(int));
+    localSrc = (int*)malloc(sizeof(int) * n);
+    localStamp = (int*)calloc(n, sizeof(int));
+    localVer = (int*)malloc(sizeof(int) * n);
+    defCount = (int*)malloc(sizeof(int) * n);
+    defStamp = (int*)calloc(n, sizeof(int));
+    globalSrc = (int*)malloc(sizeof(int) * n);
+    defBlock = (int*)malloc(sizeof(int) * n);
+    defPos = (int*)malloc(sizeof(int) * n);
+    defSeen = (int*)malloc(sizeof(int) * n);
+    assert(version && localSrc && localStamp && localVer && defCount &&
+           defStamp && globalSrc && defBlock && defPos && defSeen);
+
+    int replaced = 0, blockStamp = 0;
+    for (int i = 0; i < list->codeNum; i = nextFunction(list, i))
+        if (list->codes[i].kind == IR_FUNCTION)
+            replaced += propagateInFunction(list, i, &blockStamp);
+
+    free(version);
+    free(localSrc);
+    free(localStamp);
+    free(localVer);
+    free(defCount);
+    free(defStamp);
+    free(globalSrc);
+    free(defBlock);
+    free(defPos);
+    free(defSeen);
+    if (optStats) fprintf(stderr, "copyprop: %d uses replaced\n", replaced);
+}
+
+// 基本块内的值编号。名字和算出来的值都编上号，(运算, 操作数的编号)
+// 在块里出现过、存放它的名字也还没被改写，这条指令就改成从那个名字复写，
+// 多出来的复写交给后面的复写传播和死代码删除。
+// 取址在两次DEC之间不变；读内存还要看内存的版本，写内存、函数调用
+// 和DEC之后版本加一，写内存之后读同一个地址直接用写进去的值
+#define KEY_CONST (-1)
+
+typedef struct _valueKey {
+    int kind, a, b, epoch;
+    int stamp;  // 所属的块，不是当前块的就当空位
+    int vn;
+} ValueKey;
+
+static ValueKey* keyTable;
+static unsigned keyCap;
+static int* nameVn;  // valueIndex -> 当前块里的值编号
+static int* nameStamp;
+static OperandId* holder;  // 值编号 -> 存放它的名字或立即数
+static int vnNum, vnCap;
+static int curStamp;
+
+// 存放者要当值用，带isAddr的换成同号的普通临时变量
+static OperandId plainOperand(OperandId id) {
+    pOperand p = getOperand(id);
+    return p->isAddr ? newOperand(p->kind, p->u.no) : id;
+}
+
+static int newVn(OperandId op) {
+    if (vnNum == vnCap) {
+        vnCap = vnCap ? vnCap * 2 : 256;
+        holder = (OperandId*)realloc(holder, sizeof(OperandId) * vnCap);
+        assert(holder != NULL);
+    }
+    holder[vnNum] = plainOperand(op);
+    return vnNum++;
+}
+
+static boolean holderValid(int vn) {
+    OperandId op = holder[vn];
+    if (getOperand(op)->kind == OP_CONSTANT) return TRUE;
+    int v = valueIndex(op);
+    return nameStamp[v] == curStamp && nameVn[v] == vn;
+}
+
+static ValueKey* findKey(int kind, int a, int b, int epoch) {
+    unsigned h = (unsigned)kind * 31u + (unsigned)a;
+    h = h * 2654435761u + (unsigned)b;
+    h = (h * 2654435761u + (unsigned)epoch) & (keyCap - 1);
+    while (keyTable[h].stamp == curStamp) {
+        ValueKey* k = &keyTable[h];
+        if (k->kind == kind && k->a == a && k->b == b && k->epoch == epoch)
+            return k;
+        h = (h + 1) & (keyCap - 1);
+    }
+    keyTable[h].kind = kind;
+    keyTable[h].a = a;
+    keyTable[h].b = b;
+    keyTable[h].epoch = epoch;
+    keyTable[h].vn = -1;  // 新的键，由调用者填上编号后生效
+    return &keyTable[h];
+}
+
+static int getVn(OperandId id) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT) {
+        ValueKey* k = findKey(KEY_CONST, op->u.value, 0, 0);
+        if (k->vn < 0 || k->stamp != curStamp) {
+            k->stamp = curStamp;
+            k->vn = newVn(id);
+        }
+        return k->vn;
+    }
+    int v = valueIndex(id);
+    if (nameStamp[v] != curStamp) {
+        nameStamp[v] = curStamp;
+        nameVn[v] = newVn(id);
+    }
+    return nameVn[v];
+}
+
+static void setVn(OperandId id, int vn) {
+    int v = valueIndex(id);
+    if (v < 0) return;
+    nameStamp[v] = curStamp;
+    nameVn[v] = vn;
+    if (!holderValid(vn)) holder[vn] = plainOperand(id);
+}
+
+int numberValues(pInterCodeList list) {
+    int maxLen = 1, len = 0;
+    for (int i = 0; i < list->codeNum; i++) {
+        int kind = list->codes[i].kind;
+        len = kind == IR_LABEL || kind == IR_FUNCTION ? 1 : len + 1;
+        if (len > maxLen) maxLen = len;
+    }
+    keyCap = 64;
+    while (keyCap < (unsigned)maxLen * 4) keyCap *= 2;
+    keyTable = (ValueKey*)calloc(keyCap, sizeof(ValueKey));
+    nameVn = (int*)malloc(sizeof(int) * valueNum);
+    nameStamp = (int*)calloc(valueNum, sizeof(int));
+    assert(keyTable && nameVn && nameStamp);
+    curStamp = 1;
+    vnNum = 0;
+
+    int exprs = 0, addrs = 0, loads = 0;
+    int memEpoch = 0, allocEpoch = 0;
+    for (int i = 0; i < list->codeNum; i++) {
+        pInterCode code = &list->codes[i];
+        ValueKey* key = NULL;
+        int a, b;
+        switch (code->kind) {
+            case IR_LABEL:
+            case IR_FUNCTION:
+                curStamp++;
+                vnNum = 0;
+                break;
+            case IR_ADD:
+            case IR_MUL:
+            case IR_SUB:
+            case IR_DIV:
+                a = getVn(code->u.binOp.op1);
+                b = getVn(code->u.binOp.op2);
+                if ((code->kind == IR_ADD || code->kind == IR_MUL) && a > b) {
+                    int t = a;
+                    a = b;
+                    b = t;
+                }
+                key = findKey(code->kind, a, b, 0);
+                break;
+            case IR_GET_ADDR:
+                key = findKey(IR_GET_ADDR, valueIndex(code->u.assign.right), 0,
+                              allocEpoch);
+                break;
+            case IR_READ_ADDR:
+                key = findKey(IR_READ_ADDR, getVn(code->u.assign.right), 0,
+                              memEpoch);
+                break;
+            case IR_ASSIGN:
+                setVn(code->u.assign.left, getVn(code->u.assign.right));
+                break;
+            case IR_WRITE_ADDR:
+                a = getVn(code->u.assign.left);
+                b = getVn(code->u.assign.right);
+                key = findKey(IR_READ_ADDR, a, 0, ++memEpoch);
+                key->stamp = curStamp;
+                key->vn = b;
+                key = NULL;
+                break;
+            case IR_DEC:
+                memEpoch++;
+                allocEpoch++;
+                break;
+            case IR_CALL:
+                memEpoch++;
+                setVn(code->u.assign.left, newVn(code->u.assign.left));
+                break;
+            default: {
+                OperandId def = getDef(code);
+                if (def) setVn(def, newVn(def));
+                break;
+            }
+        }
+        if (key == NULL) continue;
+
+        OperandId def = getDef(code);
+        // i := i + c 留着原样，强度削弱要靠它认出归纳变量
+        boolean update = code->kind >= IR_ADD && code->kind <= IR_DIV &&
+                         (valueIndex(code->u.binOp.op1) == valueIndex(def) ||
+                          valueIndex(code->u.binOp.op2) == valueIndex(def));
+        if (key->stamp == curStamp && holderValid(key->vn) && !update) {
+            if (code->kind == IR_GET_ADDR)
+                addrs++;
+            else if (code->kind == IR_READ_ADDR)
+                loads++;
+            else
+                exprs++;
+            toAssign(code, def, holder[key->vn]);
+            setVn(def, key->vn);
+        } else if (key->stamp == curStamp) {
+            setVn(def, key->vn);
+        } else {
+            key->stamp = curStamp;
+            key->vn = newVn(def);
+            setVn(def, key->vn);
+        }
+    }
+
+    free(keyTable);
+    free(nameVn);
+    free(nameStamp);
+    free(holder);
+    holder = NULL;
+    vnCap = 0;
+    if (optStats)
+        fprintf(stderr, "lvn: %d expressions, %d addresses, %d loads reused\n",
+                exprs, addrs, loads);
+    return exprs + addrs + loads;
+}
+
+// 基于活跃变量的死代码删除。只有在某块里先读后写（向上暴露）的名字
+// 才可能跨块活跃，数据流只对这些全局名字做位向量；
+// 其余名字只在块内活跃，倒着扫块时用时间戳记录
+static int* globalIndex;  // valueIndex -> 全局名字的编号，-1表示块内名字
+static int* globalStamp;
+static int* liveStamp;    // 块内名字在当前扫描中是否活跃
+
+static int eliminateInFunction(pInterCodeList list, int start, char* dead,
+                               int* scanStamp) {
+    pCfg cfg = newCfg(list, start);
+    OperandId* slots[3];
+
+    // 找出全局名字
+    int globalNum = 0;
+    forEachBlock(cfg, b) {
+        int stamp = ++*scanStamp;
+        forEachCode(cfg, b, code) {
+            if (dead[code - list->codes]) continue;
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int v = valueIndex(*slots[j]);
+                if (v < 0 || liveStamp[v] == stamp) continue;
+                if (globalStamp[v] != start) {
+                    globalStamp[v] = start;
+                    globalIndex[v] = globalNum++;
+                }
+            }
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            if (v >= 0) liveStamp[v] = stamp;  // 这里借来标记“块内已定值”
+        }
+    }
+
+    // 每块的use/def位向量，再迭代求liveOut
+    int words = (globalNum + WORD_BITS - 1) / WORD_BITS;
+    if (words == 0) words = 1;
+    int n = cfg->blockNum;
+    Word* sets = (Word*)calloc((size_t)n * words * 3, sizeof(Word));
+    assert(sets != NULL);
+    Word* ueSets = sets;
+    Word* killSets = sets + (size_t)n * words;
+    Word* liveIn = sets + (size_t)n * words * 2;
+    Word* liveOut = (Word*)malloc(sizeof(Word) * words);
+    assert(liveOut != NULL);
+    forEachBlock(cfg, b) {
+        Word* ue = ueSets + (size_t)b * words;
+        Word* kill = killSets + (size_t)b * words;
+        forEachCode(cfg, b, code) {
+            if (dead[code - list->codes]) continue;
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int v = valueIndex(*slots[j]);
+                if (v < 0 || globalStamp[v] != start) continue;
+                if (!testBit(kill, globalIndex[v])) setBit(ue, globalIndex[v]);
+            }
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            if (v >= 0 && globalStamp[v] == start) setBit(kill, globalIndex[v]);
+        }
+    }
+
+    // liveIn = ue | (liveOut - kill)，按后序迭代到不动点
+    boolean changed = TRUE;
+    while (changed) {
+        changed = FALSE;
+        for (int i = cfg->rpoNum - 1; i >= 0; i--) {
+            int b = cfg->rpo[i];
+            memset(liveOut, 0, sizeof(Word) * words);
+            forEachSucc(cfg, b, s) {
+                Word* in = liveIn + (size_t)s * words;
+                for (int w = 0; w < words; w++) liveOut[w] |= in[w];
+            }
+            Word* in = liveIn + (size_t)b * words;
+            Word* ue = ueSets + (size_t)b * words;
+            Word* kill = killSets + (size_t)b * words;
+            for (int w = 0; w < words; w++) {
+                Word val = ue[w] | (liveOut[w] & ~kill[w]);
+                if (val != in[w]) {
+                    in[w] = val;
+                    changed = TRUE;
+                }
+            }
+        }
+    }
+
+    // 倒着扫每块，删掉结果不活跃的纯计算；不可达的块整块删掉
+    int removed = 0;
+    forEachBlock(cfg, b) {
+        pBlock block = &cfg->blocks[b];
+        if (block->rpo < 0) {
+            for (int i = block->first; i < block->last; i++) {
+                // 标签可能还被别处跳转引用，留给后面的窥孔优化
+                if (!dead[i] && list->codes[i].kind != IR_LABEL &&
+                    list->codes[i].kind != IR_FUNCTION) {
+                    dead[i] = 1;
+                    removed++;
+                }
+            }
+            continue;
+        }
+        memset(liveOut, 0, sizeof(Word) * words);
+        forEachSucc(cfg, b, s) {
+            Word* in = liveIn + (size_t)s * words;
+            for (int w = 0; w < words; w++) liveOut[w] |= in[w];
+        }
+        int stamp = ++*scanStamp;
+        for (int i = block->last - 1; i >= block->first; i--) {
+            if (dead[i]) continue;
+            pInterCode code = &list->codes[i];
+            OperandId def = getDef(code);
+            int v = def ? valueIndex(def) : -1;
+            if (v >= 0) {
+                boolean live = globalStamp[v] == start
+                                   ? testBit(liveOut, globalIndex[v])
+                                   : liveStamp[v] == stamp;
+                if (!live && isPure(code)) {
+                    dead[i] = 1;
+                    removed++;
+                    continue;
+                }
+                if (globalStamp[v] == start)
+                    clearBit(liveOut, globalIndex[v]);
+                else
+                    liveStamp[v] = 0;
+            }
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int u = valueIndex(*slots[j]);
+                if (u < 0) continue;
+                if (globalStamp[u] == start)
+                    setBit(liveOut, globalIndex[u]);
+                else
+                    liveStamp[u] = stamp;
+            }
+        }
+    }
+
+    free(sets);
+    free(liveOut);
+    deleteCfg(cfg);
+    return removed;
+}
+
+void eliminateDeadCode(pInterCodeList list) {
+    int n = valueNum;
+    globalIndex = (int*)malloc(sizeof(int) * n);
+    globalStamp = (int*)malloc(sizeof(int) * n);
+    liveStamp = (int*)calloc(n, sizeof(int));
+    char* dead = (char*)calloc(list->codeNum, sizeof(char));
+    assert(globalIndex && globalStamp && liveStamp && dead);
+    for (int i = 0; i < n; i++) globalStamp[i] = -1;
+
+    // 删掉一条可能让它读的名字也变成死的，重复到不再有删除
+    int removed = 0, round, scanStamp = 0;
+    do {
+        round = 0;
+        for (int i = 0; i < list->codeNum; i = nextFunction(list, i))
+            if (list->codes[i].kind == IR_FUNCTION)
+                round += eliminateInFunction(list, i, dead, &scanStamp);
+        removed += round;
+        for (int i = 0; i < n; i++) globalStamp[i] = -1;
+    } while (round);
+    removeMarked(list, dead);
+
+    free(globalIndex);
+    free(globalStamp);
+    free(liveStamp);
+    free(dead);
+    if (optStats) fprintf(stderr, "dce: %d removed\n", removed);
+}
+
+// 窥孔优化，只动标签和跳转：
+//   相邻的标签合并成第一个；跳到 GOTO 的跳转直接跳到最终目标；
+//   IF c GOTO L1; GOTO L2; LABEL L1  =>  IF !c GOTO L2; LABEL L1；
+//   跳到紧接着的标签的 GOTO/IF 删掉；GOTO/RETURN 之后到下一个标签之前的指令删掉；
+//   没人引用的标签删掉。一轮的改动可能引出新的机会，重复到不动点
+static Relop invertRelop(Relop relop) {
+    switch (relop) {
+        case RELOP_LT: return RELOP_GE;
+        case RELOP_LE: return RELOP_GT;
+        case RELOP_GT: return RELOP_LE;
+        case RELOP_GE: return RELOP_LT;
+        case RELOP_EQ: return RELOP_NE;
+        default: return RELOP_EQ;
+    }
+}
+
+void peephole(pInterCodeList list) {
+    int labelNum = list->labelNum;
+    int* labelPos = (int*)malloc(sizeof(int) * labelNum);
+    int* rep = (int*)malloc(sizeof(int) * labelNum);     // 所在标签串的第一个
+    int* final = (int*)malloc(sizeof(int) * labelNum);   // 穿过GOTO链后的目标
+    int* state = (int*)malloc(sizeof(int) * labelNum);
+    int* refCount = (int*)malloc(sizeof(int) * labelNum);
+    OperandId* labelOp = (OperandId*)malloc(sizeof(OperandId) * labelNum);
+    int* chain = (int*)malloc(sizeof(int) * labelNum);
+    assert(labelPos && rep && final && state && refCount && labelOp && chain);
+
+    int inverted = 0, toNext = 0, threaded = 0, merged = 0, dropped = 0,
+        unreachable = 0;
+    boolean changed = TRUE;
+    while (changed) {
+        changed = FALSE;
+        pInterCode codes = list->codes;
+        int n = list->codeNum;
+        char* dead = (char*)calloc(n, sizeof(char));
+        assert(dead != NULL);
+
+        // 标签串
+        for (int i = 0; i < n; i++) {
+            if (codes[i].kind != IR_LABEL) continue;
+            int no = labelNo(codes[i].u.oneOp.op);
+            labelPos[no] = i;
+            labelOp[no] = codes[i].u.oneOp.op;
+            rep[no] = i > 0 && codes[i - 1].kind == IR_LABEL
+                          ? rep[labelNo(codes[i - 1].u.oneOp.op)]
+                          : no;
+            state[no] = 0;
+            refCount[no] = 0;
+        }
+
+        // 沿 标签串 -> GOTO 一路找下去，成环（死循环）就停在环上
+        for (int i = 0; i < n; i++) {
+            if (codes[i].kind != IR_LABEL) continue;
+            int cur = rep[labelNo(codes[i].u.oneOp.op)];
+            int len = 0;
+            while (state[cur] == 0) {
+                state[cur] = 1;
+                chain[len++] = cur;
+                int q = labelPos[cur];
+                while (q < n && codes[q].kind == IR_LABEL) q++;
+                if (q == n || codes[q].kind != IR_GOTO) break;
+                int next = rep[labelNo(codes[q].u.oneOp.op)];
+                if (state[next] == 1) break;
+                cur = next;
+            }
+            int to = state[cur] == 2 ? final[cur] : cur;
+            for (int k = 0; k < len; k++) {
+                final[chain[k]] = to;
+                state[chain[k]] = 2;
+            }
+        }
+
+        // 改写跳转目标
+        for (int i = 0; i < n; i++) {
+            OperandId* target = jumpTarget(&codes[i]);
+            if (target == NULL) continue;
+            int no = labelNo(*target);
+            int to = final[rep[no]];
+            if (to == no) continue;
+            if (to != rep[no]) threaded++;
+            *target = labelOp[to];
+            changed = TRUE;
+        }
+
+        for (int i = 0; i < n; i++) {
+            pInterCode code = &codes[i];
+            if (dead[i]) continue;
+            if (code->kind == IR_IF_GOTO && i + 2 < n &&
+                codes[i + 1].kind == IR_GOTO && codes[i + 2].kind == IR_LABEL &&
+                labelNo(codes[i + 2].u.oneOp.op) == labelNo(code->u.ifGoto.z)) {
+                Relop relop = getOperand(code->u.ifGoto.relop)->u.relop;
+                code->u.ifGoto.relop = newOperand(OP_RELOP, invertRelop(relop));
+                code->u.ifGoto.z = codes[i + 1].u.oneOp.op;
+                dead[i + 1] = 1;
+                inverted++;
+                changed = TRUE;
+                continue;
+            }
+            OperandId* target = jumpTarget(code);
+            if (target && i + 1 < n && codes[i + 1].kind == IR_LABEL &&
+                labelNo(codes[i + 1].u.oneOp.op) == labelNo(*target)) {
+                dead[i] = 1;
+                toNext++;
+                changed = TRUE;
+                continue;
+            }
+            if (code->kind == IR_GOTO || code->kind == IR_RETURN) {
+                for (int j = i + 1; j < n && codes[j].kind != IR_LABEL &&
+                                    codes[j].kind != IR_FUNCTION;
+                     j++) {
+                    dead[j] = 1;
+                    unreachable++;
+                    changed = TRUE;
+                }
+            }
+        }
+
+        // 标签串里除第一个以外的，引用都已改到第一个上，算作合并
+        for (int i = 0; i < n; i++) {
+            OperandId* target = jumpTarget(&codes[i]);
+            if (target && !dead[i]) refCount[labelNo(*target)]++;
+        }
+        for (int i = 0; i < n; i++) {
+            if (codes[i].kind != IR_LABEL || dead[i]) continue;
+            int no = labelNo(codes[i].u.oneOp.op);
+            if (refCount[no] == 0) {
+                dead[i] = 1;
+                if (rep[no] != no)
+                    merged++;
+                else
+                    dropped++;
+                changed = TRUE;
+            }
+        }
+
+        removeMarked(list, dead);
+        free(dead);
+    }
+
+    free(labelPos);
+    free(rep);
+    free(final);
+    free(state);
+    free(refCount);
+    free(labelOp);
+    free(chain);
+    if (optStats)
+        fprintf(stderr,
+                "peephole: %d inverted, %d jumps to next, %d threaded, "
+                "%d labels merged, %d labels dropped, %d unreachable\n",
+                inverted, toNext, threaded, merged, dropped, unreachable);
+}
+
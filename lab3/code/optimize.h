@@ -0,0 +1,130 @@
+#ifndef OPTIMIZE_H
+#define OPTIMIZE_H
+#include <limits.h>
+#include "inter.h"
+
+#define OPT_MAX_ROUNDS 8
+// 内联：函数体不超过INLINE_MAX_SIZE条，或者只有一个调用点且不超过
+// INLINE_MAX_ONCE条；内联后调用者不超过INLINE_MAX_FUNC条
+#define INLINE_MAX_SIZE 24
+#define INLINE_MAX_ONCE 400
+#define INLINE_MAX_FUNC 4000
+
+// 中间代码优化，在genInterCodes之后、printInterCode之前运行。
+// 各遍都直接改写interCodeList里的指令数组，删掉的指令就地压缩掉。
+
+extern boolean optStats;  // 每遍结束后向stderr打印统计
+extern boolean optCse;    // 块内公共子表达式删除，-fno-cse关掉
+extern boolean optLicm;   // 循环不变量外提，-fno-licm关掉
+extern boolean optInline; // 函数内联，-fno-inline关掉
+extern boolean optSsa;    // SSA上的全局常量传播和值编号，-fno-ssa关掉
+extern boolean optLinearScan; // 寄存器分配用线性扫描，-fregalloc=linear打开
+
+void optimize(pInterCodeList list, int level);
+boolean setOptFlag(char* flag);  // -f之后的部分，不认识时返回FALSE
+
+// 把临时变量和源程序变量统一编成0..valueNum-1，供各遍按下标开数组。
+// 临时变量就是它的编号，变量按名字排在后面
+extern int valueNum;
+void initValueIndex(pInterCodeList list);
+void deleteValueIndex();
+int valueIndex(OperandId id);  // 不是临时变量或变量时返回-1
+
+// 各遍共用的小工具
+static inline void toAssign(pInterCode code, OperandId left, OperandId right) {
+    code->kind = IR_ASSIGN;
+    code->u.assign.left = left;
+    code->u.assign.right = right;
+}
+
+static inline OperandId* jumpTarget(pInterCode code) {
+    if (code->kind == IR_GOTO) return &code->u.oneOp.op;
+    if (code->kind == IR_IF_GOTO) return &code->u.ifGoto.z;
+    return NULL;
+}
+
+static inline int labelNo(OperandId id) { return getOperand(id)->u.no; }
+
+// 纯计算指令，结果没人读就可以删；CALL和READ有副作用要留着
+static inline boolean isPure(pInterCode code) {
+    switch (code->kind) {
+        case IR_ASSIGN:
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+        case IR_GET_ADDR:
+        case IR_READ_ADDR:
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
+// 按32位补码回绕，和目标机器一致
+static inline boolean evalBinOp(int kind, int a, int b, int* res) {
+    unsigned x = (unsigned)a, y = (unsigned)b;
+    switch (kind) {
+        case IR_ADD:
+            *res = (int)(x + y);
+            return TRUE;
+        case IR_SUB:
+            *res = (int)(x - y);
+            return TRUE;
+        case IR_MUL:
+            *res = (int)(x * y);
+            return TRUE;
+        case IR_DIV:
+            // 除零留给运行时
+            if (b == 0 || (a == INT_MIN && b == -1)) return FALSE;
+            *res = a / b;
+            return TRUE;
+    }
+    return FALSE;
+}
+
+static inline boolean evalRelop(Relop relop, int a, int b) {
+    switch (relop) {
+        case RELOP_LT: return a < b;
+        case RELOP_LE: return a <= b;
+        case RELOP_GT: return a > b;
+        case RELOP_GE: return a >= b;
+        case RELOP_EQ: return a == b;
+        default: return a != b;
+    }
+}
+
+// 活跃变量分析用的位向量
+typedef unsigned long long Word;
+#define WORD_BITS 64
+
+static inline boolean testBit(Word* set, int i) {
+    return (set[i / WORD_BITS] >> (i % WORD_BITS)) & 1;
+}
+static inline void setBit(Word* set, int i) {
+    set[i / WORD_BITS] |= (Word)1 << (i % WORD_BITS);
+}
+static inline void clearBit(Word* set, int i) {
+    set[i / WORD_BITS] &= ~((Word)1 << (i % WORD_BITS));
+}
+
+// passes
+void coalesceCopies(pInterCodeList list);
+void propagateCopies(pInterCodeList list);
+void foldConstants(pInterCodeList list);
+void eliminateDeadCode(pInterCodeList list);
+int numberValues(pInterCodeList list);    // 返回复用的次数
+void peephole(pInterCodeList list);
+
+// inline.c，返回内联的调用点个数；会新开临时变量，要在initValueIndex之前
+int inlineCalls(pInterCodeList list);
+
+// ssa.c，在SSA形式上跑ssaopt.c里的各遍再回到普通代码，返回改动的处数。
+// numbering为FALSE时只做常量传播
+int runSsaPasses(pInterCodeList list, boolean numbering);
+
+// loop.c，返回改动的处数
+int hoistInvariants(pInterCodeList list);
+int reduceStrength(pInterCodeList list);
+
+#endif
@@ -0,0 +1,710 @@
+#include <time.h>
+#include "cfg.h"
+#include "optimize.h"
+#include "regalloc.h"
+
+// Chaitin-Briggs图着色：
+//   建图：活跃变量分析后倒着扫每块，定值和此处活跃的值互相冲突，
+//     x := y 里的x和y不算冲突；跨调用活跃的值做上记号
+//   合并：不冲突的 x := y 按Briggs的保守条件（合并后度数不小于K的邻居
+//     少于K个）合并成一个结点，被合并结点的边转到代表上，合并不动后重新建图
+//   简化：反复删掉度数小于K的结点压栈，删不动时按溢出代价/度数挑一个
+//     乐观地压栈
+//   选择：依次弹栈，取邻居没用的颜色，取不到的就溢出
+// 跨调用的结点只能用被调用者保存的寄存器，它的K也就小一些。
+// -fregalloc=linear时改用后面的线性扫描，不建图也不合并，快但分得差些
+static pRegAlloc ra;
+static pInterCodeList curList;
+static pCfg cfg;
+static int funcStart, funcEnd;
+
+static int* nodeStamp;  // valueIndex -> 结点，以函数起点+1做时间戳
+static int* nodeOf;
+static int nodeNum;
+static int* nodeValue;  // 结点 -> 它的一个值
+static int* parent;     // 并查集，合并过的结点指向代表
+static double* cost;    // 溢出代价：出现次数按循环深度加权
+static boolean* crossCall;
+
+// 冲突图：边放在开放寻址的散列表里去重，同时记在两头的邻接表里。
+// 合并时邻接表里会留下已经不是代表的结点，用的时候要find
+static unsigned long long* edgeKeys;
+static int edgeCap;
+static int *edgeFrom, *edgeTo;
+static int edgeNum, edgeListCap;
+static int** adj;
+static int* adjNum;
+static int* adjCap;
+static int* degree;
+
+// 活跃集合用稀疏集，可以O(1)增删，也能列举
+static int* liveList;
+static int* livePos;
+static int liveNum;
+
+static int find(int n) {
+    while (parent[n] != n) {
+        parent[n] = parent[parent[n]];
+        n = parent[n];
+    }
+    return n;
+}
+
+static int nodeOfOperand(OperandId id) {
+    int v = valueIndex(id);
+    if (v < 0) return -1;
+    assert(nodeStamp[v] == funcStart + 1);
+    return find(nodeOf[v]);
+}
+
+static int kOf(int n) {
+    return crossCall[n] ? ra->regNum - ra->callerSaved : ra->regNum;
+}
+
+static unsigned long long edgeKey(int a, int b) {
+    if (a > b) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    return ((unsigned long long)a << 32) | (unsigned)b;
+}
+
+static int probe(unsigned long long key) {
+    unsigned long long h = key * 0x9E3779B97F4A7C15ull;
+    int i = (int)(h >> 32) & (edgeCap - 1);
+    while (edgeKeys[i] && edgeKeys[i] != key) i = (i + 1) & (edgeCap - 1);
+    return i;
+}
+
+static boolean hasEdge(int a, int b) {
+    return edgeKeys[probe(edgeKey(a, b))] != 0;
+}
+
+// 返回是不是新加的边
+static boolean addEdge(int a, int b) {
+    if (a == b) return FALSE;
+    // (0,0)不会出现，键为0表示空位
+    unsigned long long key = edgeKey(a, b);
+    int i = probe(key);
+    if (edgeKeys[i]) return FALSE;
+    edgeKeys[i] = key;
+    if (edgeNum == edgeListCap) {
+        edgeListCap = edgeListCap ? edgeListCap * 2 : 1024;
+        edgeFrom = (int*)realloc(edgeFrom, sizeof(int) * edgeListCap);
+        edgeTo = (int*)realloc(edgeTo, sizeof(int) * edgeListCap);
+        assert(edgeFrom && edgeTo);
+    }
+    edgeFrom[edgeNum] = a;
+    edgeTo[edgeNum] = b;
+    edgeNum++;
+    int ends[2] = {a, b};
+    for (int i = 0; i < 2; i++) {
+        int n = ends[i];
+        if (adjNum[n] == adjCap[n]) {
+            adjCap[n] = adjCap[n] ? adjCap[n] * 2 : 4;
+            adj[n] = (int*)realloc(adj[n], sizeof(int) * adjCap[n]);
+            assert(adj[n] != NULL);
+        }
+        adj[n][adjNum[n]++] = ends[1 - i];
+    }
+    if (edgeNum * 2 >= edgeCap) {
+        edgeCap *= 2;
+        free(edgeKeys);
+        edgeKeys = (unsigned long long*)calloc(edgeCap, sizeof(*edgeKeys));
+        assert(edgeKeys != NULL);
+        for (int e = 0; e < edgeNum; e++)
+            edgeKeys[probe(edgeKey(edgeFrom[e], edgeTo[e]))] =
+                edgeKey(edgeFrom[e], edgeTo[e]);
+    }
+    return TRUE;
+}
+
+static void addLive(int n) {
+    if (livePos[n] >= 0) return;
+    livePos[n] = liveNum;
+    liveList[liveNum++] = n;
+}
+
+static void removeLive(int n) {
+    int p = livePos[n];
+    if (p < 0) return;
+    int last = liveList[--liveNum];
+    liveList[p] = last;
+    livePos[last] = p;
+    livePos[n] = -1;
+}
+
+static void clearLive() {
+    for (int i = 0; i < liveNum; i++) livePos[liveList[i]] = -1;
+    liveNum = 0;
+}
+
+// 活跃变量分析。和死代码删除一样，只有在某块里向上暴露的结点
+// 才做位向量，其余的只在块内活跃
+static int* globalIndex;
+static int* globalNode;
+static Word* liveInSets;
+static int liveWords;
+
+static void analyzeLiveness() {
+    OperandId* slots[3];
+    globalIndex = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    globalNode = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    int* defStamp = (int*)calloc(nodeNum + 1, sizeof(int));
+    assert(globalIndex && globalNode && defStamp);
+    for (int n = 0; n < nodeNum; n++) globalIndex[n] = -1;
+    int globalNum = 0, stamp = 0;
+    forEachBlock(cfg, b) {
+        stamp++;
+        forEachCode(cfg, b, code) {
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int n = nodeOfOperand(*slots[j]);
+                if (n < 0 || defStamp[n] == stamp || globalIndex[n] >= 0)
+                    continue;
+                globalNode[globalNum] = n;
+                globalIndex[n] = globalNum++;
+            }
+            OperandId def = getDef(code);
+            int n = def ? nodeOfOperand(def) : -1;
+            if (n >= 0) defStamp[n] = stamp;
+        }
+    }
+
+    int words = (globalNum + WORD_BITS - 1) / WORD_BITS;
+    if (words == 0) words = 1;
+    int blockNum = cfg->blockNum;
+    Word* sets = (Word*)calloc((size_t)blockNum * words * 2, sizeof(Word));
+    Word* liveIn = (Word*)calloc((size_t)blockNum * words, sizeof(Word));
+    Word* liveOut = (Word*)malloc(sizeof(Word) * words);
+    assert(sets && liveIn && liveOut);
+    Word* ueSets = sets;
+    Word* killSets = sets + (size_t)blockNum * words;
+    forEachBlock(cfg, b) {
+        Word* ue = ueSets + (size_t)b * words;
+        Word* kill = killSets + (size_t)b * words;
+        forEachCode(cfg, b, code) {
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int n = nodeOfOperand(*slots[j]);
+                if (n < 0 || globalIndex[n] < 0) continue;
+                if (!testBit(kill, globalIndex[n])) setBit(ue, globalIndex[n]);
+            }
+            OperandId def = getDef(code);
+            int n = def ? nodeOfOperand(def) : -1;
+            if (n >= 0 && globalIndex[n] >= 0) setBit(kill, globalIndex[n]);
+        }
+    }
+    boolean changed = TRUE;
+    while (changed) {
+        changed = FALSE;
+        for (int i = cfg->rpoNum - 1; i >= 0; i--) {
+            int b = cfg->rpo[i];
+            memset(liveOut, 0, sizeof(Word) * words);
+            forEachSucc(cfg, b, s) {
+                Word* in = liveIn + (size_t)s * words;
+                for (int w = 0; w < words; w++) liveOut[w] |= in[w];
+            }
+            Word* in = liveIn + (size_t)b * words;
+            Word* ue = ueSets + (size_t)b * words;
+            Word* kill = killSets + (size_t)b * words;
+            for (int w = 0; w < words; w++) {
+                Word val = ue[w] | (liveOut[w] & ~kill[w]);
+                if (val != in[w]) {
+                    in[w] = val;
+                    changed = TRUE;
+                }
+            }
+        }
+    }
+    liveInSets = liveIn;
+    liveWords = words;
+    free(sets);
+    free(liveOut);
+    free(defStamp);
+}
+
+static void freeLiveness() {
+    free(globalIndex);
+    free(globalNode);
+    free(liveInSets);
+}
+
+// 把块b出口处活跃的结点放进活跃集合
+static void addLiveOut(int b) {
+    forEachSucc(cfg, b, s) {
+        Word* in = liveInSets + (size_t)s * liveWords;
+        for (int w = 0; w < liveWords; w++) {
+            int g = w * WORD_BITS;
+            for (Word bits = in[w]; bits; bits >>= 1, g++)
+                if (bits & 1) addLive(globalNode[g]);
+        }
+    }
+}
+
+// 倒着扫每块建图
+static void build() {
+    OperandId* slots[3];
+    analyzeLiveness();
+    edgeNum = 0;
+    memset(edgeKeys, 0, sizeof(*edgeKeys) * edgeCap);
+    memset(adjNum, 0, sizeof(int) * nodeNum);
+    for (int n = 0; n < nodeNum; n++) crossCall[n] = FALSE;
+    ra->entryLiveNum = 0;
+    forEachBlock(cfg, b) {
+        addLiveOut(b);
+        pBlock block = &cfg->blocks[b];
+        for (int i = block->last - 1; i >= block->first; i--) {
+            pInterCode code = &curList->codes[i];
+            OperandId def = getDef(code);
+            int d = def ? nodeOfOperand(def) : -1;
+            if (code->kind == IR_CALL)
+                for (int k = 0; k < liveNum; k++)
+                    if (liveList[k] != d) crossCall[liveList[k]] = TRUE;
+            if (d >= 0) {
+                int src = code->kind == IR_ASSIGN
+                              ? nodeOfOperand(code->u.assign.right)
+                              : -1;
+                for (int k = 0; k < liveNum; k++)
+                    if (liveList[k] != src) addEdge(d, liveList[k]);
+                removeLive(d);
+            }
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int n = nodeOfOperand(*slots[j]);
+                if (n >= 0) addLive(n);
+            }
+        }
+        // 入口块扫完剩下的就是入口处活跃的
+        if (b == 0)
+            for (int k = 0; k < liveNum; k++)
+                ra->entryLive[ra->entryLiveNum++] = nodeValue[liveList[k]];
+        clearLive();
+    }
+    memcpy(degree, adjNum, sizeof(int) * nodeNum);
+    freeLiveness();
+}
+
+static int* mark;
+static int markStamp;
+
+// 合并不会让图变得更难着色的两个保守条件，度数都只会偏大，仍然保守：
+//   George：a的每个邻居要么已经和b冲突，要么度数小于K。只扫a的邻居，
+//     适合b的度数很大的情况，但要求合并后的K和b的一样
+//   Briggs：合并后度数不小于K的邻居少于K个
+static boolean canCoalesce(int a, int b) {
+    if (degree[a] > degree[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    if (crossCall[b] || !crossCall[a]) {
+        boolean ok = TRUE;
+        for (int e = 0; ok && e < adjNum[a]; e++) {
+            int c = find(adj[a][e]);
+            ok = c == b || degree[c] < kOf(c) || hasEdge(c, b);
+        }
+        if (ok) return TRUE;
+    }
+    int k = crossCall[a] || crossCall[b] ? ra->regNum - ra->callerSaved
+                                         : ra->regNum;
+    int significant = 0;
+    int nodes[2] = {a, b};
+    markStamp++;
+    for (int i = 0; i < 2; i++) {
+        for (int e = 0; e < adjNum[nodes[i]]; e++) {
+            int c = find(adj[nodes[i]][e]);
+            if (c == a || c == b || mark[c] == markStamp) continue;
+            mark[c] = markStamp;
+            if (degree[c] >= kOf(c) && ++significant >= k) return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+// 度数小的并到度数大的上，边转过去。邻居c的度数不变：
+// 原来和b冲突，现在和a冲突，只会偏大
+static void merge(int a, int b) {
+    if (degree[a] < degree[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    parent[b] = a;
+    cost[a] += cost[b];
+    crossCall[a] = crossCall[a] || crossCall[b];
+    for (int e = 0; e < adjNum[b]; e++)
+        if (addEdge(a, find(adj[b][e]))) degree[a]++;
+}
+
+static int coalesce() {
+    int merged = 0;
+    for (int i = funcStart + 1; i < funcEnd; i++) {
+        pInterCode code = &curList->codes[i];
+        if (code->kind != IR_ASSIGN) continue;
+        int a = nodeOfOperand(code->u.assign.left);
+        int b = nodeOfOperand(code->u.assign.right);
+        if (a < 0 || b < 0 || a == b) continue;
+        if (hasEdge(a, b) || !canCoalesce(a, b)) continue;
+        merge(a, b);
+        merged++;
+    }
+    return merged;
+}
+
+static int compareSpill(const void* x, const void* y) {
+    int a = *(const int*)x, b = *(const int*)y;
+    double ca = cost[a] / (degree[a] + 1), cb = cost[b] / (degree[b] + 1);
+    if (ca != cb) return ca < cb ? -1 : 1;
+    return a - b;
+}
+
+static void color(int* colors) {
+    int* cur = (int*)malloc(sizeof(int) * nodeNum);
+    int* stack = (int*)malloc(sizeof(int) * nodeNum);
+    int* low = (int*)malloc(sizeof(int) * nodeNum);
+    int* order = (int*)malloc(sizeof(int) * nodeNum);
+    char* removed = (char*)calloc(nodeNum, sizeof(char));
+    assert(cur && stack && low && order && removed);
+
+    int repNum = 0, lowNum = 0, stackNum = 0;
+    for (int n = 0; n < nodeNum; n++) {
+        colors[n] = REG_SPILL;
+        if (find(n) != n) continue;
+        order[repNum++] = n;
+        cur[n] = degree[n];
+        if (cur[n] < kOf(n)) low[lowNum++] = n;
+    }
+    qsort(order, repNum, sizeof(int), compareSpill);
+
+    // 简化
+    int next = 0;
+    while (stackNum < repNum) {
+        int n;
+        if (lowNum) {
+            n = low[--lowNum];
+        } else {
+            while (removed[order[next]]) next++;
+            n = order[next];
+        }
+        if (removed[n]) continue;
+        removed[n] = 1;
+        stack[stackNum++] = n;
+        for (int e = 0; e < adjNum[n]; e++) {
+            int c = adj[n][e];
+            if (!removed[c] && cur[c]-- == kOf(c)) low[lowNum++] = c;
+        }
+    }
+
+    // 选择：不跨调用的先用调用者保存的寄存器，省得在序言里保存
+    while (stackNum) {
+        int n = stack[--stackNum];
+        unsigned used = 0;
+        for (int e = 0; e < adjNum[n]; e++)
+            if (colors[adj[n][e]] != REG_SPILL) used |= 1u << colors[adj[n][e]];
+        for (int r = crossCall[n] ? ra->callerSaved : 0; r < ra->regNum; r++) {
+            if (!(used & (1u << r))) {
+                colors[n] = r;
+                break;
+            }
+        }
+    }
+
+    free(cur);
+    free(stack);
+    free(low);
+    free(order);
+    free(removed);
+}
+
+// 线性扫描（Poletto & Sarkar）：不建图，每个结点只算一个覆盖它所有活跃点的
+// 区间[from, to]，按起点排好后扫一遍。到期的区间放回寄存器，没有空闲的
+// 就在活跃区间和当前区间里溢出终点最远的那个。一条指令最后一次读的值
+// 和它定值的值可以共用寄存器，所以起点是定值时终点相同的区间也算到期。
+// 区间里有CALL的就算跨调用，区间的洞里的调用也算，偏保守
+static int* from;
+static int* to;
+static boolean* defAtFrom;
+
+static void extend(int n, int pos, boolean isDef) {
+    if (pos < from[n]) {
+        from[n] = pos;
+        defAtFrom[n] = isDef;
+    } else if (pos == from[n] && !isDef) {
+        defAtFrom[n] = FALSE;
+    }
+    if (pos > to[n]) to[n] = pos;
+}
+
+static void buildIntervals() {
+    OperandId* slots[3];
+    analyzeLiveness();
+    for (int n = 0; n < nodeNum; n++) {
+        from[n] = funcEnd;
+        to[n] = funcStart - 1;
+        defAtFrom[n] = FALSE;
+    }
+    ra->entryLiveNum = 0;
+    forEachBlock(cfg, b) {
+        addLiveOut(b);
+        pBlock block = &cfg->blocks[b];
+        for (int k = 0; k < liveNum; k++)
+            extend(liveList[k], block->last - 1, FALSE);
+        for (int i = block->last - 1; i >= block->first; i--) {
+            pInterCode code = &curList->codes[i];
+            OperandId def = getDef(code);
+            int d = def ? nodeOfOperand(def) : -1;
+            if (d >= 0) {
+                extend(d, i, TRUE);
+                removeLive(d);
+            }
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int n = nodeOfOperand(*slots[j]);
+                if (n < 0) continue;
+                extend(n, i, FALSE);
+                addLive(n);
+            }
+        }
+        for (int k = 0; k < liveNum; k++)
+            extend(liveList[k], block->first, FALSE);
+        if (b == 0)
+            for (int k = 0; k < liveNum; k++)
+                ra->entryLive[ra->entryLiveNum++] = nodeValue[liveList[k]];
+        clearLive();
+    }
+    freeLiveness();
+
+    // 调用的位置是递增的，二分找区间起点之后的第一个
+    int* calls = (int*)malloc(sizeof(int) * (funcEnd - funcStart));
+    assert(calls != NULL);
+    int callNum = 0;
+    for (int i = funcStart; i < funcEnd; i++)
+        if (curList->codes[i].kind == IR_CALL) calls[callNum++] = i;
+    for (int n = 0; n < nodeNum; n++) {
+        int lo = 0, hi = callNum;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (calls[mid] <= from[n])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        crossCall[n] = lo < callNum && calls[lo] < to[n];
+    }
+    free(calls);
+}
+
+static void linearScan(int* colors) {
+    buildIntervals();
+
+    // 按起点计数排序
+    int span = funcEnd - funcStart + 1;
+    int* bucket = (int*)calloc(span + 1, sizeof(int));
+    int* order = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    assert(bucket && order);
+    for (int n = 0; n < nodeNum; n++) bucket[from[n] - funcStart + 1]++;
+    for (int i = 0; i < span; i++) bucket[i + 1] += bucket[i];
+    for (int n = 0; n < nodeNum; n++) order[bucket[from[n] - funcStart]++] = n;
+
+    // 活跃区间按终点递增，最多regNum个
+    int active[REG_MAX];
+    int activeNum = 0;
+    unsigned all = ra->regNum == 32 ? ~0u : (1u << ra->regNum) - 1;
+    unsigned calleeSaved = all & ~((1u << ra->callerSaved) - 1);
+    unsigned busy = 0;
+    for (int k = 0; k < nodeNum; k++) {
+        int n = order[k];
+        int expired = 0;
+        while (expired < activeNum) {
+            int m = active[expired];
+            if (to[m] > from[n] || (to[m] == from[n] && !defAtFrom[n])) break;
+            busy &= ~(1u << colors[m]);
+            expired++;
+        }
+        activeNum -= expired;
+        memmove(active, active + expired, sizeof(int) * activeNum);
+
+        unsigned allowed = crossCall[n] ? calleeSaved : all;
+        unsigned idle = allowed & ~busy;
+        if (idle) {
+            int r = 0;
+            while (!(idle & (1u << r))) r++;
+            colors[n] = r;
+        } else {
+            int victim = -1;
+            for (int i = 0; i < activeNum; i++)
+                if ((allowed & (1u << colors[active[i]])) &&
+                    (victim < 0 || to[active[i]] > to[active[victim]]))
+                    victim = i;
+            if (victim < 0 || to[active[victim]] <= to[n]) {
+                colors[n] = REG_SPILL;
+                continue;
+            }
+            int m = active[victim];
+            colors[n] = colors[m];
+            colors[m] = REG_SPILL;
+            activeNum--;
+            memmove(active + victim, active + victim + 1,
+                    sizeof(int) * (activeNum - victim));
+        }
+        busy |= 1u << colors[n];
+        int i = activeNum++;
+        while (i > 0 && to[active[i - 1]] > to[n]) {
+            active[i] = active[i - 1];
+            i--;
+        }
+        active[i] = n;
+    }
+
+    free(bucket);
+    free(order);
+}
+
+static void addNode(OperandId id, double weight) {
+    int v = valueIndex(id);
+    if (v < 0) return;
+    if (nodeStamp[v] != funcStart + 1) {
+        nodeStamp[v] = funcStart + 1;
+        nodeOf[v] = nodeNum;
+        nodeValue[nodeNum] = v;
+        cost[nodeNum] = 0;
+        nodeNum++;
+    }
+    cost[nodeOf[v]] += weight;
+}
+
+void allocRegisters(pRegAlloc r, pInterCodeList list, int start) {
+    clock_t begin = clock();
+    ra = r;
+    curList = list;
+    cfg = newCfg(list, start);
+    funcStart = start;
+    funcEnd = cfg->funcEnd;
+
+    // 出现的值编成结点，顺便累计溢出代价
+    int cap = 2 * (funcEnd - start) + 1;
+    nodeValue = (int*)malloc(sizeof(int) * cap);
+    cost = (double*)malloc(sizeof(double) * cap);
+    assert(nodeValue && cost);
+    nodeNum = 0;
+    OperandId* slots[3];
+    forEachBlock(cfg, b) {
+        int depth = loopDepth(cfg, b);
+        double weight = 1;
+        for (int d = 0; d < depth && d < 6; d++) weight *= 10;
+        forEachCode(cfg, b, code) {
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) addNode(*slots[j], weight);
+            OperandId def = getDef(code);
+            if (def) addNode(def, weight);
+        }
+    }
+    parent = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    crossCall = (boolean*)malloc(sizeof(boolean) * (nodeNum + 1));
+    degree = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    adj = (int**)calloc(nodeNum + 1, sizeof(int*));
+    adjNum = (int*)calloc(nodeNum + 1, sizeof(int));
+    adjCap = (int*)calloc(nodeNum + 1, sizeof(int));
+    mark = (int*)calloc(nodeNum + 1, sizeof(int));
+    markStamp = 0;
+    liveList = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    livePos = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    int* colors = (int*)malloc(sizeof(int) * (nodeNum + 1));
+    assert(parent && crossCall && degree && adj && adjNum && adjCap && mark &&
+           liveList && livePos && colors);
+    for (int n = 0; n < nodeNum; n++) {
+        parent[n] = n;
+        livePos[n] = -1;
+    }
+    liveNum = 0;
+    edgeCap = 1024;
+    edgeKeys = (unsigned long long*)calloc(edgeCap, sizeof(*edgeKeys));
+    assert(edgeKeys != NULL);
+
+    if (optLinearScan) {
+        from = (int*)malloc(sizeof(int) * (nodeNum + 1));
+        to = (int*)malloc(sizeof(int) * (nodeNum + 1));
+        defAtFrom = (boolean*)malloc(sizeof(boolean) * (nodeNum + 1));
+        assert(from && to && defAtFrom);
+        linearScan(colors);
+        free(from);
+        free(to);
+        free(defAtFrom);
+    } else {
+        build();
+        int merged, total = 0;
+        while ((merged = coalesce()) > 0) total += merged;
+        if (total) {
+            ra->moveTotal += total;
+            build();
+        }
+        color(colors);
+    }
+
+    // 结果按值给出，溢出的代表结点各占一个槽位
+    ra->slotNum = 0;
+    ra->usedRegs = 0;
+    for (int n = 0; n < nodeNum; n++) {
+        if (find(n) != n) continue;
+        if (colors[n] == REG_SPILL) {
+            degree[n] = ra->slotNum++;  // 度数用不着了，借来记槽位
+            ra->spillTotal++;
+        } else {
+            ra->usedRegs |= 1u << colors[n];
+        }
+    }
+    for (int n = 0; n < nodeNum; n++) {
+        int rep = find(n);
+        ra->reg[nodeValue[n]] = colors[rep];
+        if (colors[rep] == REG_SPILL) ra->slot[nodeValue[n]] = degree[rep];
+    }
+    ra->valueTotal += nodeNum;
+
+    free(nodeValue);
+    free(cost);
+    free(parent);
+    free(crossCall);
+    free(degree);
+    for (int n = 0; n < nodeNum; n++) free(adj[n]);
+    free(adj);
+    free(adjNum);
+    free(adjCap);
+    free(mark);
+    free(liveList);
+    free(livePos);
+    free(colors);
+    free(edgeKeys);
+    free(edgeFrom);
+    free(edgeTo);
+    edgeFrom = edgeTo = NULL;
+    edgeListCap = 0;
+    deleteCfg(cfg);
+    ra->seconds += (double)(clock() - begin) / CLOCKS_PER_SEC;
+}
+
+pRegAlloc newRegAlloc(int regNum, int callerSaved) {
+    assert(regNum <= REG_MAX && callerSaved <= regNum);
+    pRegAlloc p = (pRegAlloc)calloc(1, sizeof(RegAlloc));
+    assert(p != NULL);
+    p->regNum = regNum;
+    p->callerSaved = callerSaved;
+    p->reg = (int*)malloc(sizeof(int) * (valueNum + 1));
+    p->slot = (int*)malloc(sizeof(int) * (valueNum + 1));
+    p->entryLive = (int*)malloc(sizeof(int) * (valueNum + 1));
+    nodeStamp = (int*)calloc(valueNum + 1, sizeof(int));
+    nodeOf = (int*)malloc(sizeof(int) * (valueNum + 1));
+    assert(p->reg && p->slot && p->entryLive && nodeStamp && nodeOf);
+    return p;
+}
+
+void deleteRegAlloc(pRegAlloc p) {
+    free(p->reg);
+    free(p->slot);
+    free(p->entryLive);
+    free(p);
+    free(nodeStamp);
+    free(nodeOf);
+    nodeStamp = nodeOf = NULL;
+}
@@ -0,0 +1,31 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+#include "inter.h"
+
+// 寄存器分配，各个原生后端共用，按函数进行，调用前要initValueIndex。
+// 寄存器编号0..regNum-1，前callerSaved个调用时会被破坏，跨调用活跃的值
+// 只放在后面的被调用者保存的寄存器里。溢出的值在帧里占一个槽位，
+// 后端用自己保留的临时寄存器存取
+#define REG_SPILL (-1)
+#define REG_MAX 32
+
+typedef struct _regAlloc* pRegAlloc;
+
+typedef struct _regAlloc {
+    int regNum, callerSaved;
+    int* reg;          // valueIndex -> 寄存器号或REG_SPILL，只对本函数出现的值有效
+    int* slot;         // 溢出的值 -> 槽位，合并过的值共用一个
+    int slotNum;
+    int* entryLive;    // 入口处活跃的值（没赋值就读的变量），后端要先清零
+    int entryLiveNum;
+    unsigned usedRegs; // 本函数用到的寄存器
+    // 统计，整个程序累加
+    int valueTotal, moveTotal, spillTotal;
+    double seconds;
+} RegAlloc;
+
+pRegAlloc newRegAlloc(int regNum, int callerSaved);
+void deleteRegAlloc(pRegAlloc ra);
+void allocRegisters(pRegAlloc ra, pInterCodeList list, int start);
+
+#endif
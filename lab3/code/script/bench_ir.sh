@@ -0,0 +1,26 @@
+#!/bin/bash
+
+# Static and dynamic IR instruction counts for the loop benchmarks.
+# Dynamic counts come from running the generated IR with ./parser --run;
+# if a run fails or prints no count, the script stops with an error.
+# usage: ./script/bench_ir.sh [benchmark.cmm ...]
+
+BENCH_DIR="../bench"
+CONFIGS=("-O0" "-O1 -fno-licm" "-O1 -fno-inline" "-O1 -fno-ssa" "-O1")
+
+files=${@:-$BENCH_DIR/*.cmm}
+
+printf "%-16s %-16s %8s %10s\n" "benchmark" "flags" "static" "dynamic"
+for bench_file in $files; do
+    base_name=$(basename $bench_file .cmm)
+    for flags in "${CONFIGS[@]}"; do
+        static=$(./parser $bench_file $flags | grep -c .)
+        dynamic=$(./parser $bench_file $flags --run < /dev/null 2>&1 >/dev/null |
+                  awk '$1 == "executed:" { print $2 }'; exit ${PIPESTATUS[0]})
+        if [ $? -ne 0 ] || [ -z "$dynamic" ]; then
+            echo "$base_name $flags: ./parser --run failed" >&2
+            exit 1
+        fi
+        printf "%-16s %-16s %8d %10s\n" $base_name "$flags" $static "$dynamic"
+    done
+done
@@ -0,0 +1,28 @@
+#!/bin/bash
+
+# Run the benchmarks on the MIPS simulator and compare with the IR interpreter.
+# Prints dynamic IR instructions, simulated MIPS instructions, and how many of
+# those were loads/stores; "DIFF" means the two runs printed different output.
+# usage: ./script/bench_mips.sh [benchmark.cmm ...]
+
+BENCH_DIR="../bench"
+CONFIGS=("-O0" "-O1")
+INPUT="7"
+
+files=${@:-$BENCH_DIR/*.cmm}
+
+printf "%-16s %-6s %10s %10s %10s %s\n" "benchmark" "flags" "ir" "mips" "lw/sw" ""
+for bench_file in $files; do
+    base_name=$(basename $bench_file .cmm)
+    for flags in "${CONFIGS[@]}"; do
+        ir_out=$(echo $INPUT | ./parser $bench_file $flags --run 2>/tmp/bench_mips_ir.$$)
+        mips_out=$(echo $INPUT | ./parser $bench_file $flags --emit=mips --run \
+                   2>/tmp/bench_mips_sim.$$)
+        ir=$(awk '$1 == "executed:" { print $2 }' /tmp/bench_mips_ir.$$)
+        read mips memory < <(awk '$1 == "executed:" { print $2, $4 }' /tmp/bench_mips_sim.$$)
+        status=""
+        [ "$ir_out" == "$mips_out" ] || status="DIFF"
+        printf "%-16s %-6s %10s %10s %10s %s\n" $base_name "$flags" "$ir" "$mips" "$memory" $status
+    done
+done
+rm -f /tmp/bench_mips_ir.$$ /tmp/bench_mips_sim.$$
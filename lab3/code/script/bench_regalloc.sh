@@ -0,0 +1,56 @@
+#!/bin/bash
+
+# Compare the graph-coloring and linear-scan register allocators of the MIPS
+# backend: time spent in the allocator, values spilled, and loads/stores
+# executed on the simulator. Besides the lab3 test programs and benchmarks it
+# generates one straight-line function with about TEMPS temporaries at -O0.
+# usage: ./script/bench_regalloc.sh [file.cmm ...]
+
+CONFIGS=("-O0" "-O1")
+ALLOCATORS=("color" "linear")
+TEMPS=${TEMPS:-50000}
+
+work=$(mktemp -d)
+trap "rm -rf $work" EXIT
+
+# 64 variables assigned round-robin; each statement makes 3 temporaries at -O0
+synthetic=$work/synthetic.cmm
+awk -v stmts=$((TEMPS / 3)) 'BEGIN {
+    srand(1);
+    print "int main()\n{";
+    printf "  int x";
+    for (i = 0; i < 64; i++) printf ", v%d", i;
+    print ";\n  x = read();";
+    for (i = 0; i < 64; i++) printf "  v%d = x + %d;\n", i, i;
+    for (s = 0; s < stmts; s++)
+        printf "  v%d = v%d * 3 + v%d - v%d;\n", s % 64, s % 64,
+               int(rand() * 64), int(rand() * 64);
+    for (i = 0; i < 64; i++) printf "  write(v%d);\n", i;
+    print "  return 0;\n}";
+}' > $synthetic
+
+files=${@:-../test/* ../bench/*.cmm $synthetic}
+
+printf "%-16s %-4s %-7s %9s %9s %8s %10s %s\n" \
+    "program" "opt" "regalloc" "alloc ms" "total ms" "spilled" "lw/sw" ""
+for file in $files; do
+    base_name=$(basename $file .cmm)
+    for flags in "${CONFIGS[@]}"; do
+        expected=$(yes 7 | head -100 | ./parser $file $flags --run 2>/dev/null)
+        for alloc in "${ALLOCATORS[@]}"; do
+            begin=$(date +%s%N)
+            ./parser $file $flags -fregalloc=$alloc --emit=mips -stats \
+                -o $work/out.s 2>$work/stats || continue
+            end=$(date +%s%N)
+            read ms spilled < <(awk '$1 == "regalloc:" { print $9, $7 }' $work/stats)
+            actual=$(yes 7 | head -100 |
+                     ./parser $file $flags -fregalloc=$alloc --emit=mips --run \
+                     2>$work/run)
+            memory=$(awk '$1 == "executed:" { print $4 }' $work/run)
+            status=""
+            [ "$expected" == "$actual" ] || status="DIFF"
+            printf "%-16s %-4s %-7s %9s %9d %8s %10s %s\n" $base_name "$flags" \
+                $alloc "$ms" $(((end - begin) / 1000000)) "$spilled" "$memory" $status
+        done
+    done
+done
@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# Symbol table microbenchmark: one function with many locals that are
+# referenced over and over, so nearly all of the time is searchTableItem.
+# usage: ./script/bench_symtab.sh [locals] [statements] [runs]
+
+LOCALS=${1:-10000}
+STMTS=${2:-100000}
+RUNS=${3:-5}
+OUTPUT_DIR="../output"
+SRC=$OUTPUT_DIR/bench_symtab.cmm
+
+mkdir -p $OUTPUT_DIR
+
+# Generate the program: declare v0..v(LOCALS-1), then STMTS assignments
+# that each touch three pseudo-randomly chosen locals
+awk -v n=$LOCALS -v m=$STMTS 'BEGIN {
+    print "int main()"
+    print "{"
+    for (i = 0; i < n; i++) printf "    int v%d;\n", i
+    x = 12345
+    for (i = 0; i < m; i++) {
+        x = (x * 1103515245 + 12345) % 2147483648; a = x % n
+        x = (x * 1103515245 + 12345) % 2147483648; b = x % n
+        x = (x * 1103515245 + 12345) % 2147483648; c = x % n
+        printf "    v%d = v%d + v%d;\n", a, b, c
+    }
+    print "    return 0;"
+    print "}"
+}' > $SRC
+
+echo "$LOCALS locals, $STMTS statements, $RUNS runs"
+for ((i = 0; i < RUNS; i++)); do
+    start=$(date +%s%N)
+    ./parser $SRC > /dev/null
+    end=$(date +%s%N)
+    echo "run $i: $(((end - start) / 1000000)) ms"
+done
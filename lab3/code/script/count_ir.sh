@@ -0,0 +1,20 @@
+#!/bin/bash
+
+# Count IR instructions per test program with and without optimization.
+# usage: ./script/count_ir.sh [optimized flags]   (default: -O1)
+
+TEST_DIR="../test"
+FLAGS=${@:--O1}
+
+printf "%-16s %8s %8s\n" "test" "-O0" "$FLAGS"
+total0=0
+total1=0
+for test_file in $TEST_DIR/*; do
+    base_name=$(basename $test_file)
+    n0=$(./parser $test_file | grep -c .)
+    n1=$(./parser $test_file $FLAGS | grep -c .)
+    total0=$((total0 + n0))
+    total1=$((total1 + n1))
+    printf "%-16s %8d %8d\n" $base_name $n0 $n1
+done
+printf "%-16s %8d %8d\n" "total" $total0 $total1
@@ -0,0 +1,41 @@
+#!/bin/bash
+
+# Build a program with the x86-64 backend and check it against ./parser --run.
+# Both are fed the same input; stdout and the exit status must agree.
+# usage: ./script/native.sh [-O0|-O1 ...] file.cmm [input]
+
+flags=()
+while [[ $1 == -* ]]; do
+    flags+=("$1")
+    shift
+done
+src=$1
+input=${2:-}
+if [ -z "$src" ]; then
+    echo "usage: $0 [flags] file.cmm [input]"
+    exit 1
+fi
+
+work=$(mktemp -d)
+trap "rm -rf $work" EXIT
+
+./parser $src "${flags[@]}" --emit=x86 -o $work/a.s || exit 1
+as -o $work/a.o $work/a.s && ld -o $work/a $work/a.o || exit 1
+
+start=$(date +%s%N)
+echo "$input" | ./parser $src "${flags[@]}" --run > $work/vm.out 2>/dev/null
+vm_status=$?
+mid=$(date +%s%N)
+echo "$input" | $work/a > $work/native.out 2>/dev/null
+native_status=$?
+end=$(date +%s%N)
+
+if cmp -s $work/vm.out $work/native.out && [ $vm_status == $native_status ]; then
+    printf "%-24s ok   vm %6d ms  native %6d ms\n" $(basename $src) \
+        $(((mid - start) / 1000000)) $(((end - mid) / 1000000))
+else
+    printf "%-24s FAIL (vm exit %d, native exit %d)\n" $(basename $src) \
+        $vm_status $native_status
+    diff $work/vm.out $work/native.out | head -5
+    exit 1
+fi
@@ -1,32 +1,71 @@
 #include "semantic.h"
 
 pTable table;
+boolean semError = FALSE;
 
-// Type functions
-pType newType(Kind kind, ...) {
+// 类型表：类型一经创建便不再复制，按指针共享
+// int/float 为单例，数组按(元素类型, 大小)复用，结构体每个定义一份
+static Type basicTypes[2] = {
+    {.kind = BASIC, .u.basic = INT_TYPE},
+    {.kind = BASIC, .u.basic = FLOAT_TYPE},
+};
+static pType typeList = NULL;
+
+static pType allocType(Kind kind) {
     pType p = (pType)malloc(sizeof(Type));
     assert(p != NULL);
     p->kind = kind;
+    p->arrays = NULL;
+    p->nextArray = NULL;
+    p->nextType = typeList;
+    typeList = p;
+    return p;
+}
+
+static pType getArrayType(pType elem, int size) {
+    assert(elem != NULL);
+    for (pType p = elem->arrays; p; p = p->nextArray) {
+        if (p->u.array.size == size) return p;
+    }
+    pType p = allocType(ARRAY);
+    p->u.array.elem = elem;
+    p->u.array.size = size;
+    p->u.array.width = getSize(elem);
+    p->nextArray = elem->arrays;
+    elem->arrays = p;
+    return p;
+}
+
+// Type functions
+pType newType(Kind kind, ...) {
+    pType p = NULL;
     va_list vaList;
     assert(kind == BASIC || kind == ARRAY || kind == STRUCTURE ||
            kind == FUNCTION);
+    va_start(vaList, kind);
     switch (kind) {
         case BASIC:
-            va_start(vaList, 1);
-            p->u.basic = va_arg(vaList, BasicType);
+            p = &basicTypes[va_arg(vaList, BasicType)];
             break;
-        case ARRAY:
-            va_start(vaList, 2);
-            p->u.array.elem = va_arg(vaList, pType);
-            p->u.array.size = va_arg(vaList, int);
+        case ARRAY: {
+            pType elem = va_arg(vaList, pType);
+            p = getArrayType(elem, va_arg(vaList, int));
             break;
+        }
+        // 结构体和函数类型在定义处各创建一次，结构体的域之后经addField加入
         case STRUCTURE:
-            va_start(vaList, 2);
+            p = allocType(STRUCTURE);
             p->u.structure.structName = va_arg(vaList, char*);
-            p->u.structure.field = va_arg(vaList, pFieldList);
+            p->u.structure.field = NULL;
+            p->u.structure.last = NULL;
+            p->u.structure.index = NULL;
+            p->u.structure.indexSize = 0;
+            p->u.structure.fieldNum = 0;
+            p->u.structure.size = 0;
+            p->u.structure.align = 1;
             break;
         case FUNCTION:
-            va_start(vaList, 3);
+            p = allocType(FUNCTION);
             p->u.function.argc = va_arg(vaList, int);
             p->u.function.argv = va_arg(vaList, pFieldList);
             p->u.function.returnType = va_arg(vaList, pType);
@@ -36,94 +75,110 @@ pType newType(Kind kind, ...) {
     return p;
 }
 
-pType copyType(pType src) {
-    if (src == NULL) return NULL;
-    pType p = (pType)malloc(sizeof(Type));
-    assert(p != NULL);
-    p->kind = src->kind;
-    assert(p->kind == BASIC || p->kind == ARRAY || p->kind == STRUCTURE ||
-           p->kind == FUNCTION);
-    switch (p->kind) {
-        case BASIC:
-            p->u.basic = src->u.basic;
-            break;
-        case ARRAY:
-            p->u.array.elem = copyType(src->u.array.elem);
-            p->u.array.size = src->u.array.size;
-            break;
-        case STRUCTURE:
-            p->u.structure.structName = newString(src->u.structure.structName);
-            p->u.structure.field = copyFieldList(src->u.structure.field);
-            break;
-        case FUNCTION:
-            p->u.function.argc = src->u.function.argc;
-            p->u.function.argv = copyFieldList(src->u.function.argv);
-            p->u.function.returnType = copyType(src->u.function.returnType);
-            break;
+static void deleteFieldLists(pFieldList fieldList) {
+    while (fieldList) {
+        pFieldList tDelete = fieldList;
+        fieldList = fieldList->tail;
+        deleteFieldList(tDelete);
     }
+}
 
-    return p;
+void deleteTypes() {
+    while (typeList) {
+        pType type = typeList;
+        typeList = typeList->nextType;
+        if (type->kind == STRUCTURE) {
+            deleteFieldLists(type->u.structure.field);
+            free(type->u.structure.index);
+        }
+        else if (type->kind == FUNCTION)
+            deleteFieldLists(type->u.function.argv);
+        free(type);
+    }
+    basicTypes[INT_TYPE].arrays = NULL;
+    basicTypes[FLOAT_TYPE].arrays = NULL;
+}
+
+boolean checkType(pType type1, pType type2) {
+    if (type1 == NULL || type2 == NULL) return TRUE;
+    if (type1->kind == FUNCTION || type2->kind == FUNCTION) return FALSE;
+    // 基本类型与结构体都已驻留，相同即同一指针
+    if (type1 == type2) return TRUE;
+    // 数组只要求元素类型等价，不比较大小
+    if (type1->kind == ARRAY && type2->kind == ARRAY)
+        return checkType(type1->u.array.elem, type2->u.array.elem);
+    return FALSE;
 }
 
-void deleteType(pType type) {
-    assert(type != NULL);
-    assert(type->kind == BASIC || type->kind == ARRAY ||
-           type->kind == STRUCTURE || type->kind == FUNCTION);
-    pFieldList temp = NULL;
-    // pFieldList tDelete = NULL;
+// 大小都在类型创建时算好：数组记着元素宽度，结构体在定义时排好布局
+int getSize(pType type) {
+    if (type == NULL) return 0;
     switch (type->kind) {
         case BASIC:
-            break;
+            return 4;
         case ARRAY:
-            deleteType(type->u.array.elem);
-            type->u.array.elem = NULL;
-            break;
+            return type->u.array.size * type->u.array.width;
         case STRUCTURE:
-            if (type->u.structure.structName)
-                free(type->u.structure.structName);
-            type->u.structure.structName = NULL;
-
-            temp = type->u.structure.field;
-            while (temp) {
-                pFieldList tDelete = temp;
-                temp = temp->tail;
-                deleteFieldList(tDelete);
-            }
-            type->u.structure.field = NULL;
-            break;
-        case FUNCTION:
-            deleteType(type->u.function.returnType);
-            type->u.function.returnType = NULL;
-            temp = type->u.function.argv;
-            while (temp) {
-                pFieldList tDelete = temp;
-                temp = temp->tail;
-                deleteFieldList(tDelete);
-            }
-            type->u.function.argv = NULL;
-            break;
+            return type->u.structure.size;
+        default:
+            return 0;
     }
-    free(type);
 }
 
-boolean checkType(pType type1, pType type2) {
-    if (type1 == NULL || type2 == NULL) return TRUE;
-    if (type1->kind == FUNCTION || type2->kind == FUNCTION) return FALSE;
-    if (type1->kind != type2->kind)
-        return FALSE;
-    else {
-        assert(type1->kind == BASIC || type1->kind == ARRAY ||
-               type1->kind == STRUCTURE);
-        switch (type1->kind) {
-            case BASIC:
-                return type1->u.basic == type2->u.basic;
-            case ARRAY:
-                return checkType(type1->u.array.elem, type2->u.array.elem);
-            case STRUCTURE:
-                return !strcmp(type1->u.structure.structName,
-                               type2->u.structure.structName);
-        }
-    }
+static int getAlign(pType type) {
+    while (type != NULL && type->kind == ARRAY) type = type->u.array.elem;
+    if (type == NULL) return 1;
+    return type->kind == STRUCTURE ? type->u.structure.align : 4;
+}
+
+// 域名在索引里的槽，没有则返回探测停下的空槽
+static unsigned findFieldSlot(pType type, char* name) {
+    pFieldList* index = type->u.structure.index;
+    unsigned mask = type->u.structure.indexSize - 1;
+    unsigned i = internHash(name) & mask;
+    while (index[i] && index[i]->name != name) i = (i + 1) & mask;
+    return i;
+}
+
+pFieldList searchField(pType type, char* name) {
+    assert(type != NULL && type->kind == STRUCTURE);
+    if (type->u.structure.index == NULL) return NULL;
+    return type->u.structure.index[findFieldSlot(type, name)];
+}
+
+// 槽数翻倍，按域的链表重新登记
+static void growFieldIndex(pType type) {
+    int size = type->u.structure.indexSize ? type->u.structure.indexSize * 2 : 8;
+    free(type->u.structure.index);
+    type->u.structure.index = (pFieldList*)calloc(size, sizeof(pFieldList));
+    assert(type->u.structure.index != NULL);
+    type->u.structure.indexSize = size;
+    for (pFieldList f = type->u.structure.field; f; f = f->tail)
+        type->u.structure.index[findFieldSlot(type, f->name)] = f;
+}
+
+// 把域追加到结构体末尾，排好它的偏移并登记到索引里。同名的域已有时返回FALSE
+boolean addField(pType type, pFieldList field) {
+    assert(type != NULL && type->kind == STRUCTURE && field != NULL);
+    if (searchField(type, field->name)) return FALSE;
+    // 装载因子保持在1/2以下
+    if ((type->u.structure.fieldNum + 1) * 2 > type->u.structure.indexSize)
+        growFieldIndex(type);
+    type->u.structure.index[findFieldSlot(type, field->name)] = field;
+    type->u.structure.fieldNum++;
+
+    int align = getAlign(field->type);
+    field->offset = (type->u.structure.size + align - 1) / align * align;
+    type->u.structure.size = field->offset + getSize(field->type);
+    if (align > type->u.structure.align) type->u.structure.align = align;
+
+    field->tail = NULL;
+    if (type->u.structure.last)
+        type->u.structure.last->tail = field;
+    else
+        type->u.structure.field = field;
+    type->u.structure.last = field;
+    return TRUE;
 }
 
 void printType(pType type) {
@@ -162,9 +217,10 @@ void printType(pType type) {
 pFieldList newFieldList(char* newName, pType newType) {
     pFieldList p = (pFieldList)malloc(sizeof(FieldList));
     assert(p != NULL);
-    p->name = newString(newName);
+    p->name = newName ? intern(newName) : NULL;
     p->type = newType;
     p->isArg = FALSE; // Initialize isArg to FALSE
+    p->offset = 0;
     p->tail = NULL;
     return p;
 }
@@ -174,40 +230,32 @@ pFieldList copyFieldList(pFieldList src) {
     pFieldList head = NULL, cur = NULL;
     pFieldList temp = src;
 
+    // 名字与类型都是共享句柄，只复制链表结点
     while (temp) {
         if (!head) {
-            head = newFieldList(temp->name, copyType(temp->type));
+            head = newFieldList(NULL, temp->type);
             cur = head;
-            temp = temp->tail;
         } else {
-            cur->tail = newFieldList(temp->name, copyType(temp->type));
+            cur->tail = newFieldList(NULL, temp->type);
             cur = cur->tail;
-            temp = temp->tail;
         }
+        cur->name = temp->name;
+        temp = temp->tail;
     }
     return head;
 }
 
 void deleteFieldList(pFieldList fieldList) {
     assert(fieldList != NULL);
-    if (fieldList->name) {
-        free(fieldList->name);
-        fieldList->name = NULL;
-    }
-    if (fieldList->type) deleteType(fieldList->type);
+    // 类型归类型表所有，这里不释放
+    fieldList->name = NULL;
     fieldList->type = NULL;
     free(fieldList);
 }
 
 void setFieldListName(pFieldList p, char* newName) {
     assert(p != NULL && newName != NULL);
-    if (p->name != NULL) {
-        free(p->name);
-    }
-    // int length = strlen(newName) + 1;
-    // p->name = (char*)malloc(sizeof(char) * length);
-    // strncpy(p->name, newName, length);
-    p->name = newString(newName);
+    p->name = intern(newName);
 }
 
 void printFieldList(pFieldList fieldList) {
@@ -228,6 +276,9 @@ pItem newItem(int symbolDepth, pFieldList pfield) {
     assert(p != NULL);
     p->symbolDepth = symbolDepth;
     p->field = pfield;
+    p->isStructDef = FALSE;
+    p->locals = NULL;
+    p->irName = NULL;
     p->nextHash = NULL;
     p->nextSymbol = NULL;
     return p;
@@ -236,6 +287,18 @@ pItem newItem(int symbolDepth, pFieldList pfield) {
 void deleteItem(pItem item) {
     assert(item != NULL);
     if (item->field != NULL) deleteFieldList(item->field);
+    if (item->locals != NULL) {
+        pHash locals = item->locals;
+        for (int i = 0; i < locals->size; i++) {
+            pItem temp = getHashHead(locals, i);
+            while (temp) {
+                pItem tDelete = temp;
+                temp = temp->nextHash;
+                deleteItem(tDelete);
+            }
+        }
+        deleteHash(locals);
+    }
     free(item);
 }
 
@@ -243,38 +306,105 @@ void deleteItem(pItem item) {
 pHash newHash() {
     pHash p = (pHash)malloc(sizeof(HashTable));
     assert(p != NULL);
-    p->hashArray = (pItem*)malloc(sizeof(pItem) * HASH_TABLE_SIZE);
-    assert(p->hashArray != NULL);
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        p->hashArray[i] = NULL;
-    }
+    p->size = HASH_INIT_SIZE;
+    p->count = 0;
+    p->slots = (HashSlot*)calloc(p->size, sizeof(HashSlot));
+    assert(p->slots != NULL);
     return p;
 }
 
+// 表项归作用域栈所有，由deleteStack释放
 void deleteHash(pHash hash) {
     assert(hash != NULL);
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        pItem temp = hash->hashArray[i];
-        while (temp) {
-            pItem tdelete = temp;
-            temp = temp->nextHash;
-            deleteItem(tdelete);
+    free(hash->slots);
+    hash->slots = NULL;
+    free(hash);
+}
+
+// 线性探测，返回name所在的槽，没有则返回探测停下的空槽。
+// 先比较槽里存的哈希值，命中后才去碰表项本身
+static unsigned findSlot(pHash hash, char* name, unsigned code) {
+    unsigned mask = hash->size - 1;
+    unsigned i = code & mask;
+    while (hash->slots[i].item) {
+        if (hash->slots[i].hash == code && hash->slots[i].name == name)
+            return i;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+// 槽数翻倍，只搬动槽，同名遮蔽链原样保留
+static void growHash(pHash hash) {
+    int oldSize = hash->size;
+    HashSlot* oldSlots = hash->slots;
+    hash->size = oldSize * 2;
+    hash->slots = (HashSlot*)calloc(hash->size, sizeof(HashSlot));
+    assert(hash->slots != NULL);
+    unsigned mask = hash->size - 1;
+    for (int i = 0; i < oldSize; i++) {
+        if (!oldSlots[i].item) continue;
+        unsigned j = oldSlots[i].hash & mask;
+        while (hash->slots[j].item) j = (j + 1) & mask;
+        hash->slots[j] = oldSlots[i];
+    }
+    free(oldSlots);
+}
+
+// 删除槽i，把后面探测序列里的槽往回挪，保证查找不会提前遇到空槽
+static void deleteSlot(pHash hash, unsigned i) {
+    unsigned mask = hash->size - 1;
+    unsigned j = i;
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!hash->slots[j].item) break;
+        unsigned home = hash->slots[j].hash & mask;
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            hash->slots[i] = hash->slots[j];
+            i = j;
         }
-        hash->hashArray[i] = NULL;
     }
-    free(hash->hashArray);
-    hash->hashArray = NULL;
-    free(hash);
+    hash->slots[i].item = NULL;
+    hash->count--;
 }
 
-pItem getHashHead(pHash hash, int index) {
-    assert(hash != NULL);
-    return hash->hashArray[index];
+pItem searchHash(pHash hash, char* name) {
+    return hash->slots[findSlot(hash, name, internHash(name))].item;
 }
 
-void setHashHead(pHash hash, int index, pItem newVal) {
+void addHashItem(pHash hash, pItem item) {
+    // 装载因子超过3/4时扩容
+    if ((hash->count + 1) * 4 > hash->size * 3) growHash(hash);
+    char* name = item->field->name;
+    unsigned code = internHash(name);
+    HashSlot* slot = &hash->slots[findSlot(hash, name, code)];
+    if (slot->item == NULL) {
+        slot->hash = code;
+        slot->name = name;
+        hash->count++;
+    }
+    item->nextHash = slot->item;
+    slot->item = item;
+}
+
+void removeHashItem(pHash hash, pItem item) {
+    char* name = item->field->name;
+    unsigned index = findSlot(hash, name, internHash(name));
+    pItem cur = hash->slots[index].item;
+    assert(cur != NULL);
+    if (cur == item) {
+        hash->slots[index].item = item->nextHash;
+        if (item->nextHash == NULL) deleteSlot(hash, index);
+    } else {
+        while (cur->nextHash != item) cur = cur->nextHash;
+        cur->nextHash = item->nextHash;
+    }
+    item->nextHash = NULL;
+}
+
+pItem getHashHead(pHash hash, int index) {
     assert(hash != NULL);
-    hash->hashArray[index] = newVal;
+    return hash->slots[index].item;
 }
 // Table functions
 
@@ -284,14 +414,15 @@ pTable initTable() {
     table->hash = newHash();
     table->stack = newStack();
     table->unNamedStructNum = 0;
+    table->curFunc = NULL;
 
     // 添加read和write函数
     pItem readFun = newItem(
-        0, newFieldList(newString("read"),
+        0, newFieldList("read",
                         newType(FUNCTION, 0, NULL, newType(BASIC, INT_TYPE))));
 
     pItem writeFun = newItem(
-        0, newFieldList(newString("write"),
+        0, newFieldList("write",
                         newType(FUNCTION, 1,
                                 newFieldList("arg1", newType(BASIC, INT_TYPE)),
                                 newType(BASIC, INT_TYPE))));
@@ -306,18 +437,22 @@ void deleteTable(pTable table) {
     table->hash = NULL;
     deleteStack(table->stack);
     table->stack = NULL;
+    deleteTypes();
     free(table);
 };
 
+// name必须是intern得到的句柄
 pItem searchTableItem(pTable table, char* name) {
-    unsigned hashCode = getHashCode(name);
-    pItem temp = getHashHead(table->hash, hashCode);
-    if (temp == NULL) return NULL;
-    while (temp) {
-        if (!strcmp(temp->field->name, name)) return temp;
-        temp = temp->nextHash;
+    return searchHash(table->hash, name);
+}
+
+// 先查函数保留下来的局部符号，再查全局
+pItem searchFuncItem(pTable table, pItem func, char* name) {
+    if (func != NULL && func->locals != NULL) {
+        pItem item = searchHash(func->locals, name);
+        if (item != NULL) return item;
     }
-    return NULL;
+    return searchTableItem(table, name);
 }
 
 // Return false -> no confliction, true -> has confliction
@@ -325,7 +460,7 @@ boolean checkTableItemConflict(pTable table, pItem item) {
     pItem temp = searchTableItem(table, item->field->name);
     if (temp == NULL) return FALSE;
     while (temp) {
-        if (!strcmp(temp->field->name, item->field->name)) {
+        if (temp->field->name == item->field->name) {
             if (temp->field->type->kind == STRUCTURE ||
                 item->field->type->kind == STRUCTURE)
                 return TRUE;
@@ -338,8 +473,6 @@ boolean checkTableItemConflict(pTable table, pItem item) {
 
 void addTableItem(pTable table, pItem item) {
     assert(table != NULL && item != NULL);
-    unsigned hashCode = getHashCode(item->field->name);
-    pHash hash = table->hash;
     pStack stack = table->stack;
     // if (getCurDepthStackHead(stack) == NULL)
     //     setCurDepthStackHead(stack, item);
@@ -349,33 +482,19 @@ void addTableItem(pTable table, pItem item) {
     // }
     item->nextSymbol = getCurDepthStackHead(stack);
     setCurDepthStackHead(stack, item);
-
-    item->nextHash = getHashHead(hash, hashCode);
-    setHashHead(hash, hashCode, item);
+    addHashItem(table->hash, item);
 }
 
 void deleteTableItem(pTable table, pItem item) {
     assert(table != NULL && item != NULL);
-    unsigned hashCode = getHashCode(item->field->name);
-    if (item == getHashHead(table->hash, hashCode))
-        setHashHead(table->hash, hashCode, item->nextHash);
-    else {
-        pItem cur = getHashHead(table->hash, hashCode);
-        pItem last = cur;
-        while (cur != item) {
-            last = cur;
-            cur = cur->nextHash;
-        }
-        last->nextHash = cur->nextHash;
-    }
+    removeHashItem(table->hash, item);
     deleteItem(item);
 }
 
 boolean isStructDef(pItem src) {
     if (src == NULL) return FALSE;
-    if (src->field->type->kind != STRUCTURE) return FALSE;
-    if (src->field->type->u.structure.structName) return FALSE;
-    return TRUE;
+    // 结构体变量与定义共享同一类型，只能靠表项区分
+    return src->isStructDef;
 }
 
 // void addStructLayer(pTable table) { table->enterStructLayer++; }
@@ -397,10 +516,75 @@ void clearCurDepthStackList(pTable table) {
     minusStackDepth(stack);
 }
 
+// name在本函数的中间代码里是否已被占用：作用域里看得见的同名符号、
+// 已转存的局部符号，以及作用域里改名成name的符号。改出的名字是base_k，
+// 按最后一个下划线拆开就能找回base，到base的遮蔽链上去比
+static boolean localNameUsed(pItem func, char* name) {
+    if (searchTableItem(table, name) != NULL) return TRUE;
+    if (func->locals != NULL && searchHash(func->locals, name) != NULL)
+        return TRUE;
+    char* sep = strrchr(name, '_');
+    if (sep == NULL || sep[1] == '\0') return FALSE;
+    for (char* c = sep + 1; *c; c++)
+        if (*c < '0' || *c > '9') return FALSE;
+    char* base = (char*)malloc(sep - name + 1);
+    assert(base != NULL);
+    memcpy(base, name, sep - name);
+    base[sep - name] = '\0';
+    pItem item = searchTableItem(table, intern(base));
+    free(base);
+    for (; item; item = item->nextHash)
+        if (item->irName == name) return TRUE;
+    return FALSE;
+}
+
+// 局部符号转存后只按名字区分，同级块里的同名变量、内层遮蔽外层的变量
+// 要在中间代码里换成本函数没用过的名字base_k。在作用域里仍按原名查表，
+// 声明处和使用处的ID改成新名字，转存时以新名字登记
+static void renameLocal(pItem item, pNode varDec) {
+    pItem func = table->curFunc;
+    char* name = item->field->name;
+    if (func == NULL || !localNameUsed(func, name)) return;
+    char* buf = (char*)malloc(strlen(name) + 16);
+    assert(buf != NULL);
+    char* unique = NULL;
+    for (int k = 1; unique == NULL || localNameUsed(func, unique); k++) {
+        sprintf(buf, "%s_%d", name, k);
+        unique = intern(buf);
+    }
+    free(buf);
+    item->irName = unique;
+    while (varDec->child) varDec = varDec->child;
+    varDec->val = unique;
+}
+
+// 离开作用域：符号移出全局表，转存到所在函数的局部符号表供中间代码使用
+void popScope(pTable table) {
+    assert(table != NULL);
+    pStack stack = table->stack;
+    pItem func = table->curFunc;
+    pItem temp = getCurDepthStackHead(stack);
+    while (temp) {
+        pItem item = temp;
+        temp = temp->nextSymbol;
+        removeHashItem(table->hash, item);
+        item->nextSymbol = NULL;
+        if (func == NULL) {
+            deleteItem(item);
+            continue;
+        }
+        if (func->locals == NULL) func->locals = newHash();
+        if (item->irName != NULL) item->field->name = item->irName;
+        addHashItem(func->locals, item);
+    }
+    setCurDepthStackHead(stack, NULL);
+    minusStackDepth(stack);
+}
+
 // for Debug
 void printTable(pTable table) {
     printf("----------------hash_table----------------\n");
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
+    for (int i = 0; i < table->hash->size; i++) {
         pItem item = getHashHead(table->hash, i);
         if (item) {
             printf("[%d]", i);
@@ -422,17 +606,25 @@ void printTable(pTable table) {
 pStack newStack() {
     pStack p = (pStack)malloc(sizeof(Stack));
     assert(p != NULL);
-    p->stackArray = (pItem*)malloc(sizeof(pItem) * HASH_TABLE_SIZE);
+    p->size = STACK_INIT_SIZE;
+    p->stackArray = (pItem*)calloc(p->size, sizeof(pItem));
     assert(p->stackArray != NULL);
-    for (int i = 0; i < HASH_TABLE_SIZE; i++) {
-        p->stackArray[i] = NULL;
-    }
     p->curStackDepth = 0;
+    p->maxDepth = 0;
     return p;
 }
 
+// 每个表项恰好挂在一层作用域链上，释放代价与符号数成正比
 void deleteStack(pStack stack) {
     assert(stack != NULL);
+    for (int i = 0; i <= stack->maxDepth; i++) {
+        pItem temp = stack->stackArray[i];
+        while (temp) {
+            pItem tDelete = temp;
+            temp = temp->nextSymbol;
+            deleteItem(tDelete);
+        }
+    }
     free(stack->stackArray);
     stack->stackArray = NULL;
     stack->curStackDepth = 0;
@@ -442,6 +634,15 @@ void deleteStack(pStack stack) {
 void addStackDepth(pStack stack) {
     assert(stack != NULL);
     stack->curStackDepth++;
+    if (stack->curStackDepth == stack->size) {
+        stack->stackArray = (pItem*)realloc(stack->stackArray,
+                                            sizeof(pItem) * stack->size * 2);
+        assert(stack->stackArray != NULL);
+        memset(stack->stackArray + stack->size, 0, sizeof(pItem) * stack->size);
+        stack->size *= 2;
+    }
+    if (stack->curStackDepth > stack->maxDepth)
+        stack->maxDepth = stack->curStackDepth;
 }
 
 void minusStackDepth(pStack stack) {
@@ -464,7 +665,7 @@ void setCurDepthStackHead(pStack stack, pItem newVal) {
 void traverseTree(pNode node) {
     if (node == NULL) return;
 
-    if (!strcmp(node->name, "ExtDef")) ExtDef(node);
+    if (node->symbol == SYM_EXT_DEF) ExtDef(node);
 
     traverseTree(node->child);
     traverseTree(node->next);
@@ -477,19 +678,22 @@ void ExtDef(pNode node) {
     //         | Specifier SEMI
     //         | Specifier FunDec CompSt
     pType specifierType = Specifier(node->child);
-    char* secondName = node->child->next->name;
 
     // printType(specifierType);
-    // ExtDef -> Specifier ExtDecList SEMI
-    if (!strcmp(secondName, "ExtDecList")) {
-        ExtDecList(node->child->next, specifierType);
-    }
-    // ExtDef -> Specifier FunDec CompSt
-    else if (!strcmp(secondName, "FunDec")) {
-        FunDec(node->child->next, specifierType);
-        CompSt(node->child->next->next, specifierType);
+    switch (node->prod) {
+        // ExtDef -> Specifier ExtDecList SEMI
+        case PROD_EXT_DEF_VAR:
+            ExtDecList(node->child->next, specifierType);
+            break;
+        // ExtDef -> Specifier FunDec CompSt
+        case PROD_EXT_DEF_FUNC:
+            FunDec(node->child->next, specifierType);
+            CompSt(node->child->next->next, specifierType);
+            table->curFunc = NULL;
+            break;
+        default:
+            break;
     }
-    if (specifierType) deleteType(specifierType);
     // printTable(table);
     // Specifier SEMI
     // this situation has no meaning
@@ -526,7 +730,7 @@ pType Specifier(pNode node) {
 
     pNode t = node->child;
     // Specifier -> TYPE
-    if (!strcmp(t->name, "TYPE")) {
+    if (node->prod == PROD_SPECIFIER_TYPE) {
         if (!strcmp(t->val, "float")) {
             return newType(BASIC, FLOAT_TYPE);
         } else {
@@ -550,26 +754,30 @@ pType StructSpecifier(pNode node) {
     pNode t = node->child->next;
     // StructSpecifier->STRUCT OptTag LC DefList RC
     // printTreeInfo(t, 0);
-    if (strcmp(t->name, "Tag")) {
+    if (node->prod == PROD_STRUCT_DEF) {
         // addStructLayer(table);
-        pItem structItem =
-            newItem(table->stack->curStackDepth,
-                    newFieldList("", newType(STRUCTURE, NULL, NULL)));
-        if (!strcmp(t->name, "OptTag")) {
-            setFieldListName(structItem->field, t->child->val);
+        char* structName = NULL;
+        if (t->symbol == SYM_OPT_TAG) {
+            structName = t->child->val;
             t = t->next;
         }
         // unnamed struct
         else {
             table->unNamedStructNum++;
-            char structName[20] = {0};
-            sprintf(structName, "%d", table->unNamedStructNum);
-            // printf("unNamed struct's name is %s.\n", structName);
-            setFieldListName(structItem->field, structName);
+            char unNamed[20] = {0};
+            sprintf(unNamed, "%d", table->unNamedStructNum);
+            // printf("unNamed struct's name is %s.\n", unNamed);
+            structName = intern(unNamed);
         }
+        // 结构体类型只在这里创建一次，之后所有同名变量共享
+        pItem structItem =
+            newItem(table->stack->curStackDepth,
+                    newFieldList(structName,
+                                 newType(STRUCTURE, structName)));
+        structItem->isStructDef = TRUE;
         //现在我们进入结构体了！注意，报错信息会有不同！
         // addStackDepth(table->stack);
-        if (!strcmp(t->next->name, "DefList")) {
+        if (t->next->symbol == SYM_DEF_LIST) {
             DefList(t->next, structItem);
         }
 
@@ -579,15 +787,9 @@ pType StructSpecifier(pNode node) {
             pError(DUPLICATED_NAME, node->lineNo, msg);
             deleteItem(structItem);
         } else {
-            returnType = newType(
-                STRUCTURE, newString(structItem->field->name),
-                copyFieldList(structItem->field->type->u.structure.field));
-
-            // printf("\nnew Type:\n");
-            // printType(returnType);
-            // printf("\n");
+            returnType = structItem->field->type;
 
-            if (!strcmp(node->child->next->name, "OptTag")) {
+            if (node->child->next->symbol == SYM_OPT_TAG) {
                 addTableItem(table, structItem);
             }
             // OptTag -> e
@@ -609,9 +811,7 @@ pType StructSpecifier(pNode node) {
             sprintf(msg, "Undefined structure \"%s\".", t->child->val);
             pError(UNDEF_STRUCT, node->lineNo, msg);
         } else
-            returnType = newType(
-                STRUCTURE, newString(structItem->field->name),
-                copyFieldList(structItem->field->type->u.structure.field));
+            returnType = structItem->field->type;
     }
     // printType(returnType);
     return returnType;
@@ -631,9 +831,9 @@ pItem VarDec(pNode node, pType specifier) {
 
     // VarDec -> ID
     // printTreeInfo(node, 0);
-    if (!strcmp(node->child->name, "ID")) {
+    if (node->prod == PROD_VAR_DEC_ID) {
         // printf("copy type tp %s.\n", node->child->val);
-        p->field->type = copyType(specifier);
+        p->field->type = specifier;
     }
     // VarDec -> VarDec LB INT RB
     else {
@@ -645,7 +845,7 @@ pItem VarDec(pNode node, pType specifier) {
             // printf("number: %s\n", varDec->next->next->val);
             // printf("temp type: %d\n", temp->kind);
             p->field->type =
-                newType(ARRAY, copyType(temp), atoi(varDec->next->next->val));
+                newType(ARRAY, temp, atoi(varDec->next->next->val));
             // printf("newType. newType: elem type: %d, elem size: %d.\n",
             //        p->field->type->u.array.elem->kind,
             //        p->field->type->u.array.size);
@@ -662,7 +862,7 @@ pItem VarDec(pNode node, pType specifier) {
 
 // pType generateVarDecType(pNode node, pType type) {
 //     // VarDec -> ID
-//     if (!strcmp(node->child->name, "ID")) return copyType(type);
+//     if (!strcmp(node->child->name, "ID")) return type;
 //     // VarDec -> VarDec LB INT RB
 //     else
 //         return newType(ARRAY, atoi(node->child->next->next->val),
@@ -676,10 +876,10 @@ void FunDec(pNode node, pType returnType) {
     pItem p =
         newItem(table->stack->curStackDepth,
                 newFieldList(node->child->val,
-                             newType(FUNCTION, 0, NULL, copyType(returnType))));
+                             newType(FUNCTION, 0, NULL, returnType)));
 
     // FunDec -> ID LP VarList RP
-    if (!strcmp(node->child->next->next->name, "VarList")) {
+    if (node->prod == PROD_FUN_DEC_ARGS) {
         VarList(node->child->next->next, p);
     }
 
@@ -695,6 +895,7 @@ void FunDec(pNode node, pType returnType) {
     } else {
         addTableItem(table, p);
     }
+    table->curFunc = p;
 }
 
 void VarList(pNode node, pItem func) {
@@ -733,7 +934,6 @@ pFieldList ParamDec(pNode node) {
     // ParamDec -> Specifier VarDec
     pType specifierType = Specifier(node->child);
     pItem p = VarDec(node->child->next, specifierType);
-    if (specifierType) deleteType(specifierType);
     if (checkTableItemConflict(table, p)) {
         char msg[100] = {0};
         sprintf(msg, "Redefined variable \"%s\".", p->field->name);
@@ -752,14 +952,14 @@ void CompSt(pNode node, pType returnType) {
     // CompSt -> LC DefList StmtList RC
     addStackDepth(table->stack);
     pNode temp = node->child->next;
-    if (!strcmp(temp->name, "DefList")) {
+    if (temp->symbol == SYM_DEF_LIST) {
         DefList(temp, NULL);
         temp = temp->next;
     }
-    if (!strcmp(temp->name, "StmtList")) {
+    if (temp->symbol == SYM_STMT_LIST) {
         StmtList(temp, returnType);
     }
-    // Removed clearCurDepthStackList(table);
+    popScope(table);
 }
 
 void StmtList(pNode node, pType returnType) {
@@ -784,39 +984,48 @@ void Stmt(pNode node, pType returnType) {
     // printTreeInfo(node, 0);
 
     pType expType = NULL;
-    // Stmt -> Exp SEMI
-    if (!strcmp(node->child->name, "Exp")) expType = Exp(node->child);
+    pNode stmt = NULL;
+    switch (node->prod) {
+        // Stmt -> Exp SEMI
+        case PROD_STMT_EXP:
+            expType = Exp(node->child);
+            break;
 
-    // Stmt -> CompSt
-    else if (!strcmp(node->child->name, "CompSt"))
-        CompSt(node->child, returnType);
+        // Stmt -> CompSt
+        case PROD_STMT_COMP_ST:
+            CompSt(node->child, returnType);
+            break;
 
-    // Stmt -> RETURN Exp SEMI
-    else if (!strcmp(node->child->name, "RETURN")) {
-        expType = Exp(node->child->next);
+        // Stmt -> RETURN Exp SEMI
+        case PROD_STMT_RETURN:
+            expType = Exp(node->child->next);
 
-        // check return type
-        if (!checkType(returnType, expType))
-            pError(TYPE_MISMATCH_RETURN, node->lineNo,
-                   "Type mismatched for return.");
-    }
+            // check return type
+            if (!checkType(returnType, expType))
+                pError(TYPE_MISMATCH_RETURN, node->lineNo,
+                       "Type mismatched for return.");
+            break;
 
-    // Stmt -> IF LP Exp RP Stmt
-    else if (!strcmp(node->child->name, "IF")) {
-        pNode stmt = node->child->next->next->next->next;
-        expType = Exp(node->child->next->next);
-        Stmt(stmt, returnType);
-        // Stmt -> IF LP Exp RP Stmt ELSE Stmt
-        if (stmt->next != NULL) Stmt(stmt->next->next, returnType);
-    }
+        // Stmt -> IF LP Exp RP Stmt
+        //       | IF LP Exp RP Stmt ELSE Stmt
+        case PROD_STMT_IF:
+        case PROD_STMT_IF_ELSE:
+            stmt = node->child->next->next->next->next;
+            expType = Exp(node->child->next->next);
+            Stmt(stmt, returnType);
+            if (node->prod == PROD_STMT_IF_ELSE)
+                Stmt(stmt->next->next, returnType);
+            break;
 
-    // Stmt -> WHILE LP Exp RP Stmt
-    else if (!strcmp(node->child->name, "WHILE")) {
-        expType = Exp(node->child->next->next);
-        Stmt(node->child->next->next->next->next, returnType);
-    }
+        // Stmt -> WHILE LP Exp RP Stmt
+        case PROD_STMT_WHILE:
+            expType = Exp(node->child->next->next);
+            Stmt(node->child->next->next->next->next, returnType);
+            break;
 
-    if (expType) deleteType(expType);
+        default:
+            break;
+    }
 }
 
 void DefList(pNode node, pItem structInfo) {
@@ -836,7 +1045,6 @@ void Def(pNode node, pItem structInfo) {
     pType dectype = Specifier(node->child);
     //你总会得到一个正确的type
     DecList(node->child->next, dectype, structInfo);
-    if (dectype) deleteType(dectype);
 }
 
 void DecList(pNode node, pType specifier, pItem structInfo) {
@@ -867,26 +1075,15 @@ void Dec(pNode node, pType specifier, pItem structInfo) {
                 pError(REDEF_FEILD, node->lineNo, "Invalid struct field definition.");
                 return;
             }
-            pFieldList payload = decitem->field;
-            pFieldList structField = structInfo->field->type->u.structure.field;
-            pFieldList last = NULL;
-            while (structField != NULL) {
-                if (!strcmp(payload->name, structField->name)) {
-                    char msg[100] = {0};
-                    sprintf(msg, "Redefined field \"%s\".", decitem->field->name);
-                    pError(REDEF_FEILD, node->lineNo, msg);
-                    deleteItem(decitem);
-                    return;
-                } else {
-                    last = structField;
-                    structField = structField->tail;
-                }
-            }
-            if (last == NULL) {
-                structInfo->field->type->u.structure.field = copyFieldList(decitem->field);
-            } else {
-                last->tail = copyFieldList(decitem->field);
+            // 域结点直接挂到结构体类型上，偏移也随之排好
+            if (!addField(structInfo->field->type, decitem->field)) {
+                char msg[100] = {0};
+                sprintf(msg, "Redefined field \"%s\".", decitem->field->name);
+                pError(REDEF_FEILD, node->lineNo, msg);
+                deleteItem(decitem);
+                return;
             }
+            decitem->field = NULL;
             deleteItem(decitem);
         } else {
             pItem decitem = VarDec(node->child, specifier);
@@ -900,6 +1097,7 @@ void Dec(pNode node, pType specifier, pItem structInfo) {
                 pError(REDEF_VAR, node->lineNo, msg);
                 deleteItem(decitem);
             } else {
+                renameLocal(decitem, node->child);
                 addTableItem(table, decitem);
             }
         }
@@ -930,9 +1128,9 @@ void Dec(pNode node, pType specifier, pItem structInfo) {
                 pError(TYPE_MISMATCH_ASSIGN, node->lineNo, "Illegal initialize variable.");
                 deleteItem(decitem);
             } else {
+                renameLocal(decitem, node->child);
                 addTableItem(table, decitem);
             }
-            if (exptype) deleteType(exptype);
         }
     }
 }
@@ -958,208 +1156,183 @@ pType Exp(pNode node) {
     //      | INT
     //      | FLOAT
     pNode t = node->child;
+    pType p1 = NULL, p2 = NULL, returnType = NULL;
+    pItem item = NULL;
     // exp will only check if the cal is right
     //  printTable(table);
-    //二值运算
-    if (!strcmp(t->name, "Exp")) {
-        // 基本数学运算符
-        if (strcmp(t->next->name, "LB") && strcmp(t->next->name, "DOT")) {
-            pType p1 = Exp(t);
-            pType p2 = Exp(t->next->next);
-            pType returnType = NULL;
-
-            // Exp -> Exp ASSIGNOP Exp
-            if (!strcmp(t->next->name, "ASSIGNOP")) {
-                //检查左值
-                pNode tchild = t->child;
-
-                if (!strcmp(tchild->name, "FLOAT") ||
-                    !strcmp(tchild->name, "INT")) {
-                    //报错，左值
-                    pError(LEFT_VAR_ASSIGN, t->lineNo,
-                           "The left-hand side of an assignment must be "
-                           "avariable.");
-
-                } else if (!strcmp(tchild->name, "ID") ||
-                           !strcmp(tchild->next->name, "LB") ||
-                           !strcmp(tchild->next->name, "DOT")) {
+    switch (node->prod) {
+        // Exp -> Exp ASSIGNOP Exp
+        case PROD_EXP_ASSIGN:
+            p1 = Exp(t);
+            p2 = Exp(t->next->next);
+            //检查左值
+            switch (t->prod) {
+                case PROD_EXP_ID:
+                case PROD_EXP_INDEX:
+                case PROD_EXP_DOT:
                     if (!checkType(p1, p2)) {
                         //报错，类型不匹配
                         pError(TYPE_MISMATCH_ASSIGN, t->lineNo,
                                "Type mismatched for assignment.");
                     } else
-                        returnType = copyType(p1);
-                } else {
+                        returnType = p1;
+                    break;
+                default:
                     //报错，左值
                     pError(LEFT_VAR_ASSIGN, t->lineNo,
                            "The left-hand side of an assignment must be "
                            "avariable.");
-                }
-
+                    break;
             }
-            // Exp -> Exp AND Exp
-            //      | Exp OR Exp
-            //      | Exp RELOP Exp
-            //      | Exp PLUS Exp
-            //      | Exp MINUS Exp
-            //      | Exp STAR Exp
-            //      | Exp DIV Exp
-            else {
-                if (p1 && p2 && (p1->kind == ARRAY || p2->kind == ARRAY)) {
-                    //报错，数组，结构体运算
-                    pError(TYPE_MISMATCH_OP, t->lineNo,
-                           "Type mismatched for operands.");
-                } else if (!checkType(p1, p2)) {
-                    //报错，类型不匹配
-                    pError(TYPE_MISMATCH_OP, t->lineNo,
-                           "Type mismatched for operands.");
-                } else {
-                    if (p1 && p2) {
-                        returnType = copyType(p1);
-                    }
+            return returnType;
+
+        // 基本数学运算符
+        // Exp -> Exp AND Exp
+        //      | Exp OR Exp
+        //      | Exp RELOP Exp
+        //      | Exp PLUS Exp
+        //      | Exp MINUS Exp
+        //      | Exp STAR Exp
+        //      | Exp DIV Exp
+        case PROD_EXP_AND:
+        case PROD_EXP_OR:
+        case PROD_EXP_RELOP:
+        case PROD_EXP_PLUS:
+        case PROD_EXP_MINUS:
+        case PROD_EXP_STAR:
+        case PROD_EXP_DIV:
+            p1 = Exp(t);
+            p2 = Exp(t->next->next);
+            if (p1 && p2 && (p1->kind == ARRAY || p2->kind == ARRAY)) {
+                //报错，数组，结构体运算
+                pError(TYPE_MISMATCH_OP, t->lineNo,
+                       "Type mismatched for operands.");
+            } else if (!checkType(p1, p2)) {
+                //报错，类型不匹配
+                pError(TYPE_MISMATCH_OP, t->lineNo,
+                       "Type mismatched for operands.");
+            } else {
+                if (p1 && p2) {
+                    returnType = p1;
                 }
             }
+            return returnType;
 
-            if (p1) deleteType(p1);
-            if (p2) deleteType(p2);
+        // 数组访问
+        // Exp -> Exp LB Exp RB
+        case PROD_EXP_INDEX:
+            p1 = Exp(t);
+            p2 = Exp(t->next->next);
+            if (!p1) {
+                // 第一个exp为null，上层报错，这里不用再管
+            } else if (p1 && p1->kind != ARRAY) {
+                //报错，非数组使用[]运算符
+                char msg[100] = {0};
+                sprintf(msg, "\"%s\" is not an array.", t->child->val);
+                pError(NOT_A_ARRAY, t->lineNo, msg);
+            } else if (!p2 || p2->kind != BASIC || p2->u.basic != INT_TYPE) {
+                //报错，不用int索引[]
+                char msg[100] = {0};
+                sprintf(msg, "\"%s\" is not an integer.",
+                        t->next->next->child->val);
+                pError(NOT_A_INT, t->lineNo, msg);
+            } else {
+                returnType = p1->u.array.elem;
+            }
             return returnType;
-        }
-        // 数组和结构体访问
-        else {
-            // Exp -> Exp LB Exp RB
-            if (!strcmp(t->next->name, "LB")) {
-                //数组
-                pType p1 = Exp(t);
-                pType p2 = Exp(t->next->next);
-                pType returnType = NULL;
-
-                if (!p1) {
-                    // 第一个exp为null，上层报错，这里不用再管
-                } else if (p1 && p1->kind != ARRAY) {
-                    //报错，非数组使用[]运算符
-                    char msg[100] = {0};
-                    sprintf(msg, "\"%s\" is not an array.", t->child->val);
-                    pError(NOT_A_ARRAY, t->lineNo, msg);
-                } else if (!p2 || p2->kind != BASIC ||
-                           p2->u.basic != INT_TYPE) {
-                    //报错，不用int索引[]
-                    char msg[100] = {0};
-                    sprintf(msg, "\"%s\" is not an integer.",
-                            t->next->next->child->val);
-                    pError(NOT_A_INT, t->lineNo, msg);
+
+        // 结构体访问
+        // Exp -> Exp DOT ID
+        case PROD_EXP_DOT:
+            p1 = Exp(t);
+            if (!p1 || p1->kind != STRUCTURE) {
+                //报错，对非结构体使用.运算符
+                pError(ILLEGAL_USE_DOT, t->lineNo, "Illegal use of \".\".");
+            } else {
+                pNode ref_id = t->next->next;
+                pFieldList structfield = searchField(p1, ref_id->val);
+                if (structfield == NULL) {
+                    //报错，没有可以匹配的域名
+                    printf("Error type %d at Line %d: %s.\n", 14, t->lineNo,
+                           "NONEXISTFIELD");
                 } else {
-                    returnType = copyType(p1->u.array.elem);
+                    returnType = structfield->type;
                 }
-                if (p1) deleteType(p1);
-                if (p2) deleteType(p2);
-                return returnType;
             }
-            // Exp -> Exp DOT ID
-            else {
-                pType p1 = Exp(t);
-                pType returnType = NULL;
-                if (!p1 || p1->kind != STRUCTURE ||
-                    !p1->u.structure.structName) {
-                    //报错，对非结构体使用.运算符
-                    pError(ILLEGAL_USE_DOT, t->lineNo, "Illegal use of \".\".");
-                    if (p1) deleteType(p1);
-                } else {
-                    pNode ref_id = t->next->next;
-                    pFieldList structfield = p1->u.structure.field;
-                    while (structfield != NULL) {
-                        if (!strcmp(structfield->name, ref_id->val)) {
-                            break;
-                        }
-                        structfield = structfield->tail;
-                    }
-                    if (structfield == NULL) {
-                        //报错，没有可以匹配的域名
-                        printf("Error type %d at Line %d: %s.\n", 14, t->lineNo,
-                               "NONEXISTFIELD");
-                        ;
-                    } else {
-                        returnType = copyType(structfield->type);
-                    }
-                }
-                if (p1) deleteType(p1);
-                return returnType;
+            return returnType;
+
+        //单目运算符
+        // Exp -> MINUS Exp
+        //      | NOT Exp
+        case PROD_EXP_NEG:
+        case PROD_EXP_NOT:
+            p1 = Exp(t->next);
+            if (!p1 || p1->kind != BASIC) {
+                //报错，数组，结构体运算
+                printf("Error type %d at Line %d: %s.\n", 7, t->lineNo,
+                       "TYPE_MISMATCH_OP");
+            } else {
+                returnType = p1;
             }
-        }
-    }
-    //单目运算符
-    // Exp -> MINUS Exp
-    //      | NOT Exp
-    else if (!strcmp(t->name, "MINUS") || !strcmp(t->name, "NOT")) {
-        pType p1 = Exp(t->next);
-        pType returnType = NULL;
-        if (!p1 || p1->kind != BASIC) {
-            //报错，数组，结构体运算
-            printf("Error type %d at Line %d: %s.\n", 7, t->lineNo,
-                   "TYPE_MISMATCH_OP");
-        } else {
-            returnType = copyType(p1);
-        }
-        if (p1) deleteType(p1);
-        return returnType;
-    } else if (!strcmp(t->name, "LP")) {
-        return Exp(t->next);
-    }
-    // Exp -> ID LP Args RP
-    //		| ID LP RP
-    else if (!strcmp(t->name, "ID") && t->next) {
-        pItem funcInfo = searchTableItem(table, t->val);
+            return returnType;
+
+        // Exp -> LP Exp RP
+        case PROD_EXP_PAREN:
+            return Exp(t->next);
 
-        // function not find
-        if (funcInfo == NULL) {
-            char msg[100] = {0};
-            sprintf(msg, "Undefined function \"%s\".", t->val);
-            pError(UNDEF_FUNC, node->lineNo, msg);
-            return NULL;
-        } else if (funcInfo->field->type->kind != FUNCTION) {
-            char msg[100] = {0};
-            sprintf(msg, "\"i\" is not a function.", t->val);
-            pError(NOT_A_FUNC, node->lineNo, msg);
-            return NULL;
-        }
         // Exp -> ID LP Args RP
-        else if (!strcmp(t->next->next->name, "Args")) {
-            Args(t->next->next, funcInfo);
-            return copyType(funcInfo->field->type->u.function.returnType);
-        }
-        // Exp -> ID LP RP
-        else {
-            if (funcInfo->field->type->u.function.argc != 0) {
+        //		| ID LP RP
+        case PROD_EXP_CALL_ARGS:
+        case PROD_EXP_CALL:
+            item = searchTableItem(table, t->val);
+
+            // function not find
+            if (item == NULL) {
+                char msg[100] = {0};
+                sprintf(msg, "Undefined function \"%s\".", t->val);
+                pError(UNDEF_FUNC, node->lineNo, msg);
+                return NULL;
+            } else if (item->field->type->kind != FUNCTION) {
+                char msg[100] = {0};
+                sprintf(msg, "\"i\" is not a function.", t->val);
+                pError(NOT_A_FUNC, node->lineNo, msg);
+                return NULL;
+            }
+            // Exp -> ID LP Args RP
+            else if (node->prod == PROD_EXP_CALL_ARGS) {
+                Args(t->next->next, item);
+            }
+            // Exp -> ID LP RP
+            else if (item->field->type->u.function.argc != 0) {
                 char msg[100] = {0};
                 sprintf(msg,
                         "too few arguments to function \"%s\", except %d args.",
-                        funcInfo->field->name,
-                        funcInfo->field->type->u.function.argc);
+                        item->field->name, item->field->type->u.function.argc);
                 pError(FUNC_AGRC_MISMATCH, node->lineNo, msg);
             }
-            return copyType(funcInfo->field->type->u.function.returnType);
-        }
-    }
-    // Exp -> ID
-    else if (!strcmp(t->name, "ID")) {
-        pItem tp = searchTableItem(table, t->val);
-        if (tp == NULL || isStructDef(tp)) {
-            char msg[100] = {0};
-            sprintf(msg, "Undefined variable \"%s\".", t->val);
-            pError(UNDEF_VAR, t->lineNo, msg);
-            return NULL;
-        } else {
-            // good
-            return copyType(tp->field->type);
-        }
-    } else {
+            return item->field->type->u.function.returnType;
+
+        // Exp -> ID
+        case PROD_EXP_ID:
+            item = searchTableItem(table, t->val);
+            if (item == NULL || isStructDef(item)) {
+                char msg[100] = {0};
+                sprintf(msg, "Undefined variable \"%s\".", t->val);
+                pError(UNDEF_VAR, t->lineNo, msg);
+                return NULL;
+            } else {
+                // 局部变量可能在声明时改过名，使用处跟着换
+                if (item->irName != NULL) t->val = item->irName;
+                return item->field->type;
+            }
+
         // Exp -> FLOAT
-        if (!strcmp(t->name, "FLOAT")) {
+        case PROD_EXP_FLOAT:
             return newType(BASIC, FLOAT_TYPE);
-        }
+
         // Exp -> INT
-        else {
+        default:
             return newType(BASIC, INT_TYPE);
-        }
     }
 }
 
@@ -1186,15 +1359,19 @@ void Args(pNode node, pItem funcInfo) {
         // printf("=======arg type=========\n");
         // printType(realType);
         // printf("===========end==========\n");
-        if (!checkType(realType, arg->type)) {
+        // 数组传址，被调函数按形参的类型算步长，除最外一维外各维都要一样大。
+        // 数组类型按(元素类型, 大小)驻留，比较元素类型的指针即可
+        boolean arrayMismatch = realType && arg->type &&
+                                realType->kind == ARRAY &&
+                                arg->type->kind == ARRAY &&
+                                realType->u.array.elem != arg->type->u.array.elem;
+        if (!checkType(realType, arg->type) || arrayMismatch) {
             char msg[100] = {0};
             sprintf(msg, "Function \"%s\" is not applicable for arguments.",
                     funcInfo->field->name);
             pError(FUNC_AGRC_MISMATCH, node->lineNo, msg);
-            if (realType) deleteType(realType);
             return;
         }
-        if (realType) deleteType(realType);
 
         arg = arg->tail;
         if (temp->child->next) {
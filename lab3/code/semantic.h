@@ -1,8 +1,8 @@
 #ifndef SEMANTIC_H
 #define SEMENTIC_H
 
-#define HASH_TABLE_SIZE 0x3fff
-#define STACK_DEEP
+#define HASH_INIT_SIZE 64   // 必须是2的幂
+#define STACK_INIT_SIZE 16
 
 #include "node.h"
 
@@ -22,11 +22,18 @@ typedef struct type {
         struct {
             pType elem;
             int size;
+            int width;  // 元素的字节数，即这一维行优先的步长
         } array;
-        // 结构体类型信息是一个链表
+        // 结构体类型信息是一个链表，布局随域的加入在定义处算好
         struct {
             char* structName;
             pFieldList field;
+            pFieldList last;    // 最后一个域，追加用
+            pFieldList* index;  // 域名索引，开放定址，槽数是2的幂
+            int indexSize;
+            int fieldNum;
+            int size;
+            int align;
         } structure;
 
         struct {
@@ -35,6 +42,9 @@ typedef struct type {
             pType returnType;  // returnType
         } function;
     } u;
+    pType arrays;     // 以本类型为元素的数组类型
+    pType nextArray;  // 元素类型相同的下一个数组类型
+    pType nextType;   // 类型表中的下一个类型
 } Type;
 
 typedef struct fieldList {
@@ -42,38 +52,57 @@ typedef struct fieldList {
     pType type;  // 域的类型
     pFieldList tail;  // 下一个域
     boolean isArg;  // 是否为函数参数
+    int offset;  // 结构体的域相对结构体开头的字节偏移
 } FieldList;
 
 typedef struct tableItem {
     int symbolDepth;
     pFieldList field;
+    boolean isStructDef;  // 结构体定义而非变量
+    pHash locals;  // 函数的局部符号，离开作用域后保留给中间代码生成
+    char* irName;  // 改过名的局部变量在中间代码里的名字，没改过为NULL
     pItem nextSymbol;  // same depth next symbol, linked from stack
-    pItem nextHash;    // same hash code next symbol, linked from hash table
+    pItem nextHash;    // same name outer symbol, linked from hash slot
 } TableItem;
 
+typedef struct hashSlot {
+    unsigned hash;  // 名字的哈希值，探测时先比较它
+    char* name;     // 名字句柄，比较时不必再去碰表项
+    pItem item;     // 最内层的同名表项，外层的经nextHash相连
+} HashSlot;
+
+// 开放定址（线性探测），每个不同的名字占一个槽
 typedef struct hashTable {
-    pItem* hashArray;
+    HashSlot* slots;
+    int size;   // 槽数
+    int count;  // 已占用的槽数
 } HashTable;
 
 typedef struct stack {
     pItem* stackArray;
+    int size;
     int curStackDepth;
+    int maxDepth;  // 用过的最大深度
 } Stack;
 
 typedef struct table {
     pHash hash;
     pStack stack;
     int unNamedStructNum;
+    pItem curFunc;  // 正在分析的函数
     // int enterStructLayer;
 } Table;
 
 extern pTable table;
+extern boolean semError;
 
 // Type functions
 pType newType(Kind kind, ...);
-pType copyType(pType src);
-void deleteType(pType type);
+void deleteTypes();
 boolean checkType(pType type1, pType type2);
+int getSize(pType type);
+pFieldList searchField(pType type, char* name);
+boolean addField(pType type, pFieldList field);
 void printType(pType type);
 
 // FieldList functions
@@ -110,8 +139,10 @@ boolean isStructDef(pItem src);
 // Hash functions
 pHash newHash();
 void deleteHash(pHash hash);
+pItem searchHash(pHash hash, char* name);
+void addHashItem(pHash hash, pItem item);
+void removeHashItem(pHash hash, pItem item);
 pItem getHashHead(pHash hash, int index);
-void setHashHead(pHash hash, int index, pItem newVal);
 
 // Stack functions
 pStack newStack();
@@ -125,27 +156,20 @@ void setCurDepthStackHead(pStack stack, pItem newVal);
 pTable initTable();
 void deleteTable(pTable table);
 pItem searchTableItem(pTable table, char* name);
+pItem searchFuncItem(pTable table, pItem func, char* name);
 boolean checkTableItemConflict(pTable table, pItem item);
 void addTableItem(pTable table, pItem item);
 void deleteTableItem(pTable table, pItem item);
 void clearCurDepthStackList(pTable table);
+void popScope(pTable table);
 // void addStructLayer(pTable table);
 // void minusStructLayer(pTable table);
 // boolean isInStructLayer(pTable table);
 void printTable(pTable table);
 
 // Global functions
-static inline unsigned int getHashCode(char* name) {
-    unsigned int val = 0, i;
-    for (; *name; ++name) {
-        val = (val << 2) + *name;
-        if (i = val & ~HASH_TABLE_SIZE)
-            val = (val ^ (i >> 12)) & HASH_TABLE_SIZE;
-    }
-    return val;
-}
-
 static inline void pError(ErrorType type, int line, char* msg) {
+    semError = TRUE;
     printf("Error type %d at Line %d: %s\n", type, line, msg);
 }
 
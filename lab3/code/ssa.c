@@ -0,0 +1,1247 @@
+#include "optimize.h"
+#include "ssa.h"
+
+// SSA的构造（Cytron等人的算法）：
+//   只有在某块里先读后写的值才可能跨块活跃，只给它们放φ。φ放在定值块的
+//   迭代支配边界上，入口块也算一个定值块，代表入口处的值；值在那里不活跃
+//   就不放（剪枝），否则长函数里φ的个数是值的个数乘块数；
+//   再沿支配树先序改名，每个值当前的名字记在valCur里，出块时按日志撤销。
+// 回到普通代码：
+//   先删掉没人用的φ。φ的定值和参数按循环深度从深到浅尝试合并成一个
+//   等价类，两个类里有同时活跃的名字就不合并，x := y 的x和y不算冲突。
+//   合并掉的φ参数不用复写，其余的在前驱末尾插一组并行复写；前驱有两个
+//   后继时在边上开一块：落空的边直接接在IF之后，跳转的边放在目标块前面，
+//   IF改跳过去。并行复写按依赖排序，成环时借一个临时变量。
+//   跨块活跃的名字也参加合并：同一个值的等价类互不冲突的并成一个。
+//   每个值的名字最多分给一个等价类，形参的先分，其余的用新临时变量
+static pSsa cur;
+static int funcId;
+static int* valStamp;      // valueIndex -> 下面几项所属的函数
+static char* valMem;       // 被DEC或取址，不改名
+static int* valGlobal;     // 跨块活跃的值的编号，-1表示只在块内活跃
+static int* valDefSeen;    // 当前块里定值过，按块的时间戳
+static OperandId* valCur;  // 当前的名字，NO_OPERAND表示入口处的值
+static OperandId* valEntry;
+static char* valClaimed;   // 名字已经分给了某个等价类
+static OperandId* valOrig; // 原来的操作数
+static int* valClass;      // 回到普通代码时用这个值的名字的等价类，-1表示还没有
+static int blockStamp;
+
+static void touchValue(int v) {
+    if (valStamp[v] == funcId) return;
+    valStamp[v] = funcId;
+    valMem[v] = 0;
+    valGlobal[v] = -1;
+    valDefSeen[v] = 0;
+    valCur[v] = NO_OPERAND;
+    valEntry[v] = NO_OPERAND;
+    valClaimed[v] = 0;
+    valOrig[v] = NO_OPERAND;
+    valClass[v] = -1;
+}
+
+// 能改名的值返回valueIndex，否则返回-1
+static int renameIndex(OperandId id) {
+    int v = valueIndex(id);
+    if (v < 0) return -1;
+    touchValue(v);
+    if (valOrig[v] == NO_OPERAND) valOrig[v] = id;
+    return valMem[v] ? -1 : v;
+}
+
+static OperandId withAddr(OperandId id, boolean isAddr) {
+    if (!isAddr) return id;
+    OperandId r = newOperand(OP_TEMP, getOperand(id)->u.no);
+    getOperand(r)->isAddr = TRUE;
+    return r;
+}
+
+static OperandId newName(int var, int code, int phi) {
+    pSsa s = cur;
+    if (s->nameNum == s->nameCap) {
+        s->nameCap = s->nameCap ? s->nameCap * 2 : 256;
+        s->nameOp = (OperandId*)realloc(s->nameOp, sizeof(OperandId) * s->nameCap);
+        s->nameVar = (int*)realloc(s->nameVar, sizeof(int) * s->nameCap);
+        s->defCode = (int*)realloc(s->defCode, sizeof(int) * s->nameCap);
+        s->defPhi = (int*)realloc(s->defPhi, sizeof(int) * s->nameCap);
+        assert(s->nameOp && s->nameVar && s->defCode && s->defPhi);
+    }
+    OperandId id = newTemp();
+    assert(getOperand(id)->u.no == s->base + s->nameNum);
+    s->nameOp[s->nameNum] = id;
+    s->nameVar[s->nameNum] = var;
+    s->defCode[s->nameNum] = code;
+    s->defPhi[s->nameNum] = phi;
+    s->nameNum++;
+    return id;
+}
+
+static OperandId currentName(int v) {
+    if (valCur[v]) return valCur[v];
+    if (valEntry[v] == NO_OPERAND) valEntry[v] = newName(v, -1, -1);
+    return valEntry[v];
+}
+
+boolean predAlive(pSsa ssa, int b, int k) {
+    pCfg cfg = ssa->cfg;
+    int p = cfg->blocks[b].pred[k];
+    if (ssa->blockDead[p] || ssa->blockDead[b]) return FALSE;
+    forEachSucc(cfg, p, s)
+        if (s == b && !ssa->succDead[p * 2 + _i_s]) return TRUE;
+    return FALSE;
+}
+
+boolean replaceUse(pSsa ssa, pInterCode code, OperandId* slot, OperandId value) {
+    boolean isAddr = getOperand(*slot)->isAddr;
+    if (getOperand(value)->kind == OP_CONSTANT) {
+        if (isAddr ||
+            (code->kind == IR_READ_ADDR && slot == &code->u.assign.right) ||
+            (code->kind == IR_WRITE_ADDR && slot == &code->u.assign.left))
+            return FALSE;
+        *slot = value;
+        return TRUE;
+    }
+    int idx = ssaIndex(ssa, value);
+    *slot = withAddr(idx >= 0 ? ssa->nameOp[idx] : value, isAddr);
+    return TRUE;
+}
+
+// CSR形式的块 -> 块列表
+typedef struct _blockLists {
+    int* start;
+    int* items;
+} BlockLists;
+
+// 支配边界：Cooper-Harvey-Kennedy的做法，从每个汇合点的前驱沿支配树
+// 往上走到它的直接支配者为止，途经的块的支配边界里都有这个汇合点。
+// 第一遍数个数，第二遍填
+static BlockLists dominanceFrontiers(pCfg cfg) {
+    int n = cfg->blockNum;
+    BlockLists df;
+    df.start = (int*)calloc(n + 1, sizeof(int));
+    int* last = (int*)malloc(sizeof(int) * n);
+    int* fill = (int*)malloc(sizeof(int) * n);
+    assert(df.start && last && fill);
+    df.items = NULL;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int b = 0; b < n; b++) last[b] = -1;
+        forEachRpo(cfg, b) {
+            if (cfg->blocks[b].predNum < 2) continue;
+            forEachPred(cfg, b, p) {
+                if (cfg->blocks[p].rpo < 0) continue;
+                for (int r = p; r != cfg->blocks[b].idom; r = cfg->blocks[r].idom) {
+                    if (last[r] == b) continue;
+                    last[r] = b;
+                    if (pass == 0)
+                        df.start[r + 1]++;
+                    else
+                        df.items[fill[r]++] = b;
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int b = 0; b < n; b++) df.start[b + 1] += df.start[b];
+            df.items = (int*)malloc(sizeof(int) * (df.start[n] + 1));
+            assert(df.items != NULL);
+            memcpy(fill, df.start, sizeof(int) * n);
+        }
+    }
+    free(last);
+    free(fill);
+    return df;
+}
+
+static BlockLists domChildren(pCfg cfg) {
+    int n = cfg->blockNum;
+    BlockLists tree;
+    tree.start = (int*)calloc(n + 1, sizeof(int));
+    tree.items = (int*)malloc(sizeof(int) * n);
+    int* fill = (int*)malloc(sizeof(int) * n);
+    assert(tree.start && tree.items && fill);
+    for (int i = 1; i < cfg->rpoNum; i++)
+        tree.start[cfg->blocks[cfg->rpo[i]].idom + 1]++;
+    for (int b = 0; b < n; b++) tree.start[b + 1] += tree.start[b];
+    memcpy(fill, tree.start, sizeof(int) * n);
+    for (int i = 1; i < cfg->rpoNum; i++) {
+        int b = cfg->rpo[i];
+        tree.items[fill[cfg->blocks[b].idom]++] = b;
+    }
+    free(fill);
+    return tree;
+}
+
+static void addPhi(int b, int var) {
+    pSsa s = cur;
+    if (s->phiNum == s->phiCap) {
+        s->phiCap = s->phiCap ? s->phiCap * 2 : 64;
+        s->phis = (pPhi)realloc(s->phis, sizeof(Phi) * s->phiCap);
+        assert(s->phis != NULL);
+    }
+    int predNum = s->cfg->blocks[b].predNum;
+    while (s->argNum + predNum > s->argCap) {
+        s->argCap = s->argCap ? s->argCap * 2 : 256;
+        s->phiArgs = (OperandId*)realloc(s->phiArgs, sizeof(OperandId) * s->argCap);
+        assert(s->phiArgs != NULL);
+    }
+    pPhi phi = &s->phis[s->phiNum];
+    phi->def = NO_OPERAND;
+    phi->var = var;
+    phi->block = b;
+    phi->args = s->argNum;
+    phi->next = s->phiHead[b];
+    s->phiHead[b] = s->phiNum++;
+    for (int k = 0; k < predNum; k++) s->phiArgs[s->argNum++] = NO_OPERAND;
+}
+
+// 给跨块活跃的值放φ
+static void placePhis(pCfg cfg) {
+    OperandId* slots[3];
+    int globalNum = 0;
+    int* globalVar = (int*)malloc(sizeof(int) * (valueNum + 1));
+    int* ueSeen = (int*)calloc(valueNum + 1, sizeof(int));
+    // 先读后写的(值, 块)对，算活跃范围的起点
+    int ueNum = 0, ueCap = 256;
+    int* ueVar = (int*)malloc(sizeof(int) * ueCap);
+    int* ueBlock = (int*)malloc(sizeof(int) * ueCap);
+    assert(globalVar && ueSeen && ueVar && ueBlock);
+    forEachRpo(cfg, b) {
+        blockStamp++;
+        forEachCode(cfg, b, code) {
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int v = renameIndex(*slots[j]);
+                if (v < 0 || valDefSeen[v] == blockStamp || ueSeen[v] == blockStamp)
+                    continue;
+                ueSeen[v] = blockStamp;
+                if (ueNum == ueCap) {
+                    ueCap *= 2;
+                    ueVar = (int*)realloc(ueVar, sizeof(int) * ueCap);
+                    ueBlock = (int*)realloc(ueBlock, sizeof(int) * ueCap);
+                    assert(ueVar != NULL && ueBlock != NULL);
+                }
+                ueVar[ueNum] = v;
+                ueBlock[ueNum++] = b;
+                if (valGlobal[v] >= 0) continue;
+                globalVar[globalNum] = v;
+                valGlobal[v] = globalNum++;
+            }
+            OperandId def = getDef(code);
+            int v = def ? renameIndex(def) : -1;
+            if (v >= 0) valDefSeen[v] = blockStamp;
+        }
+    }
+    free(ueSeen);
+    if (globalNum == 0) {
+        free(globalVar);
+        free(ueVar);
+        free(ueBlock);
+        return;
+    }
+
+    // 每个全局值的定值块，同一块只记一次；第一遍数个数，第二遍填
+    int* defStart = (int*)calloc(globalNum + 1, sizeof(int));
+    assert(defStart != NULL);
+    int* defBlocks = NULL;
+    int* fill = NULL;
+    for (int pass = 0; pass < 2; pass++) {
+        forEachRpo(cfg, b) {
+            blockStamp++;
+            forEachCode(cfg, b, code) {
+                OperandId def = getDef(code);
+                int v = def ? renameIndex(def) : -1;
+                if (v < 0 || valGlobal[v] < 0 || valDefSeen[v] == blockStamp)
+                    continue;
+                valDefSeen[v] = blockStamp;
+                if (pass == 0)
+                    defStart[valGlobal[v] + 1]++;
+                else
+                    defBlocks[fill[valGlobal[v]]++] = b;
+            }
+        }
+        if (pass == 0) {
+            for (int g = 0; g < globalNum; g++) defStart[g + 1] += defStart[g];
+            defBlocks = (int*)malloc(sizeof(int) * (defStart[globalNum] + 1));
+            fill = (int*)malloc(sizeof(int) * (globalNum + 1));
+            assert(defBlocks != NULL && fill != NULL);
+            memcpy(fill, defStart, sizeof(int) * globalNum);
+        }
+    }
+    free(fill);
+
+    // 先读后写的块按值排好
+    int* ueStart = (int*)calloc(globalNum + 1, sizeof(int));
+    int* ueBlocks = (int*)malloc(sizeof(int) * (ueNum + 1));
+    assert(ueStart != NULL && ueBlocks != NULL);
+    for (int k = 0; k < ueNum; k++) ueStart[valGlobal[ueVar[k]]]++;
+    for (int g = 1; g <= globalNum; g++) ueStart[g] += ueStart[g - 1];
+    for (int k = ueNum - 1; k >= 0; k--)
+        ueBlocks[--ueStart[valGlobal[ueVar[k]]]] = ueBlock[k];
+    free(ueVar);
+    free(ueBlock);
+
+    BlockLists df = dominanceFrontiers(cfg);
+    int n = cfg->blockNum;
+    int* hasPhi = (int*)calloc(n, sizeof(int));
+    int* inWork = (int*)calloc(n, sizeof(int));
+    int* liveIn = (int*)calloc(n, sizeof(int));
+    int* defHere = (int*)calloc(n, sizeof(int));
+    int* work = (int*)malloc(sizeof(int) * (n + 1));
+    assert(hasPhi && inWork && liveIn && defHere && work);
+    for (int g = 0; g < globalNum; g++) {
+        // g在哪些块的入口活跃：从先读后写的块沿前驱往回走，到定值块为止
+        int top = 0;
+        for (int d = defStart[g]; d < defStart[g + 1]; d++)
+            defHere[defBlocks[d]] = g + 1;
+        for (int u = ueStart[g]; u < ueStart[g + 1]; u++) {
+            liveIn[ueBlocks[u]] = g + 1;
+            work[top++] = ueBlocks[u];
+        }
+        while (top) {
+            int x = work[--top];
+            forEachPred(cfg, x, p) {
+                if (cfg->blocks[p].rpo < 0 || liveIn[p] == g + 1 ||
+                    defHere[p] == g + 1)
+                    continue;
+                liveIn[p] = g + 1;
+                work[top++] = p;
+            }
+        }
+
+        work[top++] = 0;
+        inWork[0] = g + 1;
+        for (int d = defStart[g]; d < defStart[g + 1]; d++) {
+            int b = defBlocks[d];
+            if (inWork[b] == g + 1) continue;
+            inWork[b] = g + 1;
+            work[top++] = b;
+        }
+        while (top) {
+            int x = work[--top];
+            for (int d = df.start[x]; d < df.start[x + 1]; d++) {
+                int y = df.items[d];
+                if (hasPhi[y] == g + 1 || liveIn[y] != g + 1) continue;
+                hasPhi[y] = g + 1;
+                addPhi(y, globalVar[g]);
+                if (inWork[y] != g + 1) {
+                    inWork[y] = g + 1;
+                    work[top++] = y;
+                }
+            }
+        }
+    }
+
+    free(globalVar);
+    free(defStart);
+    free(defBlocks);
+    free(df.start);
+    free(df.items);
+    free(ueStart);
+    free(ueBlocks);
+    free(hasPhi);
+    free(inWork);
+    free(liveIn);
+    free(defHere);
+    free(work);
+}
+
+// 沿支配树先序改名。改过的值和它原来的名字记在日志里，出块时倒着恢复
+static void renameValues(pCfg cfg) {
+    pInterCodeList list = cur->list;
+    int n = cfg->blockNum;
+    BlockLists tree = domChildren(cfg);
+    int* stack = (int*)malloc(sizeof(int) * (n + 1));
+    int* next = (int*)malloc(sizeof(int) * n);
+    int* logMark = (int*)malloc(sizeof(int) * n);
+    int logNum = 0, logCap = 256;
+    int* logVar = (int*)malloc(sizeof(int) * logCap);
+    OperandId* logOld = (OperandId*)malloc(sizeof(OperandId) * logCap);
+    assert(stack && next && logMark && logVar && logOld);
+    OperandId* slots[3];
+
+#define PUSH_NAME(v, name)                                                     \
+    do {                                                                       \
+        if (logNum == logCap) {                                                \
+            logCap *= 2;                                                       \
+            logVar = (int*)realloc(logVar, sizeof(int) * logCap);              \
+            logOld = (OperandId*)realloc(logOld, sizeof(OperandId) * logCap);  \
+            assert(logVar != NULL && logOld != NULL);                          \
+        }                                                                      \
+        logVar[logNum] = v;                                                    \
+        logOld[logNum++] = valCur[v];                                          \
+        valCur[v] = name;                                                      \
+    } while (0)
+
+    int top = 0;
+    stack[top++] = 0;
+    next[0] = -1;
+    while (top) {
+        int b = stack[top - 1];
+        if (next[b] < 0) {
+            // 进入块b
+            next[b] = tree.start[b];
+            logMark[b] = logNum;
+            forEachPhi(cur, b, phi) {
+                int v = cur->phis[phi].var;
+                OperandId name = newName(v, -1, phi);
+                cur->phis[phi].def = name;
+                PUSH_NAME(v, name);
+            }
+            for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+                pInterCode code = &list->codes[i];
+                int useNum = getUseSlots(code, slots);
+                for (int j = 0; j < useNum; j++) {
+                    int v = renameIndex(*slots[j]);
+                    if (v >= 0)
+                        *slots[j] = withAddr(currentName(v),
+                                             getOperand(*slots[j])->isAddr);
+                }
+                OperandId* def = getDefSlot(code);
+                int v = def ? renameIndex(*def) : -1;
+                if (v < 0) continue;
+                boolean isAddr = getOperand(*def)->isAddr;
+                OperandId name = newName(v, i, -1);
+                *def = withAddr(name, isAddr);
+                PUSH_NAME(v, name);
+            }
+            forEachSucc(cfg, b, s) {
+                forEachPred(cfg, s, p) {
+                    if (p != b) continue;
+                    forEachPhi(cur, s, phi)
+                        *phiArg(cur, phi, _i_p) = currentName(cur->phis[phi].var);
+                }
+            }
+        }
+        if (next[b] < tree.start[b + 1]) {
+            int c = tree.items[next[b]++];
+            next[c] = -1;
+            stack[top++] = c;
+            continue;
+        }
+        while (logNum > logMark[b]) {
+            logNum--;
+            valCur[logVar[logNum]] = logOld[logNum];
+        }
+        top--;
+    }
+#undef PUSH_NAME
+
+    free(tree.start);
+    free(tree.items);
+    free(stack);
+    free(next);
+    free(logMark);
+    free(logVar);
+    free(logOld);
+}
+
+static pSsa newSsa(pInterCodeList list, int start) {
+    pSsa s = (pSsa)calloc(1, sizeof(Ssa));
+    assert(s != NULL);
+    cur = s;
+    s->list = list;
+    pCfg cfg = s->cfg = newCfg(list, start);
+    s->base = list->tempVarNum;
+    int n = cfg->blockNum;
+    s->phiHead = (int*)malloc(sizeof(int) * n);
+    s->blockDead = (char*)calloc(n, sizeof(char));
+    s->succDead = (char*)calloc(n * 2, sizeof(char));
+    s->codeDead = (char*)calloc(cfg->funcEnd - cfg->funcStart, sizeof(char));
+    assert(s->phiHead && s->blockDead && s->succDead && s->codeDead);
+    forEachBlock(cfg, b) {
+        s->phiHead[b] = -1;
+        if (cfg->blocks[b].rpo < 0) s->blockDead[b] = 1;
+    }
+
+    funcId++;
+    for (int i = cfg->funcStart; i < cfg->funcEnd; i++) {
+        pInterCode code = &list->codes[i];
+        OperandId mem = code->kind == IR_DEC        ? code->u.dec.op
+                        : code->kind == IR_GET_ADDR ? code->u.assign.right
+                                                    : NO_OPERAND;
+        int v = mem ? valueIndex(mem) : -1;
+        if (v < 0) continue;
+        touchValue(v);
+        valMem[v] = 1;
+    }
+    placePhis(cfg);
+    renameValues(cfg);
+    return s;
+}
+
+static void deleteSsa(pSsa s) {
+    deleteCfg(s->cfg);
+    free(s->nameOp);
+    free(s->nameVar);
+    free(s->defCode);
+    free(s->defPhi);
+    free(s->phis);
+    free(s->phiArgs);
+    free(s->phiHead);
+    free(s->blockDead);
+    free(s->succDead);
+    free(s->codeDead);
+    free(s);
+}
+
+// ---- 回到普通代码 ----
+
+static char* phiLive;
+static int* candOf;      // SSA名字 -> 参与合并的名字的编号，-1表示不参与
+static int* candName;
+static int candNum;
+static int* parent;      // 并查集
+static int* member;      // 等价类里的名字串成环
+static int** adj;
+static int* adjNum;
+static int* adjCap;
+static OperandId* nameOut;  // SSA名字 -> 回到普通代码后的操作数
+static int* blockOf;        // 指令下标（相对funcStart） -> 块
+
+static int find(int n) {
+    while (parent[n] != n) {
+        parent[n] = parent[parent[n]];
+        n = parent[n];
+    }
+    return n;
+}
+
+static void markPhi(int phi, int* work, int* top) {
+    if (phiLive[phi]) return;
+    phiLive[phi] = 1;
+    work[(*top)++] = phi;
+}
+
+// 从指令里的使用出发，标出有用的φ
+static void findLivePhis(pCfg cfg) {
+    OperandId* slots[3];
+    phiLive = (char*)calloc(cur->phiNum + 1, sizeof(char));
+    int* work = (int*)malloc(sizeof(int) * (cur->phiNum + 1));
+    assert(phiLive && work);
+    int top = 0;
+    forEachBlock(cfg, b) {
+        if (cur->blockDead[b]) continue;
+        for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+            if (codeDead(cur, i)) continue;
+            int useNum = getUseSlots(&cur->list->codes[i], slots);
+            for (int j = 0; j < useNum; j++) {
+                int idx = ssaIndex(cur, *slots[j]);
+                if (idx >= 0 && cur->defPhi[idx] >= 0)
+                    markPhi(cur->defPhi[idx], work, &top);
+            }
+        }
+    }
+    while (top) {
+        int phi = work[--top];
+        int b = cur->phis[phi].block;
+        for (int k = 0; k < cfg->blocks[b].predNum; k++) {
+            if (!predAlive(cur, b, k)) continue;
+            int idx = ssaIndex(cur, *phiArg(cur, phi, k));
+            if (idx >= 0 && cur->defPhi[idx] >= 0)
+                markPhi(cur->defPhi[idx], work, &top);
+        }
+    }
+    free(work);
+}
+
+// 删掉定值没人读的纯计算。SCCP把常量代进φ参数、GVN换掉冗余的值以后，
+// 原来的定值常常就没人读了，留着的话还要给它们分名字，回去再删一遍
+static int removeDeadCodes(pCfg cfg) {
+    pSsa s = cur;
+    OperandId* slots[3];
+    int* uses = (int*)calloc(s->nameNum + 1, sizeof(int));
+    int* work = (int*)malloc(sizeof(int) * (s->nameNum + 1));
+    assert(uses && work);
+    forEachBlock(cfg, b) {
+        if (s->blockDead[b]) continue;
+        for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+            if (codeDead(s, i)) continue;
+            int useNum = getUseSlots(&s->list->codes[i], slots);
+            for (int j = 0; j < useNum; j++) {
+                int idx = ssaIndex(s, *slots[j]);
+                if (idx >= 0) uses[idx]++;
+            }
+        }
+    }
+    for (int phi = 0; phi < s->phiNum; phi++) {
+        int b = s->phis[phi].block;
+        if (!phiLive[phi] || s->blockDead[b]) continue;
+        for (int k = 0; k < cfg->blocks[b].predNum; k++) {
+            int idx = predAlive(s, b, k) ? ssaIndex(s, *phiArg(s, phi, k)) : -1;
+            if (idx >= 0) uses[idx]++;
+        }
+    }
+    int top = 0, removed = 0;
+    for (int idx = 0; idx < s->nameNum; idx++)
+        if (uses[idx] == 0 && s->defCode[idx] >= 0) work[top++] = idx;
+    while (top) {
+        int i = s->defCode[work[--top]];
+        pInterCode code = &s->list->codes[i];
+        if (codeDead(s, i) || s->blockDead[blockOf[i - cfg->funcStart]] ||
+            !isPure(code))
+            continue;
+        s->codeDead[i - cfg->funcStart] = 1;
+        removed++;
+        int useNum = getUseSlots(code, slots);
+        for (int j = 0; j < useNum; j++) {
+            int idx = ssaIndex(s, *slots[j]);
+            if (idx >= 0 && --uses[idx] == 0 && s->defCode[idx] >= 0)
+                work[top++] = idx;
+        }
+    }
+    free(uses);
+    free(work);
+    return removed;
+}
+
+static int addCandidate(int idx) {
+    if (candOf[idx] < 0) {
+        candOf[idx] = candNum;
+        candName[candNum++] = idx;
+    }
+    return candOf[idx];
+}
+
+static int candOfOperand(OperandId id) {
+    int idx = ssaIndex(cur, id);
+    return idx >= 0 ? candOf[idx] : -1;
+}
+
+static void addAdj(int a, int b) {
+    if (adjNum[a] == adjCap[a]) {
+        adjCap[a] = adjCap[a] ? adjCap[a] * 2 : 4;
+        adj[a] = (int*)realloc(adj[a], sizeof(int) * adjCap[a]);
+        assert(adj[a] != NULL);
+    }
+    adj[a][adjNum[a]++] = b;
+}
+
+static void interfere(int a, int b) {
+    if (a == b) return;
+    addAdj(a, b);
+    addAdj(b, a);
+}
+
+// 候选名字的活跃范围：从每个使用沿活着的边往回走，走到定值的块为止。
+// 结果按块存成出口处活跃的候选名字的列表，大小和活跃范围成正比，
+// 大函数里不用开块数乘候选数的位向量
+static int* outStart;
+static int* outItems;
+
+static int defBlockOf(int idx) {
+    if (cur->defPhi[idx] >= 0) return cur->phis[cur->defPhi[idx]].block;
+    if (cur->defCode[idx] >= 0)
+        return blockOf[cur->defCode[idx] - cur->cfg->funcStart];
+    return -1;
+}
+
+static void computeLiveOut(pCfg cfg) {
+    OperandId* slots[3];
+    pInterCodeList list = cur->list;
+    int n = cfg->blockNum;
+    // 每个候选名字开始活跃的地方：指令里的使用记块号，φ参数记作-1-前驱
+    int* useStart = (int*)calloc(candNum + 1, sizeof(int));
+    int* useItems = NULL;
+    int* fill = NULL;
+    assert(useStart != NULL);
+    for (int pass = 0; pass < 2; pass++) {
+#define ADD_USE(c, item)                   \
+    do {                                   \
+        if ((c) < 0) break;                \
+        if (pass == 0)                     \
+            useStart[(c) + 1]++;           \
+        else                               \
+            useItems[fill[c]++] = item;    \
+    } while (0)
+        forEachBlock(cfg, b) {
+            if (cur->blockDead[b]) continue;
+            for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+                if (codeDead(cur, i)) continue;
+                int useNum = getUseSlots(&list->codes[i], slots);
+                for (int j = 0; j < useNum; j++) ADD_USE(candOfOperand(*slots[j]), b);
+            }
+            forEachPred(cfg, b, p) {
+                if (!predAlive(cur, b, _i_p)) continue;
+                forEachPhi(cur, b, phi) {
+                    if (phiLive[phi])
+                        ADD_USE(candOfOperand(*phiArg(cur, phi, _i_p)), -1 - p);
+                }
+            }
+        }
+#undef ADD_USE
+        if (pass == 0) {
+            for (int c = 0; c < candNum; c++) useStart[c + 1] += useStart[c];
+            useItems = (int*)malloc(sizeof(int) * (useStart[candNum] + 1));
+            fill = (int*)malloc(sizeof(int) * (candNum + 1));
+            assert(useItems != NULL && fill != NULL);
+            memcpy(fill, useStart, sizeof(int) * candNum);
+        }
+    }
+
+    int* inStamp = (int*)malloc(sizeof(int) * n);
+    int* outStamp = (int*)malloc(sizeof(int) * n);
+    int* work = (int*)malloc(sizeof(int) * (n + 1));
+    int pairNum = 0, pairCap = 256;
+    int* pairBlock = (int*)malloc(sizeof(int) * pairCap);
+    int* pairCand = (int*)malloc(sizeof(int) * pairCap);
+    assert(inStamp && outStamp && work && pairBlock && pairCand);
+    for (int b = 0; b < n; b++) inStamp[b] = outStamp[b] = -1;
+
+#define MARK_OUT(p)                                                         \
+    do {                                                                    \
+        if (outStamp[p] == c) break;                                        \
+        outStamp[p] = c;                                                    \
+        if (pairNum == pairCap) {                                           \
+            pairCap *= 2;                                                   \
+            pairBlock = (int*)realloc(pairBlock, sizeof(int) * pairCap);    \
+            pairCand = (int*)realloc(pairCand, sizeof(int) * pairCap);      \
+            assert(pairBlock != NULL && pairCand != NULL);                  \
+        }                                                                   \
+        pairBlock[pairNum] = p;                                             \
+        pairCand[pairNum++] = c;                                            \
+    } while (0)
+#define MARK_IN(b)                                                          \
+    do {                                                                    \
+        if ((b) == def || inStamp[b] == c) break;                           \
+        inStamp[b] = c;                                                     \
+        work[top++] = b;                                                    \
+    } while (0)
+    for (int c = 0; c < candNum; c++) {
+        int def = defBlockOf(candName[c]), top = 0;
+        for (int u = useStart[c]; u < useStart[c + 1]; u++) {
+            int item = useItems[u];
+            if (item >= 0) {
+                MARK_IN(item);
+            } else {
+                MARK_OUT(-1 - item);
+                MARK_IN(-1 - item);
+            }
+        }
+        while (top) {
+            int b = work[--top];
+            forEachPred(cfg, b, p) {
+                if (!predAlive(cur, b, _i_p)) continue;
+                MARK_OUT(p);
+                MARK_IN(p);
+            }
+        }
+    }
+#undef MARK_OUT
+#undef MARK_IN
+
+    outStart = (int*)calloc(n + 1, sizeof(int));
+    outItems = (int*)malloc(sizeof(int) * (pairNum + 1));
+    assert(outStart != NULL && outItems != NULL);
+    for (int k = 0; k < pairNum; k++) outStart[pairBlock[k] + 1]++;
+    for (int b = 0; b < n; b++) outStart[b + 1] += outStart[b];
+    memcpy(work, outStart, sizeof(int) * n);
+    for (int k = 0; k < pairNum; k++) outItems[work[pairBlock[k]]++] = pairCand[k];
+
+    free(useStart);
+    free(useItems);
+    free(fill);
+    free(inStamp);
+    free(outStamp);
+    free(work);
+    free(pairBlock);
+    free(pairCand);
+}
+
+// 活跃的候选名字用稀疏集合存，加、删、遍历都和集合大小成正比
+static int* liveDense;
+static int* livePos;
+static int liveNum;
+
+static boolean isLive(int c) {
+    return livePos[c] < liveNum && liveDense[livePos[c]] == c;
+}
+
+static void addLive(int c) {
+    if (isLive(c)) return;
+    livePos[c] = liveNum;
+    liveDense[liveNum++] = c;
+}
+
+static void removeLive(int c) {
+    if (!isLive(c)) return;
+    int last = liveDense[--liveNum];
+    liveDense[livePos[c]] = last;
+    livePos[last] = livePos[c];
+}
+
+// 倒着扫每块建冲突图
+static void buildInterference(pCfg cfg) {
+    OperandId* slots[3];
+    pInterCodeList list = cur->list;
+    liveDense = (int*)malloc(sizeof(int) * (candNum + 1));
+    livePos = (int*)calloc(candNum + 1, sizeof(int));
+    assert(liveDense && livePos);
+    computeLiveOut(cfg);
+
+    forEachBlock(cfg, b) {
+        if (cur->blockDead[b]) continue;
+        liveNum = 0;
+        for (int k = outStart[b]; k < outStart[b + 1]; k++) addLive(outItems[k]);
+        for (int i = cfg->blocks[b].last - 1; i >= cfg->blocks[b].first; i--) {
+            if (codeDead(cur, i)) continue;
+            pInterCode code = &list->codes[i];
+            OperandId def = getDef(code);
+            int d = def ? candOfOperand(def) : -1;
+            if (d >= 0) {
+                int src = code->kind == IR_ASSIGN
+                              ? candOfOperand(code->u.assign.right)
+                              : -1;
+                for (int k = 0; k < liveNum; k++)
+                    if (liveDense[k] != src) interfere(d, liveDense[k]);
+                removeLive(d);
+            }
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int c = candOfOperand(*slots[j]);
+                if (c >= 0) addLive(c);
+            }
+        }
+        // φ在块入口同时定值，和入口处活跃的冲突。在这里已经不活跃的φ
+        // 也要和同块的其他φ分开，否则边上的复写会写同一个名字两次
+        forEachPhi(cur, b, phi) {
+            int d = phiLive[phi] ? candOfOperand(cur->phis[phi].def) : -1;
+            if (d < 0) continue;
+            for (int k = 0; k < liveNum; k++) interfere(d, liveDense[k]);
+            if (isLive(d)) continue;
+            forEachPhi(cur, b, other) {
+                int e = phiLive[other] ? candOfOperand(cur->phis[other].def) : -1;
+                if (e >= 0 && other != phi) interfere(d, e);
+            }
+        }
+    }
+
+    free(liveDense);
+    free(livePos);
+    free(outStart);
+    free(outItems);
+}
+
+static int* classSize;
+
+static boolean classesInterfere(int a, int b) {
+    if (classSize[a] > classSize[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    int m = a;
+    do {
+        for (int e = 0; e < adjNum[m]; e++)
+            if (find(adj[m][e]) == b) return TRUE;
+        m = member[m];
+    } while (m != a);
+    return FALSE;
+}
+
+static void unite(int a, int b) {
+    if (classSize[a] < classSize[b]) {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    parent[b] = a;
+    classSize[a] += classSize[b];
+    int t = member[a];
+    member[a] = member[b];
+    member[b] = t;
+}
+
+// φ的定值和参数能合并的都合并，返回合并的次数。内层循环的先合并，
+// 按循环深度分桶，同一深度里保持原来的顺序
+static int coalescePhis(pCfg cfg) {
+    int maxDepth = 0;
+    for (int l = 0; l < cfg->loopNum; l++)
+        if (cfg->loops[l].depth > maxDepth) maxDepth = cfg->loops[l].depth;
+    int* order = (int*)malloc(sizeof(int) * (cur->phiNum + 1));
+    int* start = (int*)calloc(maxDepth + 2, sizeof(int));
+    assert(order != NULL && start != NULL);
+    int liveNum = 0;
+    for (int phi = 0; phi < cur->phiNum; phi++)
+        if (phiLive[phi] && !cur->blockDead[cur->phis[phi].block]) {
+            start[maxDepth - loopDepth(cfg, cur->phis[phi].block) + 1]++;
+            liveNum++;
+        }
+    for (int d = 1; d <= maxDepth + 1; d++) start[d] += start[d - 1];
+    for (int phi = 0; phi < cur->phiNum; phi++)
+        if (phiLive[phi] && !cur->blockDead[cur->phis[phi].block])
+            order[start[maxDepth - loopDepth(cfg, cur->phis[phi].block)]++] = phi;
+    free(start);
+
+    int merged = 0;
+    for (int i = 0; i < liveNum; i++) {
+        int phi = order[i];
+        int x = candOfOperand(cur->phis[phi].def);
+        int b = cur->phis[phi].block;
+        for (int k = 0; k < cfg->blocks[b].predNum; k++) {
+            if (!predAlive(cur, b, k)) continue;
+            int a = candOfOperand(*phiArg(cur, phi, k));
+            if (a < 0) continue;
+            int rx = find(x), ra = find(a);
+            if (rx == ra || classesInterfere(rx, ra)) continue;
+            unite(rx, ra);
+            merged++;
+        }
+    }
+    free(order);
+    return merged;
+}
+
+// 同一个值的等价类互不冲突的也合并，回到普通代码后尽量还用原来的名字
+static void coalesceValues() {
+    for (int c = 0; c < candNum; c++) {
+        int v = cur->nameVar[candName[c]], r = find(c);
+        if (valClass[v] < 0) {
+            valClass[v] = r;
+            continue;
+        }
+        int root = find(valClass[v]);
+        if (root != r && !classesInterfere(root, r)) unite(root, r);
+    }
+}
+
+// 原来的值v的不带isAddr的操作数，已经分出去了就返回NO_OPERAND
+static OperandId claimName(int v) {
+    if (valClaimed[v] || valOrig[v] == NO_OPERAND) return NO_OPERAND;
+    valClaimed[v] = 1;
+    Operand op = *getOperand(valOrig[v]);
+    if (!op.isAddr) return valOrig[v];
+    return op.kind == OP_VARIABLE ? newOperand(OP_VARIABLE, op.u.name)
+                                  : newOperand(OP_TEMP, op.u.no);
+}
+
+// 给每个SSA名字定下回到普通代码后的操作数
+static void assignNames(pCfg cfg) {
+    int nameNum = cur->nameNum;
+    OperandId* classOut = (OperandId*)calloc(candNum + 1, sizeof(OperandId));
+    assert(classOut != NULL);
+    for (int idx = 0; idx < nameNum; idx++) nameOut[idx] = NO_OPERAND;
+
+    // 形参的名字不变
+    for (int i = cfg->blocks[0].first; i < cfg->blocks[0].last; i++) {
+        pInterCode code = &cur->list->codes[i];
+        if (code->kind != IR_PARAM) continue;
+        int idx = ssaIndex(cur, code->u.oneOp.op);
+        if (idx < 0) continue;
+        OperandId name = claimName(cur->nameVar[idx]);
+        if (candOf[idx] >= 0)
+            classOut[find(candOf[idx])] = name;
+        else
+            nameOut[idx] = name;
+    }
+    for (int c = 0; c < candNum; c++) {
+        int root = find(c);
+        if (classOut[root]) continue;
+        int m = root;
+        do {
+            classOut[root] = claimName(cur->nameVar[candName[m]]);
+            m = member[m];
+        } while (!classOut[root] && m != root);
+        if (!classOut[root]) classOut[root] = cur->nameOp[candName[root]];
+    }
+    for (int idx = 0; idx < nameNum; idx++) {
+        if (candOf[idx] >= 0)
+            nameOut[idx] = classOut[find(candOf[idx])];
+        else if (nameOut[idx] == NO_OPERAND) {
+            nameOut[idx] = claimName(cur->nameVar[idx]);
+            if (nameOut[idx] == NO_OPERAND) nameOut[idx] = cur->nameOp[idx];
+        }
+    }
+    free(classOut);
+}
+
+static pInterCode outCodes;
+static int outNum, outCap;
+static int copyTotal;
+
+static pInterCode emitCode(int kind) {
+    if (outNum == outCap) {
+        outCap = outCap ? outCap * 2 : 256;
+        outCodes = (pInterCode)realloc(outCodes, sizeof(InterCode) * outCap);
+        assert(outCodes != NULL);
+    }
+    pInterCode p = &outCodes[outNum++];
+    memset(p, 0, sizeof(InterCode));
+    p->kind = kind;
+    return p;
+}
+
+static OperandId mapOperand(OperandId id) {
+    int idx = ssaIndex(cur, id);
+    if (idx < 0) return id;
+    return withAddr(nameOut[idx], getOperand(id)->isAddr);
+}
+
+// 块p到它的后继s的边上要做的并行复写，按依赖排好输出
+static int edgeCopies(pCfg cfg, int p, int s, boolean emit) {
+    int num = 0, cap = 0;
+    OperandId *dst = NULL, *src = NULL;
+    forEachPred(cfg, s, q) {
+        if (q != p || !predAlive(cur, s, _i_q)) continue;
+        forEachPhi(cur, s, phi) {
+            if (!phiLive[phi]) continue;
+            OperandId d = nameOut[ssaIndex(cur, cur->phis[phi].def)];
+            OperandId a = *phiArg(cur, phi, _i_q);
+            int idx = ssaIndex(cur, a);
+            if (idx >= 0) a = nameOut[idx];
+            if (a == d) continue;
+            if (num == cap) {
+                cap = cap ? cap * 2 : 8;
+                dst = (OperandId*)realloc(dst, sizeof(OperandId) * cap);
+                src = (OperandId*)realloc(src, sizeof(OperandId) * cap);
+                assert(dst != NULL && src != NULL);
+            }
+            dst[num] = d;
+            src[num++] = a;
+        }
+        break;
+    }
+    int result = num;
+    while (emit && num > 0) {
+        int ready = -1;
+        for (int i = 0; i < num && ready < 0; i++) {
+            ready = i;
+            for (int j = 0; j < num; j++)
+                if (j != i && src[j] == dst[i]) ready = -1;
+        }
+        if (ready < 0) {
+            // 剩下的都在环上，先把一个目标存到临时变量里
+            OperandId t = newTemp();
+            toAssign(emitCode(IR_ASSIGN), t, dst[0]);
+            for (int j = 0; j < num; j++)
+                if (src[j] == dst[0]) src[j] = t;
+            copyTotal++;
+            continue;
+        }
+        toAssign(emitCode(IR_ASSIGN), dst[ready], src[ready]);
+        copyTotal++;
+        num--;
+        dst[ready] = dst[num];
+        src[ready] = src[num];
+    }
+    free(dst);
+    free(src);
+    return result;
+}
+
+// 块b的后继里唯一一个活着的，没有就返回-1
+static int liveSucc(pCfg cfg, int b) {
+    int only = -1;
+    forEachSucc(cfg, b, s)
+        if (!cur->succDead[b * 2 + _i_s] && !cur->blockDead[s]) only = s;
+    return only;
+}
+
+static void emitFunction(pCfg cfg) {
+    pInterCodeList list = cur->list;
+    int n = cfg->blockNum;
+    // IF跳转的那条边上要复写的，开一块放在目标块前面
+    OperandId* splitLabel = (OperandId*)calloc(n, sizeof(OperandId));
+    int* splitHead = (int*)malloc(sizeof(int) * n);
+    int* splitNext = (int*)malloc(sizeof(int) * n);
+    assert(splitLabel && splitHead && splitNext);
+    for (int b = n - 1; b >= 0; b--) splitHead[b] = -1;
+    for (int b = n - 1; b >= 0; b--) {
+        pBlock block = &cfg->blocks[b];
+        if (cur->blockDead[b] || block->succNum != 2) continue;
+        pInterCode last = &list->codes[block->last - 1];
+        if (last->kind != IR_IF_GOTO || codeDead(cur, block->last - 1)) continue;
+        int s = block->succ[0];
+        if (edgeCopies(cfg, b, s, FALSE) == 0) continue;
+        splitLabel[b] = newLabel();
+        splitNext[b] = splitHead[s];
+        splitHead[s] = b;
+    }
+
+    forEachBlock(cfg, b) {
+        pBlock block = &cfg->blocks[b];
+        if (cur->blockDead[b]) {
+            // 标签可能还被跳转引用，留给窥孔优化
+            if (list->codes[block->first].kind == IR_LABEL)
+                *emitCode(IR_LABEL) = list->codes[block->first];
+            continue;
+        }
+        if (splitHead[b] >= 0) {
+            assert(list->codes[block->first].kind == IR_LABEL);
+            OperandId label = list->codes[block->first].u.oneOp.op;
+            int lastKind = outCodes[outNum - 1].kind;
+            if (lastKind != IR_GOTO && lastKind != IR_RETURN)
+                emitCode(IR_GOTO)->u.oneOp.op = label;
+            for (int p = splitHead[b]; p >= 0; p = splitNext[p]) {
+                emitCode(IR_LABEL)->u.oneOp.op = splitLabel[p];
+                edgeCopies(cfg, p, b, TRUE);
+                if (splitNext[p] >= 0) emitCode(IR_GOTO)->u.oneOp.op = label;
+            }
+        }
+        // 整块都删光了就只剩顺序执行到下一块的复写
+        int term = block->last - 1;
+        while (term >= block->first && codeDead(cur, term)) term--;
+        if (term < block->first) {
+            int s = liveSucc(cfg, b);
+            if (s >= 0) edgeCopies(cfg, b, s, TRUE);
+            continue;
+        }
+        OperandId* slots[3];
+        for (int i = block->first; i <= term; i++) {
+            if (codeDead(cur, i)) continue;
+            InterCode code = list->codes[i];
+            int useNum = getUseSlots(&code, slots);
+            for (int j = 0; j < useNum; j++) *slots[j] = mapOperand(*slots[j]);
+            OperandId* def = getDefSlot(&code);
+            if (def) *def = mapOperand(*def);
+            if (i < term) {
+                *emitCode(code.kind) = code;
+                continue;
+            }
+            int s = liveSucc(cfg, b);
+            if (code.kind == IR_GOTO) {
+                if (s >= 0) edgeCopies(cfg, b, s, TRUE);
+                *emitCode(code.kind) = code;
+            } else if (code.kind == IR_IF_GOTO && block->succNum == 2) {
+                if (splitLabel[b]) code.u.ifGoto.z = splitLabel[b];
+                *emitCode(code.kind) = code;
+                edgeCopies(cfg, b, block->succ[1], TRUE);
+            } else if (code.kind == IR_IF_GOTO) {
+                // 跳转目标就是下一块，这条IF没有用
+                if (s >= 0) edgeCopies(cfg, b, s, TRUE);
+            } else {
+                *emitCode(code.kind) = code;
+                if (s >= 0 && code.kind != IR_RETURN) edgeCopies(cfg, b, s, TRUE);
+            }
+        }
+    }
+    free(splitLabel);
+    free(splitHead);
+    free(splitNext);
+}
+
+static int leaveSsa(pSsa s) {
+    pCfg cfg = s->cfg;
+    findLivePhis(cfg);
+    int nameNum = s->nameNum;
+    candOf = (int*)malloc(sizeof(int) * (nameNum + 1));
+    candName = (int*)malloc(sizeof(int) * (nameNum + 1));
+    nameOut = (OperandId*)malloc(sizeof(OperandId) * (nameNum + 1));
+    assert(candOf && candName && nameOut);
+    for (int idx = 0; idx < nameNum; idx++) candOf[idx] = -1;
+    candNum = 0;
+    blockOf = (int*)malloc(sizeof(int) * (cfg->funcEnd - cfg->funcStart + 1));
+    assert(blockOf != NULL);
+    forEachBlock(cfg, b)
+        for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++)
+            blockOf[i - cfg->funcStart] = b;
+    // 删掉的指令读的φ可能也没人用了
+    if (removeDeadCodes(cfg)) {
+        free(phiLive);
+        findLivePhis(cfg);
+    }
+    // 跨块活跃的名字也参与，按原来的值合并，免得回到普通代码后
+    // 跨块的名字成倍增加
+    OperandId* slots[3];
+    forEachBlock(cfg, b) {
+        if (s->blockDead[b]) continue;
+        for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+            if (codeDead(s, i)) continue;
+            int useNum = getUseSlots(&s->list->codes[i], slots);
+            for (int j = 0; j < useNum; j++) {
+                int idx = ssaIndex(s, *slots[j]);
+                if (idx >= 0 && defBlockOf(idx) != b) addCandidate(idx);
+            }
+        }
+    }
+    for (int phi = 0; phi < s->phiNum; phi++) {
+        int b = s->phis[phi].block;
+        if (!phiLive[phi] || s->blockDead[b]) continue;
+        addCandidate(ssaIndex(s, s->phis[phi].def));
+        for (int k = 0; k < cfg->blocks[b].predNum; k++) {
+            int idx = predAlive(s, b, k) ? ssaIndex(s, *phiArg(s, phi, k)) : -1;
+            if (idx >= 0) addCandidate(idx);
+        }
+    }
+    parent = (int*)malloc(sizeof(int) * (candNum + 1));
+    member = (int*)malloc(sizeof(int) * (candNum + 1));
+    classSize = (int*)malloc(sizeof(int) * (candNum + 1));
+    adj = (int**)calloc(candNum + 1, sizeof(int*));
+    adjNum = (int*)calloc(candNum + 1, sizeof(int));
+    adjCap = (int*)calloc(candNum + 1, sizeof(int));
+    assert(parent && member && classSize && adj && adjNum && adjCap);
+    for (int c = 0; c < candNum; c++) {
+        parent[c] = member[c] = c;
+        classSize[c] = 1;
+    }
+
+    buildInterference(cfg);
+    int merged = coalescePhis(cfg);
+    coalesceValues();
+    assignNames(cfg);
+    emitFunction(cfg);
+
+    for (int c = 0; c < candNum; c++) free(adj[c]);
+    free(adj);
+    free(adjNum);
+    free(adjCap);
+    free(parent);
+    free(member);
+    free(classSize);
+    free(candOf);
+    free(candName);
+    free(nameOut);
+    free(blockOf);
+    free(phiLive);
+    return merged;
+}
+
+int runSsaPasses(pInterCodeList list, boolean numbering) {
+    int n = valueNum + 1;
+    valStamp = (int*)calloc(n, sizeof(int));
+    valMem = (char*)malloc(n);
+    valGlobal = (int*)malloc(sizeof(int) * n);
+    valDefSeen = (int*)malloc(sizeof(int) * n);
+    valCur = (OperandId*)malloc(sizeof(OperandId) * n);
+    valEntry = (OperandId*)malloc(sizeof(OperandId) * n);
+    valClaimed = (char*)malloc(n);
+    valOrig = (OperandId*)malloc(sizeof(OperandId) * n);
+    valClass = (int*)malloc(sizeof(int) * n);
+    assert(valStamp && valMem && valGlobal && valDefSeen && valCur && valEntry &&
+           valClaimed && valOrig && valClass);
+    funcId = blockStamp = 0;
+    outCodes = NULL;
+    outNum = outCap = copyTotal = 0;
+
+    int constants = 0, numbered = 0, phis = 0, merged = 0;
+    for (int i = 0; i < list->codeNum && list->codes[i].kind != IR_FUNCTION; i++)
+        *emitCode(list->codes[i].kind) = list->codes[i];
+    for (int i = 0; i < list->codeNum; i = nextFunction(list, i)) {
+        if (list->codes[i].kind != IR_FUNCTION) continue;
+        pSsa s = newSsa(list, i);
+        phis += s->phiNum;
+        constants += propagateConstantsSsa(s);
+        if (numbering) numbered += numberValuesSsa(s);
+        merged += leaveSsa(s);
+        deleteSsa(s);
+    }
+    free(list->codes);
+    list->codes = outCodes;
+    list->codeNum = outNum;
+    list->codeCap = outCap;
+    outCodes = NULL;
+
+    free(valStamp);
+    free(valMem);
+    free(valGlobal);
+    free(valDefSeen);
+    free(valCur);
+    free(valEntry);
+    free(valClaimed);
+    free(valOrig);
+    free(valClass);
+    if (optStats)
+        fprintf(stderr,
+                "ssa: %d phis, sccp %d changes, gvn %d values, "
+                "%d copies coalesced, %d copies inserted\n",
+                phis, constants, numbered, merged, copyTotal);
+    return constants + numbered;
+}
@@ -0,0 +1,72 @@
+#ifndef SSA_H
+#define SSA_H
+#include "cfg.h"
+
+// 函数的SSA形式。指令还在原来的数组里，只是换了名字：没被取址的变量和
+// 临时变量（能改名的值）每定值一次换成一个新的临时变量，叫SSA名字，
+// 编号从base开始连续分配。φ不放进指令数组，挂在所在块上，参数和块的
+// 前驱一一对应。入口处没赋过值就读的值也有一个SSA名字，它没有定值，
+// 和解释器、后端一样当作0。
+// 各遍只删指令、改跳转，不插指令；不可达的块和边记在blockDead/succDead里，
+// 回到普通的中间代码时再统一处理
+typedef struct _phi* pPhi;
+typedef struct _ssa* pSsa;
+
+typedef struct _phi {
+    OperandId def;
+    int var;        // 原来的值的valueIndex
+    int block;
+    int args;       // 参数在ssa->phiArgs里的起点，个数是块的前驱数
+    int next;       // 同一块的下一个φ，-1结束
+} Phi;
+
+typedef struct _ssa {
+    pInterCodeList list;
+    pCfg cfg;
+    int base;            // 第一个SSA名字的临时变量编号
+    int nameNum, nameCap;
+    OperandId* nameOp;   // SSA名字 -> 不带isAddr的操作数
+    int* nameVar;        // SSA名字 -> 原来的值
+    int* defCode;        // SSA名字 -> 定值的指令下标，不是指令定值的为-1
+    int* defPhi;         // SSA名字 -> 定值的φ，不是φ定值的为-1
+    pPhi phis;
+    int phiNum, phiCap;
+    OperandId* phiArgs;  // 不可达的前驱对应的参数是NO_OPERAND
+    int argNum, argCap;
+    int* phiHead;        // 块 -> 第一个φ，-1表示没有
+    char* blockDead;     // 执行不到的块
+    char* succDead;      // 块b的第k条出边执行不到：succDead[b * 2 + k]
+    char* codeDead;      // 删掉的指令，下标相对funcStart
+} Ssa;
+
+// 操作数是SSA名字时返回它的下标，否则返回-1
+static inline int ssaIndex(pSsa ssa, OperandId id) {
+    if (id == NO_OPERAND) return -1;
+    pOperand op = getOperand(id);
+    if (op->kind != OP_TEMP || op->u.no < ssa->base) return -1;
+    return op->u.no - ssa->base;
+}
+
+static inline OperandId* phiArg(pSsa ssa, int phi, int k) {
+    return &ssa->phiArgs[ssa->phis[phi].args + k];
+}
+
+static inline boolean codeDead(pSsa ssa, int i) {
+    return ssa->codeDead[i - ssa->cfg->funcStart];
+}
+
+// 块b到它的第k个前驱的边还活着
+boolean predAlive(pSsa ssa, int b, int k);
+
+// 把use槽位换成value，保留原操作数的isAddr；地址不能换成立即数，
+// 换不了时返回FALSE
+boolean replaceUse(pSsa ssa, pInterCode code, OperandId* slot, OperandId value);
+
+#define forEachPhi(ssa, b, phi) \
+    for (int phi = (ssa)->phiHead[b]; phi >= 0; phi = (ssa)->phis[phi].next)
+
+// ssaopt.c，返回改动的处数
+int propagateConstantsSsa(pSsa ssa);  // 稀疏条件常量传播
+int numberValuesSsa(pSsa ssa);        // 基于支配树的全局值编号
+
+#endif
@@ -0,0 +1,520 @@
+#include "optimize.h"
+#include "ssa.h"
+
+// SSA上的优化。两遍都只改指令和φ的参数、标记删掉的指令和走不到的块，
+// 不插新指令，回到普通代码时一起处理
+
+static pSsa cur;
+
+// 块b的第k个前驱到b的那条边，编号是前驱 * 2 + 出边下标
+static int predEdge(pCfg cfg, int b, int k) {
+    int p = cfg->blocks[b].pred[k];
+    forEachSucc(cfg, p, s)
+        if (s == b) return p * 2 + _i_s;
+    assert(0);
+    return -1;
+}
+
+// ---- 稀疏条件常量传播（Wegman-Zadeck） ----
+// 每个SSA名字的格值：TOP（还没算到）、CONST、BOTTOM（不是常量）。
+// 只沿走得到的边传播，走不到的分支里的定值不会污染φ。
+// 入口处的值和解释器、后端一样是0
+
+enum { LAT_TOP, LAT_CONST, LAT_BOTTOM };
+
+static char* latKind;
+static int* latVal;
+static char* blockExec;
+static char* edgeExec;     // 块b的第k条出边走得到：edgeExec[b * 2 + k]
+static int* blockOf;       // 指令下标（相对funcStart） -> 块
+static int* useStart;      // SSA名字 -> 用到它的地方，指令记下标，φ记作-1-φ
+static int* useItems;
+static int* flowWork;
+static int flowNum;
+static int* nameWork;
+static int nameWorkNum;
+static char* inNameWork;
+
+static int evalOperand(OperandId id, int* val) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT) {
+        *val = op->u.value;
+        return LAT_CONST;
+    }
+    int idx = op->isAddr ? -1 : ssaIndex(cur, id);
+    if (idx < 0) return LAT_BOTTOM;
+    *val = latVal[idx];
+    return latKind[idx];
+}
+
+static void lowerName(int idx, int kind, int val) {
+    if (kind < latKind[idx]) return;
+    if (kind == latKind[idx]) {
+        if (kind != LAT_CONST || val == latVal[idx]) return;
+        kind = LAT_BOTTOM;
+    }
+    latKind[idx] = kind;
+    latVal[idx] = val;
+    if (!inNameWork[idx]) {
+        inNameWork[idx] = 1;
+        nameWork[nameWorkNum++] = idx;
+    }
+}
+
+static void markEdge(int b, int k) {
+    if (edgeExec[b * 2 + k]) return;
+    edgeExec[b * 2 + k] = 1;
+    flowWork[flowNum++] = b * 2 + k;
+}
+
+static void visitPhi(pCfg cfg, int phi) {
+    int b = cur->phis[phi].block;
+    int kind = LAT_TOP, val = 0;
+    for (int k = 0; k < cfg->blocks[b].predNum && kind != LAT_BOTTOM; k++) {
+        if (!edgeExec[predEdge(cfg, b, k)]) continue;
+        int v, argKind = evalOperand(*phiArg(cur, phi, k), &v);
+        if (argKind == LAT_TOP) continue;
+        if (argKind == LAT_BOTTOM || (kind == LAT_CONST && v != val))
+            kind = LAT_BOTTOM;
+        else {
+            kind = LAT_CONST;
+            val = v;
+        }
+    }
+    lowerName(ssaIndex(cur, cur->phis[phi].def), kind, val);
+}
+
+// 块尾的跳转决定哪些出边走得到
+static void visitBranch(pCfg cfg, int b) {
+    pBlock block = &cfg->blocks[b];
+    pInterCode code = &cfg->list->codes[block->last - 1];
+    if (code->kind == IR_RETURN) return;
+    if (code->kind == IR_IF_GOTO && block->succNum == 2) {
+        int a, c;
+        int x = evalOperand(code->u.ifGoto.x, &a);
+        int y = evalOperand(code->u.ifGoto.y, &c);
+        if (x == LAT_TOP || y == LAT_TOP) return;
+        if (x == LAT_CONST && y == LAT_CONST) {
+            boolean taken = evalRelop(getOperand(code->u.ifGoto.relop)->u.relop, a, c);
+            markEdge(b, taken ? 0 : 1);
+            return;
+        }
+    }
+    for (int k = 0; k < block->succNum; k++) markEdge(b, k);
+}
+
+static void visitCode(pCfg cfg, int i) {
+    pInterCode code = &cfg->list->codes[i];
+    OperandId def = getDef(code);
+    int idx = def && !getOperand(def)->isAddr ? ssaIndex(cur, def) : -1;
+    if (code->kind == IR_IF_GOTO) {
+        visitBranch(cfg, blockOf[i - cfg->funcStart]);
+        return;
+    }
+    if (idx < 0) return;
+    int kind = LAT_BOTTOM, val = 0;
+    switch (code->kind) {
+        case IR_ASSIGN:
+            kind = evalOperand(code->u.assign.right, &val);
+            break;
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV: {
+            int a, c;
+            int x = evalOperand(code->u.binOp.op1, &a);
+            int y = evalOperand(code->u.binOp.op2, &c);
+            if (code->kind == IR_MUL &&
+                ((x == LAT_CONST && a == 0) || (y == LAT_CONST && c == 0)))
+                kind = LAT_CONST;
+            else if (x == LAT_BOTTOM || y == LAT_BOTTOM)
+                kind = LAT_BOTTOM;
+            else if (x == LAT_TOP || y == LAT_TOP)
+                kind = LAT_TOP;
+            else if (evalBinOp(code->kind, a, c, &val))
+                kind = LAT_CONST;
+            break;
+        }
+        default:
+            break;
+    }
+    lowerName(idx, kind, val);
+}
+
+static void buildUses(pCfg cfg) {
+    OperandId* slots[3];
+    pInterCodeList list = cur->list;
+    int nameNum = cur->nameNum;
+    useStart = (int*)calloc(nameNum + 1, sizeof(int));
+    assert(useStart != NULL);
+    int* fill = NULL;
+    for (int pass = 0; pass < 2; pass++) {
+#define ADD_USE(id, item)                                 \
+    do {                                                  \
+        int _idx = ssaIndex(cur, id);                     \
+        if (_idx < 0) break;                              \
+        if (pass == 0)                                    \
+            useStart[_idx + 1]++;                         \
+        else                                              \
+            useItems[fill[_idx]++] = item;                \
+    } while (0)
+        for (int i = cfg->funcStart; i < cfg->funcEnd; i++) {
+            int useNum = getUseSlots(&list->codes[i], slots);
+            for (int j = 0; j < useNum; j++) ADD_USE(*slots[j], i);
+        }
+        for (int phi = 0; phi < cur->phiNum; phi++) {
+            int b = cur->phis[phi].block;
+            for (int k = 0; k < cfg->blocks[b].predNum; k++) {
+                OperandId arg = *phiArg(cur, phi, k);
+                if (arg) ADD_USE(arg, -1 - phi);
+            }
+        }
+#undef ADD_USE
+        if (pass == 0) {
+            for (int idx = 0; idx < nameNum; idx++) useStart[idx + 1] += useStart[idx];
+            useItems = (int*)malloc(sizeof(int) * (useStart[nameNum] + 1));
+            fill = (int*)malloc(sizeof(int) * (nameNum + 1));
+            assert(useItems != NULL && fill != NULL);
+            memcpy(fill, useStart, sizeof(int) * nameNum);
+        }
+    }
+    free(fill);
+}
+
+// 按格值改写：走不到的块和边标出来，定下的分支改成GOTO或删掉，
+// 常量的使用换成立即数
+static int applyConstants(pCfg cfg) {
+    OperandId* slots[3];
+    pInterCodeList list = cur->list;
+    int changed = 0;
+    forEachBlock(cfg, b) {
+        if (!blockExec[b]) {
+            if (!cur->blockDead[b]) changed++;
+            cur->blockDead[b] = 1;
+            continue;
+        }
+        pBlock block = &cfg->blocks[b];
+        for (int k = 0; k < block->succNum; k++)
+            if (!edgeExec[b * 2 + k]) cur->succDead[b * 2 + k] = 1;
+        pInterCode last = &list->codes[block->last - 1];
+        if (last->kind == IR_IF_GOTO && block->succNum == 2) {
+            if (!edgeExec[b * 2]) {
+                cur->codeDead[block->last - 1 - cfg->funcStart] = 1;
+                changed++;
+            } else if (!edgeExec[b * 2 + 1]) {
+                OperandId label = last->u.ifGoto.z;
+                last->kind = IR_GOTO;
+                last->u.oneOp.op = label;
+                changed++;
+            }
+        }
+        for (int i = block->first; i < block->last; i++) {
+            if (codeDead(cur, i)) continue;
+            pInterCode code = &list->codes[i];
+            int useNum = getUseSlots(code, slots);
+            for (int j = 0; j < useNum; j++) {
+                int idx = ssaIndex(cur, *slots[j]);
+                if (idx < 0 || latKind[idx] != LAT_CONST) continue;
+                if (replaceUse(cur, code, slots[j], newOperand(OP_CONSTANT, latVal[idx])))
+                    changed++;
+            }
+            OperandId def = getDef(code);
+            int idx = def && !getOperand(def)->isAddr ? ssaIndex(cur, def) : -1;
+            if (idx < 0 || latKind[idx] != LAT_CONST) continue;
+            if (code->kind >= IR_ADD && code->kind <= IR_DIV) {
+                toAssign(code, def, newOperand(OP_CONSTANT, latVal[idx]));
+                changed++;
+            }
+        }
+        // 活着的边上是常量的φ参数也换成立即数，回到普通代码时直接赋值
+        forEachSucc(cfg, b, s) {
+            if (!edgeExec[b * 2 + _i_s]) continue;
+            forEachPred(cfg, s, p) {
+                if (p != b) continue;
+                forEachPhi(cur, s, phi) {
+                    OperandId* arg = phiArg(cur, phi, _i_p);
+                    int idx = ssaIndex(cur, *arg);
+                    if (idx >= 0 && latKind[idx] == LAT_CONST)
+                        *arg = newOperand(OP_CONSTANT, latVal[idx]);
+                }
+            }
+        }
+    }
+    return changed;
+}
+
+int propagateConstantsSsa(pSsa ssa) {
+    cur = ssa;
+    pCfg cfg = ssa->cfg;
+    int n = cfg->blockNum, nameNum = ssa->nameNum;
+    latKind = (char*)malloc(nameNum + 1);
+    latVal = (int*)calloc(nameNum + 1, sizeof(int));
+    inNameWork = (char*)calloc(nameNum + 1, sizeof(char));
+    nameWork = (int*)malloc(sizeof(int) * (nameNum + 1));
+    blockExec = (char*)calloc(n, sizeof(char));
+    edgeExec = (char*)calloc(n * 2, sizeof(char));
+    flowWork = (int*)malloc(sizeof(int) * (n * 2 + 1));
+    blockOf = (int*)malloc(sizeof(int) * (cfg->funcEnd - cfg->funcStart));
+    assert(latKind && latVal && inNameWork && nameWork && blockExec && edgeExec &&
+           flowWork && blockOf);
+    for (int idx = 0; idx < nameNum; idx++) {
+        boolean entry = ssa->defCode[idx] < 0 && ssa->defPhi[idx] < 0;
+        latKind[idx] = entry ? LAT_CONST : LAT_TOP;
+    }
+    forEachBlock(cfg, b)
+        for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++)
+            blockOf[i - cfg->funcStart] = b;
+    buildUses(cfg);
+
+    flowNum = nameWorkNum = 0;
+    int b = 0;  // 入口块当作有一条边进来
+    for (;;) {
+        if (b >= 0 && !blockExec[b]) {
+            blockExec[b] = 1;
+            pBlock block = &cfg->blocks[b];
+            for (int i = block->first; i < block->last; i++) visitCode(cfg, i);
+            if (cfg->list->codes[block->last - 1].kind != IR_IF_GOTO)
+                visitBranch(cfg, b);
+        }
+        b = -1;
+        if (flowNum) {
+            int e = flowWork[--flowNum];
+            b = cfg->blocks[e / 2].succ[e % 2];
+            forEachPhi(cur, b, phi) visitPhi(cfg, phi);
+        } else if (nameWorkNum) {
+            int idx = nameWork[--nameWorkNum];
+            inNameWork[idx] = 0;
+            for (int u = useStart[idx]; u < useStart[idx + 1]; u++) {
+                int item = useItems[u];
+                if (item < 0) {
+                    int phi = -1 - item;
+                    if (blockExec[ssa->phis[phi].block]) visitPhi(cfg, phi);
+                } else if (blockExec[blockOf[item - cfg->funcStart]]) {
+                    visitCode(cfg, item);
+                }
+            }
+        } else {
+            break;
+        }
+    }
+
+    int changed = applyConstants(cfg);
+    free(latKind);
+    free(latVal);
+    free(inNameWork);
+    free(nameWork);
+    free(blockExec);
+    free(edgeExec);
+    free(flowWork);
+    free(blockOf);
+    free(useStart);
+    free(useItems);
+    return changed;
+}
+
+// ---- 全局值编号 ----
+// 沿支配树先序走，表里的表达式在支配的块里都有效，出块时按后进先出弹掉。
+// 表达式的键是运算和两个操作数的值编号，值编号就是代表它的SSA名字。
+// 和块内的numberValues一样，i := i + c 这种更新留着给强度削弱认
+
+typedef struct _gvnEntry {
+    int kind;
+    int tagA, valA, tagB, valB;
+    int name;
+    int next;
+} GvnEntry;
+
+static int* repl;        // SSA名字 -> 代表它的名字
+static int* buckets;
+static unsigned bucketMask;
+static GvnEntry* entries;
+static int entryNum, entryCap;
+
+// 立即数记作(1, 值)，SSA名字记作(2, 代表它的名字)，别的不参与编号
+static boolean operandKey(OperandId id, int* tag, int* val) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT) {
+        *tag = 1;
+        *val = op->u.value;
+        return TRUE;
+    }
+    int idx = op->isAddr ? -1 : ssaIndex(cur, id);
+    if (idx < 0) return FALSE;
+    *tag = 2;
+    *val = repl[idx];
+    return TRUE;
+}
+
+static unsigned hashKey(GvnEntry* e) {
+    unsigned h = (unsigned)e->kind * 31u + (unsigned)e->tagA;
+    h = h * 1000003u + (unsigned)e->valA;
+    h = h * 31u + (unsigned)e->tagB;
+    h = h * 1000003u + (unsigned)e->valB;
+    return (h ^ (h >> 15)) & bucketMask;
+}
+
+// 查表，没有就以name插入，返回表里的名字
+static int lookupOrInsert(GvnEntry* key) {
+    unsigned h = hashKey(key);
+    for (int e = buckets[h]; e >= 0; e = entries[e].next) {
+        GvnEntry* p = &entries[e];
+        if (p->kind == key->kind && p->tagA == key->tagA && p->valA == key->valA &&
+            p->tagB == key->tagB && p->valB == key->valB)
+            return p->name;
+    }
+    if (entryNum == entryCap) {
+        entryCap = entryCap ? entryCap * 2 : 256;
+        entries = (GvnEntry*)realloc(entries, sizeof(GvnEntry) * entryCap);
+        assert(entries != NULL);
+    }
+    key->next = buckets[h];
+    entries[entryNum] = *key;
+    buckets[h] = entryNum++;
+    return key->name;
+}
+
+static void popEntries(int mark) {
+    while (entryNum > mark) {
+        entryNum--;
+        buckets[hashKey(&entries[entryNum])] = entries[entryNum].next;
+    }
+}
+
+static boolean isUpdate(int def, OperandId op) {
+    int idx = ssaIndex(cur, op);
+    return idx >= 0 && cur->nameVar[idx] == cur->nameVar[def];
+}
+
+static int numberBlock(pCfg cfg, int b) {
+    OperandId* slots[3];
+    pInterCodeList list = cur->list;
+    int changed = 0;
+    // 活着的参数都是同一个名字（不算φ自己）的φ就是这个名字
+    forEachPhi(cur, b, phi) {
+        int def = ssaIndex(cur, cur->phis[phi].def), same = -1;
+        for (int k = 0; k < cfg->blocks[b].predNum && same != -2; k++) {
+            if (!predAlive(cur, b, k)) continue;
+            int idx = ssaIndex(cur, *phiArg(cur, phi, k));
+            if (idx >= 0) idx = repl[idx];
+            if (idx == def) continue;
+            same = idx < 0 || (same >= 0 && same != idx) ? -2 : idx;
+        }
+        if (same >= 0) {
+            repl[def] = same;
+            changed++;
+        }
+    }
+    for (int i = cfg->blocks[b].first; i < cfg->blocks[b].last; i++) {
+        if (codeDead(cur, i)) continue;
+        pInterCode code = &list->codes[i];
+        int useNum = getUseSlots(code, slots);
+        for (int j = 0; j < useNum; j++) {
+            int idx = ssaIndex(cur, *slots[j]);
+            if (idx >= 0 && repl[idx] != idx)
+                replaceUse(cur, code, slots[j], cur->nameOp[repl[idx]]);
+        }
+        OperandId def = getDef(code);
+        int d = def && !getOperand(def)->isAddr ? ssaIndex(cur, def) : -1;
+        if (d < 0) continue;
+        GvnEntry key;
+        key.kind = code->kind;
+        key.name = d;
+        key.tagB = key.valB = 0;
+        switch (code->kind) {
+            case IR_ASSIGN: {
+                OperandId right = code->u.assign.right;
+                int idx = getOperand(right)->isAddr ? -1 : ssaIndex(cur, right);
+                if (idx < 0) continue;
+                repl[d] = idx;
+                cur->codeDead[i - cfg->funcStart] = 1;
+                changed++;
+                continue;
+            }
+            case IR_GET_ADDR:
+                key.tagA = 3;
+                key.valA = valueIndex(code->u.assign.right);
+                break;
+            case IR_ADD:
+            case IR_SUB:
+            case IR_MUL:
+            case IR_DIV: {
+                OperandId op1 = code->u.binOp.op1, op2 = code->u.binOp.op2;
+                if (isUpdate(d, op1) || isUpdate(d, op2) ||
+                    !operandKey(op1, &key.tagA, &key.valA) ||
+                    !operandKey(op2, &key.tagB, &key.valB))
+                    continue;
+                if ((code->kind == IR_ADD || code->kind == IR_MUL) &&
+                    (key.tagA > key.tagB ||
+                     (key.tagA == key.tagB && key.valA > key.valB))) {
+                    int t = key.tagA;
+                    key.tagA = key.tagB;
+                    key.tagB = t;
+                    t = key.valA;
+                    key.valA = key.valB;
+                    key.valB = t;
+                }
+                break;
+            }
+            default:
+                continue;
+        }
+        int leader = lookupOrInsert(&key);
+        if (leader != d) {
+            repl[d] = leader;
+            cur->codeDead[i - cfg->funcStart] = 1;
+            changed++;
+        }
+    }
+    return changed;
+}
+
+int numberValuesSsa(pSsa ssa) {
+    cur = ssa;
+    pCfg cfg = ssa->cfg;
+    int n = cfg->blockNum, nameNum = ssa->nameNum;
+    repl = (int*)malloc(sizeof(int) * (nameNum + 1));
+    int* order = (int*)malloc(sizeof(int) * (n * 2 + 1));
+    int* stack = (int*)malloc(sizeof(int) * (n + 1));
+    int* marks = (int*)malloc(sizeof(int) * (n + 1));
+    assert(repl && order && stack && marks);
+    for (int idx = 0; idx < nameNum; idx++) repl[idx] = idx;
+    int codeNum = cfg->funcEnd - cfg->funcStart;
+    bucketMask = 63;
+    while (bucketMask < (unsigned)codeNum) bucketMask = bucketMask * 2 + 1;
+    buckets = (int*)malloc(sizeof(int) * (bucketMask + 1));
+    assert(buckets != NULL);
+    memset(buckets, -1, sizeof(int) * (bucketMask + 1));
+    entries = NULL;
+    entryNum = entryCap = 0;
+
+    // 按支配树先序排好，栈里是当前块的祖先
+    for (int i = 0; i < n * 2; i++) order[i] = -1;
+    forEachRpo(cfg, b) order[cfg->blocks[b].domPre] = b;
+    int changed = 0, top = 0;
+    for (int i = 0; i < n * 2; i++) {
+        int b = order[i];
+        if (b < 0) continue;
+        while (top && !dominates(cfg, stack[top - 1], b)) popEntries(marks[--top]);
+        marks[top] = entryNum;
+        stack[top++] = b;
+        if (!ssa->blockDead[b]) changed += numberBlock(cfg, b);
+    }
+
+    // φ的参数不一定在支配的块里，最后统一换
+    for (int phi = 0; phi < ssa->phiNum; phi++) {
+        int b = ssa->phis[phi].block;
+        for (int k = 0; k < cfg->blocks[b].predNum; k++) {
+            OperandId* arg = phiArg(ssa, phi, k);
+            int idx = predAlive(ssa, b, k) ? ssaIndex(ssa, *arg) : -1;
+            if (idx >= 0 && repl[idx] != idx) *arg = ssa->nameOp[repl[idx]];
+        }
+    }
+
+    free(repl);
+    free(order);
+    free(stack);
+    free(marks);
+    free(buckets);
+    free(entries);
+    return changed;
+}
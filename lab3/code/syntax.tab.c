@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -41,14 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
-
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.5.1"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -66,17 +67,19 @@
 
 
 /* First part of user prologue.  */
-#line 1 "./syntax.y"
+#line 1 "syntax.y"
 
     #include<stdio.h>
     #include"node.h"
     #include"lex.yy.c"
     extern boolean synError;
     pNode root;
-    #define YYERROR_VERBOSE 1
+    Arena treeArena;
+    // 右递归的列表(DefList/StmtList)会压很深的栈，默认的10000不够
+    #define YYMAXDEPTH 1000000
 
 
-#line 80 "./syntax.tab.c"
+#line 83 "syntax.tab.c"
 
 # ifndef YY_CAST
 #  ifdef __cplusplus
@@ -99,98 +102,67 @@
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* Use api.header.include to #include this header
-   instead of duplicating it here.  */
-#ifndef YY_YY_SYNTAX_TAB_H_INCLUDED
-# define YY_YY_SYNTAX_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token type.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    INT = 258,
-    FLOAT = 259,
-    ID = 260,
-    TYPE = 261,
-    COMMA = 262,
-    DOT = 263,
-    SEMI = 264,
-    RELOP = 265,
-    ASSIGNOP = 266,
-    PLUS = 267,
-    MINUS = 268,
-    STAR = 269,
-    DIV = 270,
-    AND = 271,
-    OR = 272,
-    NOT = 273,
-    LP = 274,
-    RP = 275,
-    LB = 276,
-    RB = 277,
-    LC = 278,
-    RC = 279,
-    IF = 280,
-    ELSE = 281,
-    WHILE = 282,
-    STRUCT = 283,
-    RETURN = 284,
-    LOWER_THAN_ELSE = 285
-  };
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-union YYSTYPE
-{
-#line 13 "./syntax.y"
-
-    pNode node; 
-
-#line 167 "./syntax.tab.c"
-
-};
-typedef union YYSTYPE YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-/* Location type.  */
-#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE YYLTYPE;
-struct YYLTYPE
+#include "syntax.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
 {
-  int first_line;
-  int first_column;
-  int last_line;
-  int last_column;
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "$end"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_INT = 3,                        /* INT  */
+  YYSYMBOL_FLOAT = 4,                      /* FLOAT  */
+  YYSYMBOL_ID = 5,                         /* ID  */
+  YYSYMBOL_TYPE = 6,                       /* TYPE  */
+  YYSYMBOL_COMMA = 7,                      /* COMMA  */
+  YYSYMBOL_DOT = 8,                        /* DOT  */
+  YYSYMBOL_SEMI = 9,                       /* SEMI  */
+  YYSYMBOL_RELOP = 10,                     /* RELOP  */
+  YYSYMBOL_ASSIGNOP = 11,                  /* ASSIGNOP  */
+  YYSYMBOL_PLUS = 12,                      /* PLUS  */
+  YYSYMBOL_MINUS = 13,                     /* MINUS  */
+  YYSYMBOL_STAR = 14,                      /* STAR  */
+  YYSYMBOL_DIV = 15,                       /* DIV  */
+  YYSYMBOL_AND = 16,                       /* AND  */
+  YYSYMBOL_OR = 17,                        /* OR  */
+  YYSYMBOL_NOT = 18,                       /* NOT  */
+  YYSYMBOL_LP = 19,                        /* LP  */
+  YYSYMBOL_RP = 20,                        /* RP  */
+  YYSYMBOL_LB = 21,                        /* LB  */
+  YYSYMBOL_RB = 22,                        /* RB  */
+  YYSYMBOL_LC = 23,                        /* LC  */
+  YYSYMBOL_RC = 24,                        /* RC  */
+  YYSYMBOL_IF = 25,                        /* IF  */
+  YYSYMBOL_ELSE = 26,                      /* ELSE  */
+  YYSYMBOL_WHILE = 27,                     /* WHILE  */
+  YYSYMBOL_STRUCT = 28,                    /* STRUCT  */
+  YYSYMBOL_RETURN = 29,                    /* RETURN  */
+  YYSYMBOL_LOWER_THAN_ELSE = 30,           /* LOWER_THAN_ELSE  */
+  YYSYMBOL_YYACCEPT = 31,                  /* $accept  */
+  YYSYMBOL_Program = 32,                   /* Program  */
+  YYSYMBOL_ExtDefList = 33,                /* ExtDefList  */
+  YYSYMBOL_ExtDef = 34,                    /* ExtDef  */
+  YYSYMBOL_ExtDecList = 35,                /* ExtDecList  */
+  YYSYMBOL_Specifier = 36,                 /* Specifier  */
+  YYSYMBOL_StructSpecifier = 37,           /* StructSpecifier  */
+  YYSYMBOL_OptTag = 38,                    /* OptTag  */
+  YYSYMBOL_Tag = 39,                       /* Tag  */
+  YYSYMBOL_VarDec = 40,                    /* VarDec  */
+  YYSYMBOL_FunDec = 41,                    /* FunDec  */
+  YYSYMBOL_VarList = 42,                   /* VarList  */
+  YYSYMBOL_ParamDec = 43,                  /* ParamDec  */
+  YYSYMBOL_CompSt = 44,                    /* CompSt  */
+  YYSYMBOL_StmtList = 45,                  /* StmtList  */
+  YYSYMBOL_Stmt = 46,                      /* Stmt  */
+  YYSYMBOL_DefList = 47,                   /* DefList  */
+  YYSYMBOL_Def = 48,                       /* Def  */
+  YYSYMBOL_DecList = 49,                   /* DecList  */
+  YYSYMBOL_Dec = 50,                       /* Dec  */
+  YYSYMBOL_Exp = 51,                       /* Exp  */
+  YYSYMBOL_Args = 52                       /* Args  */
 };
-# define YYLTYPE_IS_DECLARED 1
-# define YYLTYPE_IS_TRIVIAL 1
-#endif
-
-
-extern YYSTYPE yylval;
-extern YYLTYPE yylloc;
-int yyparse (void);
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-#endif /* !YY_YY_SYNTAX_TAB_H_INCLUDED  */
 
 
 
@@ -231,6 +203,18 @@ typedef int_least16_t yytype_int16;
 typedef short yytype_int16;
 #endif
 
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
 #if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
 typedef __UINT_LEAST8_TYPE__ yytype_uint8;
 #elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
@@ -290,6 +274,7 @@ typedef int yytype_uint16;
 
 #define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
 
+
 /* Stored state numbers (used for stacks). */
 typedef yytype_int8 yy_state_t;
 
@@ -308,6 +293,7 @@ typedef int yy_state_fast_t;
 # endif
 #endif
 
+
 #ifndef YY_ATTRIBUTE_PURE
 # if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
 #  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
@@ -326,17 +312,23 @@ typedef int yy_state_fast_t;
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && ! defined __ICC && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                            \
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
     _Pragma ("GCC diagnostic push")                                     \
     _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
 # define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
@@ -365,7 +357,7 @@ typedef int yy_state_fast_t;
 
 #define YY_ASSERT(E) ((void) (0 && (E)))
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if 1
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -430,8 +422,7 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* 1 */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
@@ -510,14 +501,16 @@ union yyalloc
 /* YYNSTATES -- Number of states.  */
 #define YYNSTATES  121
 
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   285
 
 
 /* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex, with out-of-bounds checking.  */
-#define YYTRANSLATE(YYX)                                                \
-  (0 <= (YYX) && (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
    as returned by yylex.  */
@@ -555,45 +548,47 @@ static const yytype_int8 yytranslate[] =
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
 static const yytype_uint8 yyrline[] =
 {
-       0,    63,    63,    65,    66,    68,    69,    70,    71,    73,
-      74,    78,    79,    81,    82,    84,    85,    87,    91,    92,
-      93,    95,    96,    97,    99,   100,   102,   105,   106,   108,
-     109,   111,   112,   113,   114,   115,   116,   117,   120,   121,
-     123,   125,   126,   128,   129,   132,   133,   134,   135,   136,
-     137,   138,   139,   140,   141,   142,   143,   144,   145,   146,
-     147,   148,   149,   151,   152
+       0,    70,    70,    72,    73,    75,    76,    77,    78,    80,
+      81,    85,    86,    88,    89,    91,    92,    94,    98,    99,
+     100,   102,   103,   104,   106,   107,   109,   112,   113,   115,
+     116,   118,   119,   120,   121,   122,   123,   124,   127,   128,
+     130,   132,   133,   135,   136,   139,   140,   141,   142,   143,
+     144,   145,   146,   147,   148,   149,   150,   151,   152,   153,
+     154,   155,   156,   158,   159
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "INT", "FLOAT", "ID", "TYPE", "COMMA",
-  "DOT", "SEMI", "RELOP", "ASSIGNOP", "PLUS", "MINUS", "STAR", "DIV",
-  "AND", "OR", "NOT", "LP", "RP", "LB", "RB", "LC", "RC", "IF", "ELSE",
-  "WHILE", "STRUCT", "RETURN", "LOWER_THAN_ELSE", "$accept", "Program",
-  "ExtDefList", "ExtDef", "ExtDecList", "Specifier", "StructSpecifier",
-  "OptTag", "Tag", "VarDec", "FunDec", "VarList", "ParamDec", "CompSt",
-  "StmtList", "Stmt", "DefList", "Def", "DecList", "Dec", "Exp", "Args", YY_NULLPTR
+  "\"$end\"", "error", "\"invalid token\"", "INT", "FLOAT", "ID", "TYPE",
+  "COMMA", "DOT", "SEMI", "RELOP", "ASSIGNOP", "PLUS", "MINUS", "STAR",
+  "DIV", "AND", "OR", "NOT", "LP", "RP", "LB", "RB", "LC", "RC", "IF",
+  "ELSE", "WHILE", "STRUCT", "RETURN", "LOWER_THAN_ELSE", "$accept",
+  "Program", "ExtDefList", "ExtDef", "ExtDecList", "Specifier",
+  "StructSpecifier", "OptTag", "Tag", "VarDec", "FunDec", "VarList",
+  "ParamDec", "CompSt", "StmtList", "Stmt", "DefList", "Def", "DecList",
+  "Dec", "Exp", "Args", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_int16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
 #define YYPACT_NINF (-58)
 
@@ -605,8 +600,8 @@ static const yytype_int16 yytoknum[] =
 #define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int16 yypact[] =
 {
        8,    -5,   -58,    19,    13,   -58,     8,    74,   -58,   -58,
@@ -624,9 +619,9 @@ static const yytype_int16 yypact[] =
      -58
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
 static const yytype_int8 yydefact[] =
 {
        0,     0,    11,    16,     0,     2,     0,     0,    12,     8,
@@ -644,7 +639,7 @@ static const yytype_int8 yydefact[] =
       35
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int16 yypgoto[] =
 {
      -58,   -58,   152,   -58,   145,    11,   -58,   -58,   -58,   -28,
@@ -652,17 +647,17 @@ static const yytype_int16 yypgoto[] =
      -57,    77
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     4,     5,     6,    18,    31,     8,    11,    12,    19,
+       0,     4,     5,     6,    18,    31,     8,    11,    12,    19,
       20,    36,    37,    63,    64,    65,    32,    33,    45,    46,
       66,    96
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int8 yytable[] =
 {
       73,    74,    75,    44,     9,    78,    71,    49,    -4,     1,
@@ -721,8 +716,8 @@ static const yytype_int8 yycheck[] =
       15,    -1,    -1,    -1,    21,    -1,    21
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
 static const yytype_int8 yystos[] =
 {
        0,     1,     6,    28,    32,    33,    34,    36,    37,     9,
@@ -740,7 +735,7 @@ static const yytype_int8 yystos[] =
       46
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr1[] =
 {
        0,    31,    32,    33,    33,    34,    34,    34,    34,    35,
@@ -752,7 +747,7 @@ static const yytype_int8 yyr1[] =
       51,    51,    51,    52,    52
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
 static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     2,     0,     3,     2,     3,     2,     1,
@@ -765,14 +760,15 @@ static const yytype_int8 yyr2[] =
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
@@ -794,10 +790,9 @@ static const yytype_int8 yyr2[] =
       }                                                           \
   while (0)
 
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
-
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
 /* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
    If N is 0, then set CURRENT to the empty location which ends
@@ -841,12 +836,19 @@ do {                                            \
 } while (0)
 
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
+/* YYLOCATION_PRINT -- Print the location on the stream.
    This macro was not mandated originally: define only if we know
    we won't break user code: when these are the locations we know.  */
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
 
 /* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
 
@@ -874,24 +876,32 @@ yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
         res += YYFPRINTF (yyo, "-%d", end_col);
     }
   return res;
- }
+}
 
-#  define YY_LOCATION_PRINT(File, Loc)          \
-  yy_location_print_ (File, &(Loc))
+#   define YYLOCATION_PRINT  yy_location_print_
 
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
 
+#  else
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value, Location); \
+                  Kind, Value, Location); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
@@ -902,19 +912,16 @@ do {                                                                      \
 `-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
   FILE *yyoutput = yyo;
-  YYUSE (yyoutput);
-  YYUSE (yylocationp);
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyo, yytoknum[yytype], *yyvaluep);
-# endif
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
@@ -924,14 +931,15 @@ yy_symbol_value_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YY
 `---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyo, int yytype, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
   YYFPRINTF (yyo, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  YY_LOCATION_PRINT (yyo, *yylocationp);
+  YYLOCATION_PRINT (yyo, yylocationp);
   YYFPRINTF (yyo, ": ");
-  yy_symbol_value_print (yyo, yytype, yyvaluep, yylocationp);
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
   YYFPRINTF (yyo, ")");
 }
 
@@ -964,7 +972,8 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule)
 {
   int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
@@ -976,9 +985,9 @@ yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp, int yyrule)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[+yyssp[yyi + 1 - yynrhs]],
-                       &yyvsp[(yyi + 1) - (yynrhs)]
-                       , &(yylsp[(yyi + 1) - (yynrhs)])                       );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]));
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -993,8 +1002,8 @@ do {                                    \
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -1017,12 +1026,61 @@ int yydebug;
 #endif
 
 
-#if YYERROR_VERBOSE
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+  YYLTYPE *yylloc;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
 
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
-#  else
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
 /* Return the length of YYSTR.  */
 static YYPTRDIFF_T
 yystrlen (const char *yystr)
@@ -1032,13 +1090,13 @@ yystrlen (const char *yystr)
     continue;
   return yylen;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
 /* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
    YYDEST.  */
 static char *
@@ -1052,10 +1110,10 @@ yystpcpy (char *yydest, const char *yysrc)
 
   return yyd - 1;
 }
-#  endif
 # endif
+#endif
 
-# ifndef yytnamerr
+#ifndef yytnamerr
 /* Copy to YYRES the contents of YYSTR after stripping away unnecessary
    quotes and backslashes, so that it's suitable for yyerror.  The
    heuristic is that double-quoting is unnecessary unless the string
@@ -1070,7 +1128,6 @@ yytnamerr (char *yyres, const char *yystr)
     {
       YYPTRDIFF_T yyn = 0;
       char const *yyp = yystr;
-
       for (;;)
         switch (*++yyp)
           {
@@ -1104,31 +1161,15 @@ yytnamerr (char *yyres, const char *yystr)
   else
     return yystrlen (yystr);
 }
-# endif
+#endif
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
 static int
-yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
-                yy_state_t *yyssp, int yytoken)
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
 {
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat: reported tokens (one for the "unexpected",
-     one per "expected"). */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
   /* Actual size of YYARG. */
   int yycount = 0;
-  /* Cumulated lengths of YYARG.  */
-  YYPTRDIFF_T yysize = 0;
-
   /* There are many possibilities here to consider:
      - If this state is a consistent state with a default action, then
        the only way this function was invoked is if the default action
@@ -1152,52 +1193,54 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
        one exception: it will still contain any token that will not be
        accepted due to an error action in a later state.
   */
-  if (yytoken != YYEMPTY)
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
     {
-      int yyn = yypact[+*yyssp];
-      YYPTRDIFF_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-      yysize = yysize0;
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYPTRDIFF_T yysize1
-                    = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-                    yysize = yysize1;
-                  else
-                    return 2;
-                }
-              }
-        }
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
     }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
 
   switch (yycount)
     {
-# define YYCASE_(N, S)                      \
+#define YYCASE_(N, S)                       \
       case N:                               \
         yyformat = S;                       \
-      break
+        break
     default: /* Avoid compiler warnings. */
       YYCASE_(0, YY_("syntax error"));
       YYCASE_(1, YY_("syntax error, unexpected %s"));
@@ -1205,17 +1248,23 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
       YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
       YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
+#undef YYCASE_
     }
 
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
   {
-    /* Don't count the "%s"s in the final size, but reserve room for
-       the terminator.  */
-    YYPTRDIFF_T yysize1 = yysize + (yystrlen (yyformat) - 2 * yycount) + 1;
-    if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
-      yysize = yysize1;
-    else
-      return 2;
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
   }
 
   if (*yymsg_alloc < yysize)
@@ -1224,7 +1273,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
       if (! (yysize <= *yymsg_alloc
              && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
         *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
+      return -1;
     }
 
   /* Avoid sprintf, as that infringes on the user's name space.
@@ -1236,7 +1285,7 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
     while ((*yyp = *yyformat) != '\0')
       if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
         {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
           yyformat += 2;
         }
       else
@@ -1247,30 +1296,29 @@ yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
   }
   return 0;
 }
-#endif /* YYERROR_VERBOSE */
+
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
 {
-  YYUSE (yyvaluep);
-  YYUSE (yylocationp);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
@@ -1285,6 +1333,8 @@ YYLTYPE yylloc
 int yynerrs;
 
 
+
+
 /*----------.
 | yyparse.  |
 `----------*/
@@ -1292,53 +1342,48 @@ int yynerrs;
 int
 yyparse (void)
 {
-    yy_state_fast_t yystate;
+    yy_state_fast_t yystate = 0;
     /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
-
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
-       'yyls': related to locations.
+    int yyerrstatus = 0;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
        to reallocate them elsewhere.  */
 
-    /* The state stack.  */
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
     yy_state_t yyssa[YYINITDEPTH];
-    yy_state_t *yyss;
-    yy_state_t *yyssp;
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
-    /* The semantic value stack.  */
+    /* The semantic value stack: array, bottom, top.  */
     YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-    /* The location stack.  */
+    /* The location stack: array, bottom, top.  */
     YYLTYPE yylsa[YYINITDEPTH];
-    YYLTYPE *yyls;
-    YYLTYPE *yylsp;
-
-    /* The locations where the error started and ended.  */
-    YYLTYPE yyerror_range[3];
-
-    YYPTRDIFF_T yystacksize;
+    YYLTYPE *yyls = yylsa;
+    YYLTYPE *yylsp = yyls;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
   YYLTYPE yyloc;
 
-#if YYERROR_VERBOSE
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
+
   /* Buffer for error messages, and its allocated size.  */
   char yymsgbuf[128];
   char *yymsg = yymsgbuf;
   YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
 #define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
@@ -1346,17 +1391,10 @@ yyparse (void)
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yylsp = yyls = yylsa;
-  yystacksize = YYINITDEPTH;
-
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
   yylsp[0] = yylloc;
   goto yysetstate;
 
@@ -1379,10 +1417,11 @@ yysetstate:
   YY_IGNORE_USELESS_CAST_BEGIN
   *yyssp = YY_CAST (yy_state_t, yystate);
   YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
 #if !defined yyoverflow && !defined YYSTACK_RELOCATE
-    goto yyexhaustedlab;
+    YYNOMEM;
 #else
     {
       /* Get the current used size of the three stacks, in elements.  */
@@ -1413,7 +1452,7 @@ yysetstate:
 # else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
@@ -1424,11 +1463,11 @@ yysetstate:
           YY_CAST (union yyalloc *,
                    YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
         YYSTACK_RELOCATE (yyls_alloc, yyls);
-# undef YYSTACK_RELOCATE
+#  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
@@ -1448,6 +1487,7 @@ yysetstate:
     }
 #endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
+
   if (yystate == YYFINAL)
     YYACCEPT;
 
@@ -1468,18 +1508,30 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
+      YYDPRINTF ((stderr, "Reading a token\n"));
       yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1551,386 +1603,386 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-  case 2:
-#line 63 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Program", 1, (yyvsp[0].node)); root = (yyval.node); }
-#line 1558 "./syntax.tab.c"
+  case 2: /* Program: ExtDefList  */
+#line 70 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_PROGRAM, PROD_PROGRAM, 1, (yyvsp[0].node)); root = (yyval.node); }
+#line 1610 "syntax.tab.c"
     break;
 
-  case 3:
-#line 65 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ExtDefList", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1564 "./syntax.tab.c"
+  case 3: /* ExtDefList: ExtDef ExtDefList  */
+#line 72 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXT_DEF_LIST, PROD_EXT_DEF_LIST, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1616 "syntax.tab.c"
     break;
 
-  case 4:
-#line 66 "./syntax.y"
+  case 4: /* ExtDefList: %empty  */
+#line 73 "syntax.y"
                                                             { (yyval.node) = NULL; }
-#line 1570 "./syntax.tab.c"
+#line 1622 "syntax.tab.c"
     break;
 
-  case 5:
-#line 68 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ExtDef", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1576 "./syntax.tab.c"
+  case 5: /* ExtDef: Specifier ExtDecList SEMI  */
+#line 75 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXT_DEF, PROD_EXT_DEF_VAR, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1628 "syntax.tab.c"
     break;
 
-  case 6:
-#line 69 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ExtDef", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1582 "./syntax.tab.c"
+  case 6: /* ExtDef: Specifier SEMI  */
+#line 76 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXT_DEF, PROD_EXT_DEF_TYPE, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1634 "syntax.tab.c"
     break;
 
-  case 7:
-#line 70 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ExtDef", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1588 "./syntax.tab.c"
+  case 7: /* ExtDef: Specifier FunDec CompSt  */
+#line 77 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXT_DEF, PROD_EXT_DEF_FUNC, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1640 "syntax.tab.c"
     break;
 
-  case 8:
-#line 71 "./syntax.y"
+  case 8: /* ExtDef: error SEMI  */
+#line 78 "syntax.y"
                                                             { synError = TRUE; }
-#line 1594 "./syntax.tab.c"
+#line 1646 "syntax.tab.c"
     break;
 
-  case 9:
-#line 73 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ExtDecList", 1, (yyvsp[0].node)); }
-#line 1600 "./syntax.tab.c"
+  case 9: /* ExtDecList: VarDec  */
+#line 80 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXT_DEC_LIST, PROD_EXT_DEC_LIST_ONE, 1, (yyvsp[0].node)); }
+#line 1652 "syntax.tab.c"
     break;
 
-  case 10:
-#line 74 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ExtDecList", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1606 "./syntax.tab.c"
+  case 10: /* ExtDecList: VarDec COMMA ExtDecList  */
+#line 81 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXT_DEC_LIST, PROD_EXT_DEC_LIST_MORE, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1658 "syntax.tab.c"
     break;
 
-  case 11:
-#line 78 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Specifier", 1, (yyvsp[0].node)); }
-#line 1612 "./syntax.tab.c"
+  case 11: /* Specifier: TYPE  */
+#line 85 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_SPECIFIER, PROD_SPECIFIER_TYPE, 1, (yyvsp[0].node)); }
+#line 1664 "syntax.tab.c"
     break;
 
-  case 12:
-#line 79 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Specifier", 1, (yyvsp[0].node)); }
-#line 1618 "./syntax.tab.c"
+  case 12: /* Specifier: StructSpecifier  */
+#line 86 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_SPECIFIER, PROD_SPECIFIER_STRUCT, 1, (yyvsp[0].node)); }
+#line 1670 "syntax.tab.c"
     break;
 
-  case 13:
-#line 81 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "StructSpecifier", 5, (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1624 "./syntax.tab.c"
+  case 13: /* StructSpecifier: STRUCT OptTag LC DefList RC  */
+#line 88 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STRUCT_SPECIFIER, PROD_STRUCT_DEF, 5, (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1676 "syntax.tab.c"
     break;
 
-  case 14:
-#line 82 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "StructSpecifier", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1630 "./syntax.tab.c"
+  case 14: /* StructSpecifier: STRUCT Tag  */
+#line 89 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STRUCT_SPECIFIER, PROD_STRUCT_TAG, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1682 "syntax.tab.c"
     break;
 
-  case 15:
-#line 84 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "OptTag", 1, (yyvsp[0].node)); }
-#line 1636 "./syntax.tab.c"
+  case 15: /* OptTag: ID  */
+#line 91 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_OPT_TAG, PROD_OPT_TAG, 1, (yyvsp[0].node)); }
+#line 1688 "syntax.tab.c"
     break;
 
-  case 16:
-#line 85 "./syntax.y"
+  case 16: /* OptTag: %empty  */
+#line 92 "syntax.y"
                                                             { (yyval.node) = NULL; }
-#line 1642 "./syntax.tab.c"
+#line 1694 "syntax.tab.c"
     break;
 
-  case 17:
-#line 87 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Tag", 1, (yyvsp[0].node)); }
-#line 1648 "./syntax.tab.c"
+  case 17: /* Tag: ID  */
+#line 94 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_TAG, PROD_TAG, 1, (yyvsp[0].node)); }
+#line 1700 "syntax.tab.c"
     break;
 
-  case 18:
-#line 91 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "VarDec", 1, (yyvsp[0].node)); }
-#line 1654 "./syntax.tab.c"
+  case 18: /* VarDec: ID  */
+#line 98 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_VAR_DEC, PROD_VAR_DEC_ID, 1, (yyvsp[0].node)); }
+#line 1706 "syntax.tab.c"
     break;
 
-  case 19:
-#line 92 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "VarDec", 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1660 "./syntax.tab.c"
+  case 19: /* VarDec: VarDec LB INT RB  */
+#line 99 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_VAR_DEC, PROD_VAR_DEC_ARRAY, 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1712 "syntax.tab.c"
     break;
 
-  case 20:
-#line 93 "./syntax.y"
+  case 20: /* VarDec: error RB  */
+#line 100 "syntax.y"
                                                             { synError = TRUE; }
-#line 1666 "./syntax.tab.c"
+#line 1718 "syntax.tab.c"
     break;
 
-  case 21:
-#line 95 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "FunDec", 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1672 "./syntax.tab.c"
+  case 21: /* FunDec: ID LP VarList RP  */
+#line 102 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_FUN_DEC, PROD_FUN_DEC_ARGS, 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1724 "syntax.tab.c"
     break;
 
-  case 22:
-#line 96 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "FunDec", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1678 "./syntax.tab.c"
+  case 22: /* FunDec: ID LP RP  */
+#line 103 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_FUN_DEC, PROD_FUN_DEC_NO_ARGS, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1730 "syntax.tab.c"
     break;
 
-  case 23:
-#line 97 "./syntax.y"
+  case 23: /* FunDec: error RP  */
+#line 104 "syntax.y"
                                                             { synError = TRUE; }
-#line 1684 "./syntax.tab.c"
+#line 1736 "syntax.tab.c"
     break;
 
-  case 24:
-#line 99 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "VarList", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1690 "./syntax.tab.c"
+  case 24: /* VarList: ParamDec COMMA VarList  */
+#line 106 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_VAR_LIST, PROD_VAR_LIST_MORE, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1742 "syntax.tab.c"
     break;
 
-  case 25:
-#line 100 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "VarList", 1, (yyvsp[0].node)); }
-#line 1696 "./syntax.tab.c"
+  case 25: /* VarList: ParamDec  */
+#line 107 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_VAR_LIST, PROD_VAR_LIST_ONE, 1, (yyvsp[0].node)); }
+#line 1748 "syntax.tab.c"
     break;
 
-  case 26:
-#line 102 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "ParamDec", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1702 "./syntax.tab.c"
+  case 26: /* ParamDec: Specifier VarDec  */
+#line 109 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_PARAM_DEC, PROD_PARAM_DEC, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1754 "syntax.tab.c"
     break;
 
-  case 27:
-#line 105 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "CompSt", 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1708 "./syntax.tab.c"
+  case 27: /* CompSt: LC DefList StmtList RC  */
+#line 112 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_COMP_ST, PROD_COMP_ST, 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1760 "syntax.tab.c"
     break;
 
-  case 28:
-#line 106 "./syntax.y"
+  case 28: /* CompSt: error RC  */
+#line 113 "syntax.y"
                                                             { synError = TRUE; }
-#line 1714 "./syntax.tab.c"
+#line 1766 "syntax.tab.c"
     break;
 
-  case 29:
-#line 108 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "StmtList", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1720 "./syntax.tab.c"
+  case 29: /* StmtList: Stmt StmtList  */
+#line 115 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT_LIST, PROD_STMT_LIST, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1772 "syntax.tab.c"
     break;
 
-  case 30:
-#line 109 "./syntax.y"
+  case 30: /* StmtList: %empty  */
+#line 116 "syntax.y"
                                                             { (yyval.node) = NULL; }
-#line 1726 "./syntax.tab.c"
+#line 1778 "syntax.tab.c"
     break;
 
-  case 31:
-#line 111 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Stmt", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1732 "./syntax.tab.c"
+  case 31: /* Stmt: Exp SEMI  */
+#line 118 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT, PROD_STMT_EXP, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1784 "syntax.tab.c"
     break;
 
-  case 32:
-#line 112 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Stmt", 1, (yyvsp[0].node)); }
-#line 1738 "./syntax.tab.c"
+  case 32: /* Stmt: CompSt  */
+#line 119 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT, PROD_STMT_COMP_ST, 1, (yyvsp[0].node)); }
+#line 1790 "syntax.tab.c"
     break;
 
-  case 33:
-#line 113 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Stmt", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1744 "./syntax.tab.c"
+  case 33: /* Stmt: RETURN Exp SEMI  */
+#line 120 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT, PROD_STMT_RETURN, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1796 "syntax.tab.c"
     break;
 
-  case 34:
-#line 114 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Stmt", 5, (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1750 "./syntax.tab.c"
+  case 34: /* Stmt: IF LP Exp RP Stmt  */
+#line 121 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT, PROD_STMT_IF, 5, (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1802 "syntax.tab.c"
     break;
 
-  case 35:
-#line 115 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Stmt", 7, (yyvsp[-6].node), (yyvsp[-5].node), (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1756 "./syntax.tab.c"
+  case 35: /* Stmt: IF LP Exp RP Stmt ELSE Stmt  */
+#line 122 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT, PROD_STMT_IF_ELSE, 7, (yyvsp[-6].node), (yyvsp[-5].node), (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1808 "syntax.tab.c"
     break;
 
-  case 36:
-#line 116 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Stmt", 5, (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1762 "./syntax.tab.c"
+  case 36: /* Stmt: WHILE LP Exp RP Stmt  */
+#line 123 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_STMT, PROD_STMT_WHILE, 5, (yyvsp[-4].node), (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1814 "syntax.tab.c"
     break;
 
-  case 37:
-#line 117 "./syntax.y"
+  case 37: /* Stmt: error SEMI  */
+#line 124 "syntax.y"
                                                             { synError = TRUE; }
-#line 1768 "./syntax.tab.c"
+#line 1820 "syntax.tab.c"
     break;
 
-  case 38:
-#line 120 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "DefList", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1774 "./syntax.tab.c"
+  case 38: /* DefList: Def DefList  */
+#line 127 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_DEF_LIST, PROD_DEF_LIST, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1826 "syntax.tab.c"
     break;
 
-  case 39:
-#line 121 "./syntax.y"
+  case 39: /* DefList: %empty  */
+#line 128 "syntax.y"
                                                             { (yyval.node) = NULL; }
-#line 1780 "./syntax.tab.c"
+#line 1832 "syntax.tab.c"
     break;
 
-  case 40:
-#line 123 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Def", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1786 "./syntax.tab.c"
+  case 40: /* Def: Specifier DecList SEMI  */
+#line 130 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_DEF, PROD_DEF, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1838 "syntax.tab.c"
     break;
 
-  case 41:
-#line 125 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "DecList", 1, (yyvsp[0].node)); }
-#line 1792 "./syntax.tab.c"
+  case 41: /* DecList: Dec  */
+#line 132 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_DEC_LIST, PROD_DEC_LIST_ONE, 1, (yyvsp[0].node)); }
+#line 1844 "syntax.tab.c"
     break;
 
-  case 42:
-#line 126 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "DecList", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1798 "./syntax.tab.c"
+  case 42: /* DecList: Dec COMMA DecList  */
+#line 133 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_DEC_LIST, PROD_DEC_LIST_MORE, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1850 "syntax.tab.c"
     break;
 
-  case 43:
-#line 128 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Dec", 1, (yyvsp[0].node)); }
-#line 1804 "./syntax.tab.c"
+  case 43: /* Dec: VarDec  */
+#line 135 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_DEC, PROD_DEC, 1, (yyvsp[0].node)); }
+#line 1856 "syntax.tab.c"
     break;
 
-  case 44:
-#line 129 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Dec", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1810 "./syntax.tab.c"
+  case 44: /* Dec: VarDec ASSIGNOP Exp  */
+#line 136 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_DEC, PROD_DEC_INIT, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1862 "syntax.tab.c"
     break;
 
-  case 45:
-#line 132 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1816 "./syntax.tab.c"
+  case 45: /* Exp: Exp ASSIGNOP Exp  */
+#line 139 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_ASSIGN, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1868 "syntax.tab.c"
     break;
 
-  case 46:
-#line 133 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1822 "./syntax.tab.c"
+  case 46: /* Exp: Exp AND Exp  */
+#line 140 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_AND, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1874 "syntax.tab.c"
     break;
 
-  case 47:
-#line 134 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1828 "./syntax.tab.c"
+  case 47: /* Exp: Exp OR Exp  */
+#line 141 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_OR, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1880 "syntax.tab.c"
     break;
 
-  case 48:
-#line 135 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1834 "./syntax.tab.c"
+  case 48: /* Exp: Exp RELOP Exp  */
+#line 142 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_RELOP, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1886 "syntax.tab.c"
     break;
 
-  case 49:
-#line 136 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1840 "./syntax.tab.c"
+  case 49: /* Exp: Exp PLUS Exp  */
+#line 143 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_PLUS, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1892 "syntax.tab.c"
     break;
 
-  case 50:
-#line 137 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1846 "./syntax.tab.c"
+  case 50: /* Exp: Exp MINUS Exp  */
+#line 144 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_MINUS, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1898 "syntax.tab.c"
     break;
 
-  case 51:
-#line 138 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1852 "./syntax.tab.c"
+  case 51: /* Exp: Exp STAR Exp  */
+#line 145 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_STAR, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1904 "syntax.tab.c"
     break;
 
-  case 52:
-#line 139 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1858 "./syntax.tab.c"
+  case 52: /* Exp: Exp DIV Exp  */
+#line 146 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_DIV, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1910 "syntax.tab.c"
     break;
 
-  case 53:
-#line 140 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1864 "./syntax.tab.c"
+  case 53: /* Exp: LP Exp RP  */
+#line 147 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_PAREN, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1916 "syntax.tab.c"
     break;
 
-  case 54:
-#line 141 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1870 "./syntax.tab.c"
+  case 54: /* Exp: MINUS Exp  */
+#line 148 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_NEG, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1922 "syntax.tab.c"
     break;
 
-  case 55:
-#line 142 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 2, (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1876 "./syntax.tab.c"
+  case 55: /* Exp: NOT Exp  */
+#line 149 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_NOT, 2, (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1928 "syntax.tab.c"
     break;
 
-  case 56:
-#line 143 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1882 "./syntax.tab.c"
+  case 56: /* Exp: ID LP Args RP  */
+#line 150 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_CALL_ARGS, 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1934 "syntax.tab.c"
     break;
 
-  case 57:
-#line 144 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1888 "./syntax.tab.c"
+  case 57: /* Exp: ID LP RP  */
+#line 151 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_CALL, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1940 "syntax.tab.c"
     break;
 
-  case 58:
-#line 145 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1894 "./syntax.tab.c"
+  case 58: /* Exp: Exp LB Exp RB  */
+#line 152 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_INDEX, 4, (yyvsp[-3].node), (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1946 "syntax.tab.c"
     break;
 
-  case 59:
-#line 146 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1900 "./syntax.tab.c"
+  case 59: /* Exp: Exp DOT ID  */
+#line 153 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_DOT, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1952 "syntax.tab.c"
     break;
 
-  case 60:
-#line 147 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 1, (yyvsp[0].node)); }
-#line 1906 "./syntax.tab.c"
+  case 60: /* Exp: ID  */
+#line 154 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_ID, 1, (yyvsp[0].node)); }
+#line 1958 "syntax.tab.c"
     break;
 
-  case 61:
-#line 148 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 1, (yyvsp[0].node)); }
-#line 1912 "./syntax.tab.c"
+  case 61: /* Exp: INT  */
+#line 155 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_INT, 1, (yyvsp[0].node)); }
+#line 1964 "syntax.tab.c"
     break;
 
-  case 62:
-#line 149 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Exp", 1, (yyvsp[0].node)); }
-#line 1918 "./syntax.tab.c"
+  case 62: /* Exp: FLOAT  */
+#line 156 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_EXP, PROD_EXP_FLOAT, 1, (yyvsp[0].node)); }
+#line 1970 "syntax.tab.c"
     break;
 
-  case 63:
-#line 151 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Args", 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
-#line 1924 "./syntax.tab.c"
+  case 63: /* Args: Exp COMMA Args  */
+#line 158 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_ARGS, PROD_ARGS_MORE, 3, (yyvsp[-2].node), (yyvsp[-1].node), (yyvsp[0].node)); }
+#line 1976 "syntax.tab.c"
     break;
 
-  case 64:
-#line 152 "./syntax.y"
-                                                            { (yyval.node) = newNode((yyloc).first_line, NOT_A_TOKEN, "Args", 1, (yyvsp[0].node)); }
-#line 1930 "./syntax.tab.c"
+  case 64: /* Args: Exp  */
+#line 159 "syntax.y"
+                                                            { (yyval.node) = newNode((yyloc).first_line, SYM_ARGS, PROD_ARGS_ONE, 1, (yyvsp[0].node)); }
+#line 1982 "syntax.tab.c"
     break;
 
 
-#line 1934 "./syntax.tab.c"
+#line 1986 "syntax.tab.c"
 
       default: break;
     }
@@ -1945,11 +1997,10 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
   *++yylsp = yyloc;
@@ -1974,50 +2025,45 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
-      yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
       {
+        yypcontext_t yyctx
+          = {yyssp, yytoken, &yylloc};
         char const *yymsgp = YY_("syntax error");
         int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
         if (yysyntax_error_status == 0)
           yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
+        else if (yysyntax_error_status == -1)
           {
             if (yymsg != yymsgbuf)
               YYSTACK_FREE (yymsg);
-            yymsg = YY_CAST (char *, YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
-            if (!yymsg)
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
               {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
               }
             else
               {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
               }
           }
         yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
       }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
   yyerror_range[1] = yylloc;
-
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2050,6 +2096,7 @@ yyerrorlab:
      label yyerrorlab therefore never appears in user code.  */
   if (0)
     YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2066,13 +2113,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2086,7 +2134,7 @@ yyerrlab1:
 
       yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2097,13 +2145,11 @@ yyerrlab1:
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
   yyerror_range[2] = yylloc;
-  /* Using YYLLOC is tempting, but would change the location of
-     the lookahead.  YYLOC is available though.  */
-  YYLLOC_DEFAULT (yyloc, yyerror_range, 2);
-  *++yylsp = yyloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2114,7 +2160,7 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
 /*-----------------------------------.
@@ -2122,24 +2168,22 @@ yyacceptlab:
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
 
-/*-----------------------------------------------------.
-| yyreturn -- parsing is finished, return the result.  |
-`-----------------------------------------------------*/
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
@@ -2155,20 +2199,19 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[+*yyssp], yyvsp, yylsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
   if (yymsg != yymsgbuf)
     YYSTACK_FREE (yymsg);
-#endif
   return yyresult;
 }
-#line 154 "./syntax.y"
+
+#line 161 "syntax.y"
 
 
 int yyerror(char* msg){
@@ -1,8 +1,8 @@
-/* A Bison parser, made by GNU Bison 3.5.1.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2020 Free Software Foundation,
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
    Inc.
 
    This program is free software: you can redistribute it and/or modify
@@ -16,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -31,8 +31,9 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Undocumented macros, especially those whose name start with YY_,
-   are private implementation details.  Do not rely on them.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
 
 #ifndef YY_YY_SYNTAX_TAB_H_INCLUDED
 # define YY_YY_SYNTAX_TAB_H_INCLUDED
@@ -44,51 +45,56 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    INT = 258,
-    FLOAT = 259,
-    ID = 260,
-    TYPE = 261,
-    COMMA = 262,
-    DOT = 263,
-    SEMI = 264,
-    RELOP = 265,
-    ASSIGNOP = 266,
-    PLUS = 267,
-    MINUS = 268,
-    STAR = 269,
-    DIV = 270,
-    AND = 271,
-    OR = 272,
-    NOT = 273,
-    LP = 274,
-    RP = 275,
-    LB = 276,
-    RB = 277,
-    LC = 278,
-    RC = 279,
-    IF = 280,
-    ELSE = 281,
-    WHILE = 282,
-    STRUCT = 283,
-    RETURN = 284,
-    LOWER_THAN_ELSE = 285
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "$end"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    INT = 258,                     /* INT  */
+    FLOAT = 259,                   /* FLOAT  */
+    ID = 260,                      /* ID  */
+    TYPE = 261,                    /* TYPE  */
+    COMMA = 262,                   /* COMMA  */
+    DOT = 263,                     /* DOT  */
+    SEMI = 264,                    /* SEMI  */
+    RELOP = 265,                   /* RELOP  */
+    ASSIGNOP = 266,                /* ASSIGNOP  */
+    PLUS = 267,                    /* PLUS  */
+    MINUS = 268,                   /* MINUS  */
+    STAR = 269,                    /* STAR  */
+    DIV = 270,                     /* DIV  */
+    AND = 271,                     /* AND  */
+    OR = 272,                      /* OR  */
+    NOT = 273,                     /* NOT  */
+    LP = 274,                      /* LP  */
+    RP = 275,                      /* RP  */
+    LB = 276,                      /* LB  */
+    RB = 277,                      /* RB  */
+    LC = 278,                      /* LC  */
+    RC = 279,                      /* RC  */
+    IF = 280,                      /* IF  */
+    ELSE = 281,                    /* ELSE  */
+    WHILE = 282,                   /* WHILE  */
+    STRUCT = 283,                  /* STRUCT  */
+    RETURN = 284,                  /* RETURN  */
+    LOWER_THAN_ELSE = 285          /* LOWER_THAN_ELSE  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 union YYSTYPE
 {
-#line 13 "./syntax.y"
+#line 20 "syntax.y"
 
     pNode node; 
 
-#line 92 "./syntax.tab.h"
+#line 98 "syntax.tab.h"
 
 };
 typedef union YYSTYPE YYSTYPE;
@@ -113,6 +119,8 @@ struct YYLTYPE
 
 extern YYSTYPE yylval;
 extern YYLTYPE yylloc;
+
 int yyparse (void);
 
+
 #endif /* !YY_YY_SYNTAX_TAB_H_INCLUDED  */
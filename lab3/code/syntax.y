@@ -4,10 +4,17 @@
     #include"lex.yy.c"
     extern boolean synError;
     pNode root;
-    #define YYERROR_VERBOSE 1
+    Arena treeArena;
+    // 右递归的列表(DefList/StmtList)会压很深的栈，默认的10000不够
+    #define YYMAXDEPTH 1000000
 
 %}
 
+// bison 3.6以后不认YYERROR_VERBOSE了，出错信息要带上期望的记号得这样写；
+// 文件结束也改叫"end of file"了，这里改回原来的$end
+%define parse.error verbose
+%token YYEOF 0 "$end"
+
 // types
 
 %union{
@@ -60,96 +67,96 @@
     
 %%
 // High-level Definitions
-Program:            ExtDefList                              { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Program", 1, $1); root = $$; }
+Program:            ExtDefList                              { $$ = newNode(@$.first_line, SYM_PROGRAM, PROD_PROGRAM, 1, $1); root = $$; }
     ; 
-ExtDefList:         ExtDef ExtDefList                       { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ExtDefList", 2, $1, $2); }
+ExtDefList:         ExtDef ExtDefList                       { $$ = newNode(@$.first_line, SYM_EXT_DEF_LIST, PROD_EXT_DEF_LIST, 2, $1, $2); }
     |                                                       { $$ = NULL; } 
     ; 
-ExtDef:             Specifier ExtDecList SEMI               { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ExtDef", 3, $1, $2, $3); }
-    |               Specifier SEMI                          { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ExtDef", 2, $1, $2); }
-    |               Specifier FunDec CompSt                 { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ExtDef", 3, $1, $2, $3); }
+ExtDef:             Specifier ExtDecList SEMI               { $$ = newNode(@$.first_line, SYM_EXT_DEF, PROD_EXT_DEF_VAR, 3, $1, $2, $3); }
+    |               Specifier SEMI                          { $$ = newNode(@$.first_line, SYM_EXT_DEF, PROD_EXT_DEF_TYPE, 2, $1, $2); }
+    |               Specifier FunDec CompSt                 { $$ = newNode(@$.first_line, SYM_EXT_DEF, PROD_EXT_DEF_FUNC, 3, $1, $2, $3); }
     |               error SEMI                              { synError = TRUE; }
     ; 
-ExtDecList:         VarDec                                  { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ExtDecList", 1, $1); }
-    |               VarDec COMMA ExtDecList                 { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ExtDecList", 3, $1, $2, $3); }
+ExtDecList:         VarDec                                  { $$ = newNode(@$.first_line, SYM_EXT_DEC_LIST, PROD_EXT_DEC_LIST_ONE, 1, $1); }
+    |               VarDec COMMA ExtDecList                 { $$ = newNode(@$.first_line, SYM_EXT_DEC_LIST, PROD_EXT_DEC_LIST_MORE, 3, $1, $2, $3); }
     ; 
 
 // Specifiers
-Specifier:          TYPE                                    { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Specifier", 1, $1); }
-    |               StructSpecifier                         { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Specifier", 1, $1); }
+Specifier:          TYPE                                    { $$ = newNode(@$.first_line, SYM_SPECIFIER, PROD_SPECIFIER_TYPE, 1, $1); }
+    |               StructSpecifier                         { $$ = newNode(@$.first_line, SYM_SPECIFIER, PROD_SPECIFIER_STRUCT, 1, $1); }
     ; 
-StructSpecifier:    STRUCT OptTag LC DefList RC             { $$ = newNode(@$.first_line, NOT_A_TOKEN, "StructSpecifier", 5, $1, $2, $3, $4, $5); }
-    |               STRUCT Tag                              { $$ = newNode(@$.first_line, NOT_A_TOKEN, "StructSpecifier", 2, $1, $2); }
+StructSpecifier:    STRUCT OptTag LC DefList RC             { $$ = newNode(@$.first_line, SYM_STRUCT_SPECIFIER, PROD_STRUCT_DEF, 5, $1, $2, $3, $4, $5); }
+    |               STRUCT Tag                              { $$ = newNode(@$.first_line, SYM_STRUCT_SPECIFIER, PROD_STRUCT_TAG, 2, $1, $2); }
     ; 
-OptTag:             ID                                      { $$ = newNode(@$.first_line, NOT_A_TOKEN, "OptTag", 1, $1); }
+OptTag:             ID                                      { $$ = newNode(@$.first_line, SYM_OPT_TAG, PROD_OPT_TAG, 1, $1); }
     |                                                       { $$ = NULL; }
     ; 
-Tag:                ID                                      { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Tag", 1, $1); }
+Tag:                ID                                      { $$ = newNode(@$.first_line, SYM_TAG, PROD_TAG, 1, $1); }
     ; 
 
 // Declarators
-VarDec:             ID                                      { $$ = newNode(@$.first_line, NOT_A_TOKEN, "VarDec", 1, $1); }
-    |               VarDec LB INT RB                        { $$ = newNode(@$.first_line, NOT_A_TOKEN, "VarDec", 4, $1, $2, $3, $4); }
+VarDec:             ID                                      { $$ = newNode(@$.first_line, SYM_VAR_DEC, PROD_VAR_DEC_ID, 1, $1); }
+    |               VarDec LB INT RB                        { $$ = newNode(@$.first_line, SYM_VAR_DEC, PROD_VAR_DEC_ARRAY, 4, $1, $2, $3, $4); }
     |               error RB                                { synError = TRUE; }
     ; 
-FunDec:             ID LP VarList RP                        { $$ = newNode(@$.first_line, NOT_A_TOKEN, "FunDec", 4, $1, $2, $3, $4); }
-    |               ID LP RP                                { $$ = newNode(@$.first_line, NOT_A_TOKEN, "FunDec", 3, $1, $2, $3); }
+FunDec:             ID LP VarList RP                        { $$ = newNode(@$.first_line, SYM_FUN_DEC, PROD_FUN_DEC_ARGS, 4, $1, $2, $3, $4); }
+    |               ID LP RP                                { $$ = newNode(@$.first_line, SYM_FUN_DEC, PROD_FUN_DEC_NO_ARGS, 3, $1, $2, $3); }
     |               error RP                                { synError = TRUE; }
     ; 
-VarList:            ParamDec COMMA VarList                  { $$ = newNode(@$.first_line, NOT_A_TOKEN, "VarList", 3, $1, $2, $3); }
-    |               ParamDec                                { $$ = newNode(@$.first_line, NOT_A_TOKEN, "VarList", 1, $1); }
+VarList:            ParamDec COMMA VarList                  { $$ = newNode(@$.first_line, SYM_VAR_LIST, PROD_VAR_LIST_MORE, 3, $1, $2, $3); }
+    |               ParamDec                                { $$ = newNode(@$.first_line, SYM_VAR_LIST, PROD_VAR_LIST_ONE, 1, $1); }
     ; 
-ParamDec:           Specifier VarDec                        { $$ = newNode(@$.first_line, NOT_A_TOKEN, "ParamDec", 2, $1, $2); }
+ParamDec:           Specifier VarDec                        { $$ = newNode(@$.first_line, SYM_PARAM_DEC, PROD_PARAM_DEC, 2, $1, $2); }
     ; 
 // Statements
-CompSt:             LC DefList StmtList RC                  { $$ = newNode(@$.first_line, NOT_A_TOKEN, "CompSt", 4, $1, $2, $3, $4); }
+CompSt:             LC DefList StmtList RC                  { $$ = newNode(@$.first_line, SYM_COMP_ST, PROD_COMP_ST, 4, $1, $2, $3, $4); }
     |               error RC                                { synError = TRUE; }
     ; 
-StmtList:           Stmt StmtList                           { $$ = newNode(@$.first_line, NOT_A_TOKEN, "StmtList", 2, $1, $2); }
+StmtList:           Stmt StmtList                           { $$ = newNode(@$.first_line, SYM_STMT_LIST, PROD_STMT_LIST, 2, $1, $2); }
     |                                                       { $$ = NULL; }
     ; 
-Stmt:               Exp SEMI                                { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Stmt", 2, $1, $2); }
-    |               CompSt                                  { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Stmt", 1, $1); }
-    |               RETURN Exp SEMI                         { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Stmt", 3, $1, $2, $3); }    
-    |               IF LP Exp RP Stmt %prec LOWER_THAN_ELSE { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Stmt", 5, $1, $2, $3, $4, $5); }
-    |               IF LP Exp RP Stmt ELSE Stmt             { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Stmt", 7, $1, $2, $3, $4, $5, $6, $7); }
-    |               WHILE LP Exp RP Stmt                    { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Stmt", 5, $1, $2, $3, $4, $5); }
+Stmt:               Exp SEMI                                { $$ = newNode(@$.first_line, SYM_STMT, PROD_STMT_EXP, 2, $1, $2); }
+    |               CompSt                                  { $$ = newNode(@$.first_line, SYM_STMT, PROD_STMT_COMP_ST, 1, $1); }
+    |               RETURN Exp SEMI                         { $$ = newNode(@$.first_line, SYM_STMT, PROD_STMT_RETURN, 3, $1, $2, $3); }    
+    |               IF LP Exp RP Stmt %prec LOWER_THAN_ELSE { $$ = newNode(@$.first_line, SYM_STMT, PROD_STMT_IF, 5, $1, $2, $3, $4, $5); }
+    |               IF LP Exp RP Stmt ELSE Stmt             { $$ = newNode(@$.first_line, SYM_STMT, PROD_STMT_IF_ELSE, 7, $1, $2, $3, $4, $5, $6, $7); }
+    |               WHILE LP Exp RP Stmt                    { $$ = newNode(@$.first_line, SYM_STMT, PROD_STMT_WHILE, 5, $1, $2, $3, $4, $5); }
     |               error SEMI                              { synError = TRUE; }
     ; 
 // Local Definitions
-DefList:            Def DefList                             { $$ = newNode(@$.first_line, NOT_A_TOKEN, "DefList", 2, $1, $2); }
+DefList:            Def DefList                             { $$ = newNode(@$.first_line, SYM_DEF_LIST, PROD_DEF_LIST, 2, $1, $2); }
     |                                                       { $$ = NULL; }
     ;     
-Def:                Specifier DecList SEMI                  { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Def", 3, $1, $2, $3); }
+Def:                Specifier DecList SEMI                  { $$ = newNode(@$.first_line, SYM_DEF, PROD_DEF, 3, $1, $2, $3); }
     ; 
-DecList:            Dec                                     { $$ = newNode(@$.first_line, NOT_A_TOKEN, "DecList", 1, $1); }
-    |               Dec COMMA DecList                       { $$ = newNode(@$.first_line, NOT_A_TOKEN, "DecList", 3, $1, $2, $3); }
+DecList:            Dec                                     { $$ = newNode(@$.first_line, SYM_DEC_LIST, PROD_DEC_LIST_ONE, 1, $1); }
+    |               Dec COMMA DecList                       { $$ = newNode(@$.first_line, SYM_DEC_LIST, PROD_DEC_LIST_MORE, 3, $1, $2, $3); }
     ; 
-Dec:                VarDec                                  { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Dec", 1, $1); }
-    |               VarDec ASSIGNOP Exp                     { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Dec", 3, $1, $2, $3); }
+Dec:                VarDec                                  { $$ = newNode(@$.first_line, SYM_DEC, PROD_DEC, 1, $1); }
+    |               VarDec ASSIGNOP Exp                     { $$ = newNode(@$.first_line, SYM_DEC, PROD_DEC_INIT, 3, $1, $2, $3); }
     ; 
 //7.1.7 Expressions
-Exp:                Exp ASSIGNOP Exp                        { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp AND Exp                             { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp OR Exp                              { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp RELOP Exp                           { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp PLUS Exp                            { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp MINUS Exp                           { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp STAR Exp                            { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp DIV Exp                             { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               LP Exp RP                               { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               MINUS Exp                               { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 2, $1, $2); }
-    |               NOT Exp                                 { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 2, $1, $2); }
-    |               ID LP Args RP                           { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 4, $1, $2, $3, $4); }
-    |               ID LP RP                                { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               Exp LB Exp RB                           { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 4, $1, $2, $3, $4); }
-    |               Exp DOT ID                              { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 3, $1, $2, $3); }
-    |               ID                                      { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 1, $1); }
-    |               INT                                     { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 1, $1); }
-    |               FLOAT                                   { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Exp", 1, $1); }
-    ; 
-Args :              Exp COMMA Args                          { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Args", 3, $1, $2, $3); }
-    |               Exp                                     { $$ = newNode(@$.first_line, NOT_A_TOKEN, "Args", 1, $1); }
+Exp:                Exp ASSIGNOP Exp                        { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_ASSIGN, 3, $1, $2, $3); }
+    |               Exp AND Exp                             { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_AND, 3, $1, $2, $3); }
+    |               Exp OR Exp                              { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_OR, 3, $1, $2, $3); }
+    |               Exp RELOP Exp                           { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_RELOP, 3, $1, $2, $3); }
+    |               Exp PLUS Exp                            { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_PLUS, 3, $1, $2, $3); }
+    |               Exp MINUS Exp                           { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_MINUS, 3, $1, $2, $3); }
+    |               Exp STAR Exp                            { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_STAR, 3, $1, $2, $3); }
+    |               Exp DIV Exp                             { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_DIV, 3, $1, $2, $3); }
+    |               LP Exp RP                               { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_PAREN, 3, $1, $2, $3); }
+    |               MINUS Exp                               { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_NEG, 2, $1, $2); }
+    |               NOT Exp                                 { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_NOT, 2, $1, $2); }
+    |               ID LP Args RP                           { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_CALL_ARGS, 4, $1, $2, $3, $4); }
+    |               ID LP RP                                { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_CALL, 3, $1, $2, $3); }
+    |               Exp LB Exp RB                           { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_INDEX, 4, $1, $2, $3, $4); }
+    |               Exp DOT ID                              { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_DOT, 3, $1, $2, $3); }
+    |               ID                                      { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_ID, 1, $1); }
+    |               INT                                     { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_INT, 1, $1); }
+    |               FLOAT                                   { $$ = newNode(@$.first_line, SYM_EXP, PROD_EXP_FLOAT, 1, $1); }
+    ; 
+Args :              Exp COMMA Args                          { $$ = newNode(@$.first_line, SYM_ARGS, PROD_ARGS_MORE, 3, $1, $2, $3); }
+    |               Exp                                     { $$ = newNode(@$.first_line, SYM_ARGS, PROD_ARGS_ONE, 1, $1); }
     ; 
 %%
 
@@ -0,0 +1,510 @@
+#include "cfg.h"
+#include "intern.h"
+#include "optimize.h"
+#include "vm.h"
+
+// 装载后的指令，操作数都是帧里的槽位。GCC下用直接线索化：每条指令
+// 记着处理它的标签地址，执行完直接goto下一条的，不经过switch。
+// 其他编译器或者定义了VM_SWITCH时退回到循环+switch
+#if defined(__GNUC__) && !defined(VM_SWITCH)
+#define VM_THREADED
+#endif
+typedef enum _vmOp {
+    VM_ASSIGN,      // x := y
+    VM_ADD,         // x := y + z
+    VM_SUB,
+    VM_MUL,
+    VM_DIV,
+    VM_GET_ADDR,    // x := 帧的内存基址 + y
+    VM_READ_ADDR,   // x := *y
+    VM_WRITE_ADDR,  // *x := y
+    VM_GOTO,        // 跳到x
+    VM_LT,          // IF x < y GOTO z，下面五个同理
+    VM_LE,
+    VM_GT,
+    VM_GE,
+    VM_EQ,
+    VM_NE,
+    VM_RETURN,
+    VM_DEC,         // 内存在进入函数时就分配了，这里什么都不做
+    VM_ARG,
+    VM_CALL,        // x := CALL 函数y
+    VM_READ,
+    VM_WRITE,
+    VM_END,         // 函数末尾没有RETURN时返回0，不算执行的指令
+    VM_OP_NUM,
+} VmOp;
+
+static char* vmOpNames[] = {
+    "ASSIGN", "ADD", "SUB", "MUL", "DIV", "GET_ADDR", "READ_ADDR",
+    "WRITE_ADDR", "GOTO", "IF <", "IF <=", "IF >", "IF >=", "IF ==",
+    "IF !=", "RETURN", "DEC", "ARG", "CALL", "READ", "WRITE", "END",
+};
+
+typedef struct _vmCode {
+    const void* handler;
+    VmOp op;
+    int x, y, z;
+} VmCode;
+
+typedef struct _vmFunc {
+    char* name;
+    int entry;       // 第一条指令的下标
+    int paramNum;
+    int* params;     // 形参的槽位
+    int frameSize;   // 槽位个数，常量也占槽位
+    int* frame;      // 帧的初值：变量和临时变量是0，常量槽放着常量
+    int memSize;     // DEC的总字节数
+} VmFunc;
+
+static VmCode* codes;
+static int codeNum;
+static VmFunc* funcs;
+static int funcNum;
+static long long* execCounts;  // 每条指令执行的次数
+
+// 装载用的表，都以函数下标+1做时间戳
+static int* slotStamp;   // valueIndex -> 槽位
+static int* slotOf;
+static int* memStamp;    // valueIndex -> DEC的内存在帧里的偏移
+static int* memOf;
+static int* constStamp;  // 操作数下标 -> 常量的槽位
+static int* constOf;
+static int* labelPc;
+static int curStamp;
+static VmFunc* curFn;
+static int slotCap;
+
+static int findFunction(char* name) {
+    for (int f = 0; f < funcNum; f++)
+        if (funcs[f].name == name) return f;
+    return -1;
+}
+
+static int addSlot(int value) {
+    if (curFn->frameSize == slotCap) {
+        slotCap = slotCap ? slotCap * 2 : 64;
+        curFn->frame = (int*)realloc(curFn->frame, sizeof(int) * slotCap);
+        assert(curFn->frame != NULL);
+    }
+    curFn->frame[curFn->frameSize] = value;
+    return curFn->frameSize++;
+}
+
+static int slot(OperandId id) {
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT) {
+        if (constStamp[id] != curStamp) {
+            constStamp[id] = curStamp;
+            constOf[id] = addSlot(op->u.value);
+        }
+        return constOf[id];
+    }
+    int v = valueIndex(id);
+    assert(v >= 0);
+    if (slotStamp[v] != curStamp) {
+        slotStamp[v] = curStamp;
+        slotOf[v] = addSlot(0);
+    }
+    return slotOf[v];
+}
+
+static VmOp relopOp(OperandId relop) {
+    return VM_LT + getOperand(relop)->u.relop;
+}
+
+// 一个函数的指令，从FUNCTION之后到下一个函数之前
+static boolean loadFunction(pInterCodeList list, int start, int end) {
+    pInterCode ir = list->codes;
+    slotCap = 0;
+    curFn->frame = NULL;
+    curFn->frameSize = 0;
+    curFn->memSize = 0;
+    for (int i = start + 1; i < end; i++) {
+        if (ir[i].kind != IR_DEC) continue;
+        int v = valueIndex(ir[i].u.dec.op);
+        memStamp[v] = curStamp;
+        memOf[v] = curFn->memSize;
+        curFn->memSize += (ir[i].u.dec.size + 3) & ~3;
+    }
+
+    int i = start + 1;
+    curFn->paramNum = 0;
+    while (i < end && ir[i].kind == IR_PARAM) i++;
+    curFn->params = (int*)malloc(sizeof(int) * (i - start));
+    assert(curFn->params != NULL);
+    for (int k = start + 1; k < i; k++)
+        curFn->params[curFn->paramNum++] = slot(ir[k].u.oneOp.op);
+
+    for (; i < end; i++) {
+        pInterCode code = &ir[i];
+        if (code->kind == IR_LABEL) continue;
+        VmCode* c = &codes[codeNum++];
+        c->x = c->y = c->z = 0;
+        switch (code->kind) {
+            case IR_ASSIGN:
+            case IR_READ_ADDR:
+            case IR_WRITE_ADDR:
+                c->op = code->kind == IR_ASSIGN      ? VM_ASSIGN
+                        : code->kind == IR_READ_ADDR ? VM_READ_ADDR
+                                                     : VM_WRITE_ADDR;
+                c->x = slot(code->u.assign.left);
+                c->y = slot(code->u.assign.right);
+                break;
+            case IR_GET_ADDR: {
+                int v = valueIndex(code->u.assign.right);
+                if (v < 0 || memStamp[v] != curStamp) {
+                    fprintf(stderr, "run: %s takes the address of a variable "
+                            "without DEC\n", curFn->name);
+                    return FALSE;
+                }
+                c->op = VM_GET_ADDR;
+                c->x = slot(code->u.assign.left);
+                c->y = memOf[v];
+                break;
+            }
+            case IR_ADD:
+            case IR_SUB:
+            case IR_MUL:
+            case IR_DIV:
+                c->op = VM_ADD + (code->kind - IR_ADD);
+                c->x = slot(code->u.binOp.result);
+                c->y = slot(code->u.binOp.op1);
+                c->z = slot(code->u.binOp.op2);
+                break;
+            case IR_GOTO:
+                c->op = VM_GOTO;
+                c->x = labelPc[labelNo(code->u.oneOp.op)];
+                break;
+            case IR_IF_GOTO:
+                c->op = relopOp(code->u.ifGoto.relop);
+                c->x = slot(code->u.ifGoto.x);
+                c->y = slot(code->u.ifGoto.y);
+                c->z = labelPc[labelNo(code->u.ifGoto.z)];
+                break;
+            case IR_CALL: {
+                c->op = VM_CALL;
+                c->x = slot(code->u.assign.left);
+                c->y = findFunction(getOperand(code->u.assign.right)->u.name);
+                if (c->y < 0) {
+                    fprintf(stderr, "run: undefined function %s\n",
+                            getOperand(code->u.assign.right)->u.name);
+                    return FALSE;
+                }
+                break;
+            }
+            case IR_DEC:
+                c->op = VM_DEC;
+                break;
+            case IR_PARAM:
+                fprintf(stderr, "run: PARAM in the body of %s\n", curFn->name);
+                return FALSE;
+            default:
+                c->op = code->kind == IR_RETURN ? VM_RETURN
+                        : code->kind == IR_ARG  ? VM_ARG
+                        : code->kind == IR_READ ? VM_READ
+                                                : VM_WRITE;
+                c->x = slot(code->u.oneOp.op);
+                break;
+        }
+    }
+    codes[codeNum].op = VM_END;
+    codes[codeNum].x = codes[codeNum].y = codes[codeNum].z = 0;
+    codeNum++;
+    if (curFn->frameSize == 0) addSlot(0);
+    return TRUE;
+}
+
+static boolean load(pInterCodeList list) {
+    // 先排好指令的下标：标签和PARAM不占位置，每个函数末尾多一条END
+    labelPc = (int*)malloc(sizeof(int) * list->labelNum);
+    assert(labelPc != NULL);
+    funcNum = 0;
+    int pc = 0;
+    for (int i = 0; i < list->codeNum; i++) {
+        pInterCode code = &list->codes[i];
+        if (code->kind == IR_FUNCTION) {
+            if (funcNum) pc++;
+            funcNum++;
+        } else if (code->kind == IR_LABEL) {
+            labelPc[labelNo(code->u.oneOp.op)] = pc;
+        } else if (code->kind != IR_PARAM) {
+            pc++;
+        }
+    }
+    if (funcNum) pc++;
+    codes = (VmCode*)malloc(sizeof(VmCode) * (pc + 1));
+    funcs = (VmFunc*)calloc(funcNum + 1, sizeof(VmFunc));
+    assert(codes != NULL && funcs != NULL);
+
+    initValueIndex(list);
+    slotStamp = (int*)calloc(valueNum + 1, sizeof(int));
+    slotOf = (int*)malloc(sizeof(int) * (valueNum + 1));
+    memStamp = (int*)calloc(valueNum + 1, sizeof(int));
+    memOf = (int*)malloc(sizeof(int) * (valueNum + 1));
+    constStamp = (int*)calloc(list->operandNum, sizeof(int));
+    constOf = (int*)malloc(sizeof(int) * list->operandNum);
+    assert(slotStamp && slotOf && memStamp && memOf && constStamp && constOf);
+
+    int f = 0;
+    for (int i = 0; i < list->codeNum; i++)
+        if (list->codes[i].kind == IR_FUNCTION)
+            funcs[f++].name = getOperand(list->codes[i].u.oneOp.op)->u.name;
+    codeNum = 0;
+    boolean ok = TRUE;
+    f = 0;
+    for (int i = 0; ok && i < list->codeNum; i = nextFunction(list, i)) {
+        if (list->codes[i].kind != IR_FUNCTION) continue;
+        curFn = &funcs[f];
+        curStamp = ++f;
+        curFn->entry = codeNum;
+        ok = loadFunction(list, i, nextFunction(list, i));
+    }
+
+    deleteValueIndex();
+    free(slotStamp);
+    free(slotOf);
+    free(memStamp);
+    free(memOf);
+    free(constStamp);
+    free(constOf);
+    free(labelPc);
+    return ok;
+}
+
+static void unload() {
+    for (int f = 0; f < funcNum; f++) {
+        free(funcs[f].params);
+        free(funcs[f].frame);
+    }
+    free(funcs);
+    free(codes);
+    free(execCounts);
+    funcs = NULL;
+    codes = NULL;
+    execCounts = NULL;
+}
+
+typedef struct _vmFrame {
+    int ret;      // 返回后接着执行的指令
+    int fp, mp;   // 调用者的帧和内存基址
+    int dst;      // 调用者接返回值的槽位
+    int memTop;
+    int func;     // 调用者
+} VmFrame;
+
+static void report() {
+    long long byOp[VM_OP_NUM] = {0}, total = 0;
+    for (int i = 0; i < codeNum; i++) byOp[codes[i].op] += execCounts[i];
+    byOp[VM_END] = 0;
+    for (int op = 0; op < VM_OP_NUM; op++) total += byOp[op];
+    fprintf(stderr, "executed: %lld instructions\n", total);
+    if (!optStats) return;
+    for (int op = 0; op < VM_END; op++)
+        if (byOp[op])
+            fprintf(stderr, "  %-10s %lld\n", vmOpNames[op], byOp[op]);
+}
+
+int runInterCode(pInterCodeList list) {
+    if (!load(list)) {
+        unload();
+        return 1;
+    }
+    int mainFunc = findFunction(intern("main"));
+    if (mainFunc < 0) {
+        fprintf(stderr, "run: no main function\n");
+        unload();
+        return 1;
+    }
+    execCounts = (long long*)calloc(codeNum, sizeof(long long));
+    assert(execCounts != NULL);
+
+    int stackCap = 1 << 12, memCap = 1 << 12, frameNum = 0, frameCap = 64;
+    int argNum = 0, argCap = 16;
+    int* stack = (int*)malloc(sizeof(int) * stackCap);
+    int* memory = (int*)malloc(sizeof(int) * memCap);  // 按字存，地址按字节算
+    int* args = (int*)malloc(sizeof(int) * argCap);
+    VmFrame* frames = (VmFrame*)malloc(sizeof(VmFrame) * frameCap);
+    assert(stack && memory && args && frames);
+
+    VmFunc* fn = &funcs[mainFunc];
+    int fpOff = 0, mp = 0, memTop = 0, status = 0;
+    char* error = NULL;
+
+// 进入函数fn：帧放在fpOff，内存从memTop开始
+#define ENTER()                                                              \
+    do {                                                                     \
+        if (fpOff + fn->frameSize > stackCap ||                              \
+            (memTop + fn->memSize) / 4 > memCap) {                           \
+            if (fpOff + fn->frameSize > VM_MAX_STACK ||                      \
+                (memTop + fn->memSize) / 4 > VM_MAX_STACK) {                 \
+                error = "stack overflow";                                    \
+                goto fail;                                                   \
+            }                                                                \
+            while (fpOff + fn->frameSize > stackCap) stackCap *= 2;          \
+            while ((memTop + fn->memSize) / 4 > memCap) memCap *= 2;         \
+            stack = (int*)realloc(stack, sizeof(int) * stackCap);            \
+            memory = (int*)realloc(memory, sizeof(int) * memCap);            \
+            assert(stack != NULL && memory != NULL);                         \
+        }                                                                    \
+        fp = stack + fpOff;                                                  \
+        memcpy(fp, fn->frame, sizeof(int) * fn->frameSize);                  \
+        mp = memTop;                                                         \
+        memset(memory + mp / 4, 0, fn->memSize);                             \
+        memTop += fn->memSize;                                               \
+    } while (0)
+
+#define CHECK_ADDR(a)                                                        \
+    if ((a) < 0 || (a) >= memTop || ((a) & 3)) {                             \
+        error = "invalid address";                                           \
+        goto fail;                                                           \
+    }
+
+#define BRANCH(cond) pc = (cond) ? codes + pc->z : pc + 1
+
+    int* fp;
+    VmCode* pc = codes + fn->entry;
+    ENTER();
+
+#ifdef VM_THREADED
+    static const void* handlers[VM_OP_NUM] = {
+        &&L_ASSIGN, &&L_ADD,    &&L_SUB,    &&L_MUL,    &&L_DIV,
+        &&L_GET_ADDR, &&L_READ_ADDR, &&L_WRITE_ADDR, &&L_GOTO,
+        &&L_LT,     &&L_LE,     &&L_GT,     &&L_GE,     &&L_EQ,
+        &&L_NE,     &&L_RETURN, &&L_DEC,    &&L_ARG,    &&L_CALL,
+        &&L_READ,   &&L_WRITE,  &&L_END,
+    };
+    for (int i = 0; i < codeNum; i++) codes[i].handler = handlers[codes[i].op];
+#define CASE(op) L_##op:
+#define NEXT()                          \
+    do {                                \
+        execCounts[pc - codes]++;       \
+        goto *pc->handler;              \
+    } while (0)
+    NEXT();
+#else
+#define CASE(op) case VM_##op:
+#define NEXT() continue
+    for (;;) {
+        execCounts[pc - codes]++;
+        switch (pc->op) {
+#endif
+
+    CASE(ASSIGN) fp[pc->x] = fp[pc->y]; pc++; NEXT();
+    CASE(ADD) fp[pc->x] = (int)((unsigned)fp[pc->y] + (unsigned)fp[pc->z]); pc++; NEXT();
+    CASE(SUB) fp[pc->x] = (int)((unsigned)fp[pc->y] - (unsigned)fp[pc->z]); pc++; NEXT();
+    CASE(MUL) fp[pc->x] = (int)((unsigned)fp[pc->y] * (unsigned)fp[pc->z]); pc++; NEXT();
+    CASE(DIV) {
+        int a = fp[pc->y], b = fp[pc->z];
+        if (b == 0) {
+            error = "division by zero";
+            goto fail;
+        }
+        // INT_MIN / -1 在C里会溢出，按补码回绕
+        fp[pc->x] = b == -1 ? (int)(0u - (unsigned)a) : a / b;
+        pc++;
+        NEXT();
+    }
+    CASE(GET_ADDR) fp[pc->x] = mp + pc->y; pc++; NEXT();
+    CASE(READ_ADDR) {
+        int a = fp[pc->y];
+        CHECK_ADDR(a);
+        fp[pc->x] = memory[a >> 2];
+        pc++;
+        NEXT();
+    }
+    CASE(WRITE_ADDR) {
+        int a = fp[pc->x];
+        CHECK_ADDR(a);
+        memory[a >> 2] = fp[pc->y];
+        pc++;
+        NEXT();
+    }
+    CASE(GOTO) pc = codes + pc->x; NEXT();
+    CASE(LT) BRANCH(fp[pc->x] < fp[pc->y]); NEXT();
+    CASE(LE) BRANCH(fp[pc->x] <= fp[pc->y]); NEXT();
+    CASE(GT) BRANCH(fp[pc->x] > fp[pc->y]); NEXT();
+    CASE(GE) BRANCH(fp[pc->x] >= fp[pc->y]); NEXT();
+    CASE(EQ) BRANCH(fp[pc->x] == fp[pc->y]); NEXT();
+    CASE(NE) BRANCH(fp[pc->x] != fp[pc->y]); NEXT();
+    CASE(DEC) pc++; NEXT();
+    CASE(ARG) {
+        if (argNum == argCap) {
+            argCap *= 2;
+            args = (int*)realloc(args, sizeof(int) * argCap);
+            assert(args != NULL);
+        }
+        args[argNum++] = fp[pc->x];
+        pc++;
+        NEXT();
+    }
+    CASE(CALL) {
+        VmFunc* callee = &funcs[pc->y];
+        if (argNum != callee->paramNum) {
+            error = "wrong number of arguments";
+            goto fail;
+        }
+        if (frameNum == frameCap) {
+            frameCap *= 2;
+            frames = (VmFrame*)realloc(frames, sizeof(VmFrame) * frameCap);
+            assert(frames != NULL);
+        }
+        VmFrame* frame = &frames[frameNum++];
+        frame->ret = pc + 1 - codes;
+        frame->fp = fpOff;
+        frame->mp = mp;
+        frame->dst = pc->x;
+        frame->memTop = memTop;
+        frame->func = fn - funcs;
+        fpOff += fn->frameSize;
+        fn = callee;
+        ENTER();
+        for (int k = 0; k < argNum; k++) fp[fn->params[k]] = args[k];
+        argNum = 0;
+        pc = codes + fn->entry;
+        NEXT();
+    }
+    CASE(READ) {
+        fflush(stdout);
+        if (scanf("%d", &fp[pc->x]) != 1) {
+            error = "READ: no more input";
+            goto fail;
+        }
+        pc++;
+        NEXT();
+    }
+    CASE(WRITE) printf("%d\n", fp[pc->x]); pc++; NEXT();
+    CASE(RETURN)
+    CASE(END) {
+        int value = pc->op == VM_RETURN ? fp[pc->x] : 0;
+        if (frameNum == 0) goto done;
+        VmFrame* frame = &frames[--frameNum];
+        memTop = frame->memTop;
+        mp = frame->mp;
+        fpOff = frame->fp;
+        fp = stack + fpOff;
+        pc = codes + frame->ret;
+        fn = &funcs[frame->func];
+        fp[frame->dst] = value;
+        NEXT();
+    }
+
+#ifndef VM_THREADED
+        }
+    }
+#endif
+
+fail:
+    fflush(stdout);
+    fprintf(stderr, "runtime error in %s: %s\n", fn->name, error);
+    status = 1;
+done:
+    fflush(stdout);
+    report();
+    free(stack);
+    free(memory);
+    free(args);
+    free(frames);
+    unload();
+    return status;
+}
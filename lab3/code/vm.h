@@ -0,0 +1,14 @@
+#ifndef VM_H
+#define VM_H
+#include "inter.h"
+
+// 直接执行中间代码：READ从stdin读，WRITE写到stdout，执行的指令数报到stderr。
+// 装载时标签换成指令下标、变量和常量换成帧里的槽位，DEC的数组和结构体
+// 在进入函数时一次分配好。ARG按执行的先后对应PARAM的先后。
+// 正常结束返回0，运行时出错返回1
+int runInterCode(pInterCodeList list);
+
+// 栈的上限（int的个数），递归太深时报错而不是耗尽内存
+#define VM_MAX_STACK (1 << 26)
+
+#endif
@@ -0,0 +1,458 @@
+#include "backend.h"
+#include "optimize.h"
+
+// 中间代码里的值都是32位int，地址也当int存。DEC出来的数组和结构体不放在
+// 机器栈上，而是放在.bss里另开的数据栈（%r15指着栈顶），静态链接时.bss在
+// 低地址，地址放得进32位。变量和临时变量在帧里各占4字节的槽位，每条指令
+// 用%eax/%ecx/%edx现取现存。帧的布局（相对%rbp）：
+//   -8        进入时的数据栈顶，也就是本帧DEC内存的基址
+//   -12往下   槽位，之后是寄存器参数的暂存区
+//   %rsp往上  第7个起的参数
+// 调用约定是System V：前6个参数在%edi,%esi,%edx,%ecx,%r8d,%r9d，其余的
+// 按顺序放在栈上，返回值在%eax。函数名前加cmm_，免得和运行时的符号冲突
+static FILE* out;
+static int* slotStamp;  // valueIndex -> 槽位，以函数的序号做时间戳
+static int* slotOf;
+static int* memStamp;   // valueIndex -> DEC的内存在本帧里的偏移
+static int* memOf;
+static int curStamp, slotNum, memSize, maxArgs;
+
+static char* argRegs[] = {"%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d"};
+static char* jumpNames[] = {"jl", "jle", "jg", "jge", "je", "jne"};
+
+static int slotOffset(int slot) { return -12 - 4 * slot; }
+static int argOffset(int k) { return slotOffset(slotNum + k); }
+
+static void useSlot(OperandId id) {
+    if (getOperand(id)->kind == OP_CONSTANT) return;
+    int v = valueIndex(id);
+    if (slotStamp[v] == curStamp) return;
+    slotStamp[v] = curStamp;
+    slotOf[v] = slotNum++;
+}
+
+// 操作数的汇编写法，立即数或者槽位；轮流用几块缓冲区，一条指令里可以用两次
+static char* opText(OperandId id) {
+    static char bufs[4][32];
+    static int next = 0;
+    char* buf = bufs[next++ & 3];
+    pOperand op = getOperand(id);
+    if (op->kind == OP_CONSTANT)
+        sprintf(buf, "$%d", op->u.value);
+    else
+        sprintf(buf, "%d(%%rbp)", slotOffset(slotOf[valueIndex(id)]));
+    return buf;
+}
+
+static boolean isConst(OperandId id) {
+    return getOperand(id)->kind == OP_CONSTANT;
+}
+
+// 2的k次幂返回k，否则返回-1
+static int log2Of(OperandId id) {
+    if (!isConst(id)) return -1;
+    int c = getOperand(id)->u.value;
+    if (c <= 1 || (c & (c - 1))) return -1;
+    int k = 0;
+    while ((1 << k) != c) k++;
+    return k;
+}
+
+// 先数槽位、DEC的内存和一次调用最多的参数个数，帧的大小在函数开头就要定下来
+static void layoutFunction(pInterCodeList list, int start, int end) {
+    slotNum = memSize = maxArgs = 0;
+    int args = 0;
+    OperandId* slots[3];
+    for (int i = start + 1; i < end; i++) {
+        pInterCode code = &list->codes[i];
+        int useNum = getUseSlots(code, slots);
+        for (int j = 0; j < useNum; j++) useSlot(*slots[j]);
+        OperandId def = getDef(code);
+        if (def) useSlot(def);
+        if (code->kind == IR_DEC) {
+            int v = valueIndex(code->u.dec.op);
+            memStamp[v] = curStamp;
+            memOf[v] = memSize;
+            memSize += (code->u.dec.size + 3) & ~3;
+        } else if (code->kind == IR_ARG) {
+            if (++args > maxArgs) maxArgs = args;
+        } else if (code->kind == IR_CALL) {
+            args = 0;
+        }
+    }
+}
+
+static void emitEpilogue() {
+    fprintf(out, "\tmovq -8(%%rbp), %%r15\n\tleave\n\tret\n");
+}
+
+static void emitPrologue(pInterCodeList list, int start) {
+    char* name = getOperand(list->codes[start].u.oneOp.op)->u.name;
+    int stackArgs = maxArgs > 6 ? maxArgs - 6 : 0;
+    int frame = 8 + 4 * (slotNum + 6) + 8 * stackArgs;
+    frame = (frame + 15) & ~15;
+    fprintf(out, "\ncmm_%s:\n\tpushq %%rbp\n\tmovq %%rsp, %%rbp\n", name);
+    fprintf(out,
+            "\tsubq $%d, %%rsp\n\tcmpq $__cmm_stack+256, %%rsp\n"
+            "\tjb __cmm_overflow\n",
+            frame);
+    // 槽位清零，和解释器一样没赋过值的变量读出来是0。参数寄存器还没存，不能碰
+    if (slotNum) {
+        int bytes = (4 * slotNum + 7) & ~7;
+        fprintf(out,
+                "\tleaq %d(%%rbp), %%r10\n\tleaq -8(%%rbp), %%r11\n"
+                "1:\tmovq $0, (%%r10)\n\taddq $8, %%r10\n"
+                "\tcmpq %%r11, %%r10\n\tjb 1b\n",
+                -8 - bytes);
+    }
+    int k = 0;
+    for (int i = start + 1; list->codes[i].kind == IR_PARAM; i++, k++) {
+        char* dst = opText(list->codes[i].u.oneOp.op);
+        if (k < 6) {
+            fprintf(out, "\tmovl %s, %s\n", argRegs[k], dst);
+        } else {
+            fprintf(out, "\tmovl %d(%%rbp), %%eax\n\tmovl %%eax, %s\n",
+                    16 + 8 * (k - 6), dst);
+        }
+    }
+    fprintf(out, "\tmovq %%r15, -8(%%rbp)\n");
+    if (memSize) {
+        fprintf(out,
+                "\taddq $%d, %%r15\n\tcmpq $__cmm_data+%d, %%r15\n"
+                "\tja __cmm_overflow\n"
+                "\tmovq -8(%%rbp), %%rdi\n\tmovl $%d, %%ecx\n"
+                "\txorl %%eax, %%eax\n\trep stosl\n",
+                memSize, X86_DATA_STACK, memSize / 4);
+    }
+}
+
+static void emitBinOp(pInterCode code) {
+    OperandId x = code->u.binOp.result, y = code->u.binOp.op1,
+              z = code->u.binOp.op2;
+    char *dst = opText(x), *a = opText(y), *b = opText(z);
+    int k;
+    switch (code->kind) {
+        case IR_ADD:
+            fprintf(out, "\tmovl %s, %%eax\n\taddl %s, %%eax\n", a, b);
+            break;
+        case IR_SUB:
+            fprintf(out, "\tmovl %s, %%eax\n\tsubl %s, %%eax\n", a, b);
+            break;
+        case IR_MUL:
+            // 中间代码没有移位，乘2的幂在这里换成左移
+            if ((k = log2Of(z)) >= 0)
+                fprintf(out, "\tmovl %s, %%eax\n\tshll $%d, %%eax\n", a, k);
+            else if ((k = log2Of(y)) >= 0)
+                fprintf(out, "\tmovl %s, %%eax\n\tshll $%d, %%eax\n", b, k);
+            else
+                fprintf(out, "\tmovl %s, %%eax\n\timull %s, %%eax\n", a, b);
+            break;
+        case IR_DIV:
+            fprintf(out, "\tmovl %s, %%eax\n", a);
+            if ((k = log2Of(z)) >= 0) {
+                // 有符号除法向0取整：负数先加上2^k-1再算术右移
+                fprintf(out,
+                        "\tmovl %%eax, %%edx\n\tsarl $31, %%edx\n"
+                        "\tshrl $%d, %%edx\n\taddl %%edx, %%eax\n"
+                        "\tsarl $%d, %%eax\n",
+                        32 - k, k);
+            } else if (isConst(z) && getOperand(z)->u.value != 0 &&
+                       getOperand(z)->u.value != -1) {
+                fprintf(out, "\tmovl %s, %%ecx\n\tcltd\n\tidivl %%ecx\n", b);
+            } else {
+                // 除数为0报错；INT_MIN / -1 会让idiv出异常，和解释器一样按补码回绕
+                fprintf(out,
+                        "\tmovl %s, %%ecx\n\ttestl %%ecx, %%ecx\n"
+                        "\tje __cmm_div0\n\tcmpl $-1, %%ecx\n\tjne 1f\n"
+                        "\tnegl %%eax\n\tjmp 2f\n1:\tcltd\n\tidivl %%ecx\n2:\n",
+                        b);
+            }
+            break;
+        default:
+            assert(0);
+    }
+    fprintf(out, "\tmovl %%eax, %s\n", dst);
+}
+
+static void emitCode(pInterCode code, int* args) {
+    switch (code->kind) {
+        case IR_LABEL:
+            fprintf(out, ".L%d:\n", labelNo(code->u.oneOp.op));
+            break;
+        case IR_ASSIGN:
+            if (isConst(code->u.assign.right))
+                fprintf(out, "\tmovl %s, %s\n", opText(code->u.assign.right),
+                        opText(code->u.assign.left));
+            else
+                fprintf(out, "\tmovl %s, %%eax\n\tmovl %%eax, %s\n",
+                        opText(code->u.assign.right),
+                        opText(code->u.assign.left));
+            break;
+        case IR_ADD:
+        case IR_SUB:
+        case IR_MUL:
+        case IR_DIV:
+            emitBinOp(code);
+            break;
+        case IR_GET_ADDR: {
+            int v = valueIndex(code->u.assign.right);
+            assert(v >= 0 && memStamp[v] == curStamp);
+            fprintf(out, "\tmovq -8(%%rbp), %%rax\n\taddl $%d, %%eax\n",
+                    memOf[v]);
+            fprintf(out, "\tmovl %%eax, %s\n", opText(code->u.assign.left));
+            break;
+        }
+        case IR_READ_ADDR:
+            fprintf(out, "\tmovl %s, %%eax\n\tmovl (%%rax), %%eax\n",
+                    opText(code->u.assign.right));
+            fprintf(out, "\tmovl %%eax, %s\n", opText(code->u.assign.left));
+            break;
+        case IR_WRITE_ADDR:
+            fprintf(out, "\tmovl %s, %%eax\n\tmovl %s, %%ecx\n",
+                    opText(code->u.assign.left), opText(code->u.assign.right));
+            fprintf(out, "\tmovl %%ecx, (%%rax)\n");
+            break;
+        case IR_GOTO:
+            fprintf(out, "\tjmp .L%d\n", labelNo(code->u.oneOp.op));
+            break;
+        case IR_IF_GOTO:
+            fprintf(out, "\tmovl %s, %%eax\n\tcmpl %s, %%eax\n\t%s .L%d\n",
+                    opText(code->u.ifGoto.x), opText(code->u.ifGoto.y),
+                    jumpNames[getOperand(code->u.ifGoto.relop)->u.relop],
+                    labelNo(code->u.ifGoto.z));
+            break;
+        case IR_RETURN:
+            fprintf(out, "\tmovl %s, %%eax\n", opText(code->u.oneOp.op));
+            emitEpilogue();
+            break;
+        case IR_ARG:
+            fprintf(out, "\tmovl %s, %%eax\n", opText(code->u.oneOp.op));
+            if (*args < 6)
+                fprintf(out, "\tmovl %%eax, %d(%%rbp)\n", argOffset(*args));
+            else
+                fprintf(out, "\tmovl %%eax, %d(%%rsp)\n", 8 * (*args - 6));
+            (*args)++;
+            break;
+        case IR_CALL:
+            for (int k = 0; k < *args && k < 6; k++)
+                fprintf(out, "\tmovl %d(%%rbp), %s\n", argOffset(k), argRegs[k]);
+            fprintf(out, "\tcall cmm_%s\n\tmovl %%eax, %s\n",
+                    getOperand(code->u.assign.right)->u.name,
+                    opText(code->u.assign.left));
+            *args = 0;
+            break;
+        case IR_READ:
+            fprintf(out, "\tcall __cmm_read\n\tmovl %%eax, %s\n",
+                    opText(code->u.oneOp.op));
+            break;
+        case IR_WRITE:
+            fprintf(out, "\tmovl %s, %%edi\n\tcall __cmm_write\n",
+                    opText(code->u.oneOp.op));
+            break;
+        default:  // DEC的内存在开头就分配了，PARAM在开头存好了
+            break;
+    }
+}
+
+// 运行时：入口、按十进制读写整数（带缓冲）、运行时错误
+static char* runtime =
+    "\t.text\n"
+    "\t.globl _start\n"
+    "_start:\n"
+    "\tmovq $__cmm_stack_end, %rsp\n"
+    "\tmovq $__cmm_data, %r15\n"
+    "\tcall cmm_main\n"
+    "\tcall __cmm_flush\n"
+    "\tmovl $60, %eax\n"
+    "\txorl %edi, %edi\n"
+    "\tsyscall\n"
+    "\n"
+    "__cmm_flush:\n"
+    "\tmovq __cmm_outlen(%rip), %rdx\n"
+    "\tleaq __cmm_outbuf(%rip), %rsi\n"
+    "1:\ttestq %rdx, %rdx\n"
+    "\tjz 2f\n"
+    "\tmovl $1, %eax\n"
+    "\tmovl $1, %edi\n"
+    "\tsyscall\n"
+    "\ttestq %rax, %rax\n"
+    "\tjle 2f\n"
+    "\taddq %rax, %rsi\n"
+    "\tsubq %rax, %rdx\n"
+    "\tjmp 1b\n"
+    "2:\tmovq $0, __cmm_outlen(%rip)\n"
+    "\tret\n"
+    "\n"
+    "__cmm_write:\n"
+    "\tcmpq $4064, __cmm_outlen(%rip)\n"
+    "\tjb 1f\n"
+    "\tpushq %rdi\n"
+    "\tcall __cmm_flush\n"
+    "\tpopq %rdi\n"
+    "1:\tmovl %edi, %eax\n"
+    "\tmovl %edi, %ecx\n"
+    "\tleaq __cmm_tmp+16(%rip), %rsi\n"
+    "\ttestl %eax, %eax\n"
+    "\tjns 2f\n"
+    "\tnegl %eax\n"
+    "2:\tmovl $10, %r9d\n"
+    "3:\txorl %edx, %edx\n"
+    "\tdivl %r9d\n"
+    "\taddb $48, %dl\n"
+    "\tdecq %rsi\n"
+    "\tmovb %dl, (%rsi)\n"
+    "\ttestl %eax, %eax\n"
+    "\tjnz 3b\n"
+    "\ttestl %ecx, %ecx\n"
+    "\tjns 4f\n"
+    "\tdecq %rsi\n"
+    "\tmovb $45, (%rsi)\n"
+    "4:\tleaq __cmm_outbuf(%rip), %rdi\n"
+    "\taddq __cmm_outlen(%rip), %rdi\n"
+    "\tleaq __cmm_tmp+16(%rip), %rdx\n"
+    "5:\tmovb (%rsi), %al\n"
+    "\tmovb %al, (%rdi)\n"
+    "\tincq %rsi\n"
+    "\tincq %rdi\n"
+    "\tcmpq %rdx, %rsi\n"
+    "\tjb 5b\n"
+    "\tmovb $10, (%rdi)\n"
+    "\tincq %rdi\n"
+    "\tleaq __cmm_outbuf(%rip), %rax\n"
+    "\tsubq %rax, %rdi\n"
+    "\tmovq %rdi, __cmm_outlen(%rip)\n"
+    "\tret\n"
+    "\n"
+    "__cmm_getc:\n"
+    "\tmovq __cmm_inpos(%rip), %rax\n"
+    "\tcmpq __cmm_inlen(%rip), %rax\n"
+    "\tjb 1f\n"
+    "\txorl %eax, %eax\n"
+    "\txorl %edi, %edi\n"
+    "\tleaq __cmm_inbuf(%rip), %rsi\n"
+    "\tmovl $4096, %edx\n"
+    "\tsyscall\n"
+    "\ttestq %rax, %rax\n"
+    "\tjle 2f\n"
+    "\tmovq %rax, __cmm_inlen(%rip)\n"
+    "\txorl %eax, %eax\n"
+    "1:\tleaq __cmm_inbuf(%rip), %rdx\n"
+    "\tmovzbl (%rdx,%rax), %edx\n"
+    "\tincq %rax\n"
+    "\tmovq %rax, __cmm_inpos(%rip)\n"
+    "\tmovl %edx, %eax\n"
+    "\tret\n"
+    "2:\tmovl $-1, %eax\n"
+    "\tret\n"
+    "\n"
+    "__cmm_read:\n"
+    "\tcall __cmm_flush\n"
+    "\txorl %r8d, %r8d\n"
+    "\txorl %r9d, %r9d\n"
+    "\txorl %r10d, %r10d\n"
+    "1:\tcall __cmm_getc\n"
+    "\tcmpl $-1, %eax\n"
+    "\tje 9f\n"
+    "\tcmpl $32, %eax\n"
+    "\tjbe 1b\n"
+    "\tcmpl $45, %eax\n"
+    "\tjne 3f\n"
+    "\tmovl $1, %r8d\n"
+    "2:\tcall __cmm_getc\n"
+    "3:\tsubl $48, %eax\n"
+    "\tcmpl $9, %eax\n"
+    "\tja 4f\n"
+    "\timull $10, %r9d\n"
+    "\taddl %eax, %r9d\n"
+    "\tmovl $1, %r10d\n"
+    "\tjmp 2b\n"
+    "4:\ttestl %r10d, %r10d\n"
+    "\tjz 9f\n"
+    "\tmovl %r9d, %eax\n"
+    "\ttestl %r8d, %r8d\n"
+    "\tjz 5f\n"
+    "\tnegl %eax\n"
+    "5:\tret\n"
+    "9:\tleaq __cmm_msg_read(%rip), %rsi\n"
+    "\tmovl $__cmm_msg_div0-__cmm_msg_read, %edx\n"
+    "\tjmp __cmm_error\n"
+    "\n"
+    "__cmm_div0:\n"
+    "\tleaq __cmm_msg_div0(%rip), %rsi\n"
+    "\tmovl $__cmm_msg_overflow-__cmm_msg_div0, %edx\n"
+    "\tjmp __cmm_error\n"
+    "__cmm_overflow:\n"
+    "\tmovq $__cmm_stack_end, %rsp\n"
+    "\tleaq __cmm_msg_overflow(%rip), %rsi\n"
+    "\tmovl $__cmm_msg_end-__cmm_msg_overflow, %edx\n"
+    "__cmm_error:\n"
+    "\tpushq %rsi\n"
+    "\tpushq %rdx\n"
+    "\tcall __cmm_flush\n"
+    "\tpopq %rdx\n"
+    "\tpopq %rsi\n"
+    "\tmovl $1, %eax\n"
+    "\tmovl $2, %edi\n"
+    "\tsyscall\n"
+    "\tmovl $60, %eax\n"
+    "\tmovl $1, %edi\n"
+    "\tsyscall\n"
+    "\n"
+    "\t.section .rodata\n"
+    "__cmm_msg_read:\n"
+    "\t.ascii \"runtime error: READ: no more input\\n\"\n"
+    "__cmm_msg_div0:\n"
+    "\t.ascii \"runtime error: division by zero\\n\"\n"
+    "__cmm_msg_overflow:\n"
+    "\t.ascii \"runtime error: stack overflow\\n\"\n"
+    "__cmm_msg_end:\n"
+    "\n"
+    "\t.bss\n"
+    "\t.lcomm __cmm_outlen, 8\n"
+    "\t.lcomm __cmm_inpos, 8\n"
+    "\t.lcomm __cmm_inlen, 8\n"
+    "\t.lcomm __cmm_tmp, 16\n"
+    "\t.lcomm __cmm_outbuf, 4096\n"
+    "\t.lcomm __cmm_inbuf, 4096\n";
+
+void genX86(FILE* fp, pInterCodeList list) {
+    out = fp ? fp : stdout;
+    initValueIndex(list);
+    slotStamp = (int*)calloc(valueNum + 1, sizeof(int));
+    slotOf = (int*)malloc(sizeof(int) * (valueNum + 1));
+    memStamp = (int*)calloc(valueNum + 1, sizeof(int));
+    memOf = (int*)malloc(sizeof(int) * (valueNum + 1));
+    assert(slotStamp && slotOf && memStamp && memOf);
+
+    fputs(runtime, out);
+    fprintf(out, "\t.lcomm __cmm_data, %d\n", X86_DATA_STACK);
+    fprintf(out, "\t.lcomm __cmm_stack, %d\n", X86_MACHINE_STACK);
+    fprintf(out, "\t.set __cmm_stack_end, __cmm_stack+%d\n\n\t.text\n",
+            X86_MACHINE_STACK);
+    curStamp = 0;
+    for (int start = 0; start < list->codeNum;) {
+        int end = start + 1;
+        while (end < list->codeNum && list->codes[end].kind != IR_FUNCTION)
+            end++;
+        if (list->codes[start].kind == IR_FUNCTION) {
+            curStamp++;
+            layoutFunction(list, start, end);
+            emitPrologue(list, start);
+            int args = 0;
+            for (int i = start + 1; i < end; i++)
+                emitCode(&list->codes[i], &args);
+            // 没有RETURN就走到末尾的，返回0
+            if (list->codes[end - 1].kind != IR_RETURN) {
+                fprintf(out, "\txorl %%eax, %%eax\n");
+                emitEpilogue();
+            }
+        }
+        start = end;
+    }
+
+    free(slotStamp);
+    free(slotOf);
+    free(memStamp);
+    free(memOf);
+    deleteValueIndex();
+}